@@ -61,6 +61,37 @@ void BitcoinRPC::sendcommand( const std::string &command ,const Json::Value &par
     result = client->CallMethod( command ,params );
 }
 
+void BitcoinRPC::sendbatch( bitcoinrpc::BatchCall &calls ,bitcoinrpc::BatchResponse &responses ) {
+    client->CallProcedures( calls ,responses );
+}
+
+void BitcoinRPC::parsetransactions( const Value &result ,vector<transactioninfo_t> &ret ) {
+	for (Json::ValueConstIterator it = result.begin(); it != result.end(); it++) {
+		const Value &val = (*it);
+		transactioninfo_t tmp;
+
+		tmp.account = val["account"].asString();
+		tmp.address = val["address"].asString();
+		tmp.category = val["category"].asString();
+		tmp.amount = val["amount"].asDouble();
+		tmp.confirmations = val["confirmations"].asInt();
+		tmp.blockhash = val["blockhash"].asString();
+		tmp.blockindex = val["blockindex"].asInt();
+		tmp.blocktime = val["blocktime"].asInt();
+		tmp.txid = val["txid"].asString();
+
+		for (Json::ValueConstIterator it2 = val["walletconflicts"].begin();
+				it2 != val["walletconflicts"].end(); it2++) {
+			tmp.walletconflicts.push_back((*it2).asString());
+		}
+
+		tmp.time = val["time"].asInt();
+		tmp.timereceived = val["timereceived"].asInt();
+
+		ret.push_back(tmp);
+	}
+}
+
 string BitcoinRPC::IntegerToString( int num ) {
 	std::ostringstream ss;
 	ss << num;
@@ -570,30 +601,7 @@ vector<transactioninfo_t> BitcoinRPC::listtransactions() {
 
 	result = sendcommand(command, params);
 
-	for (ValueIterator it = result.begin(); it != result.end(); it++) {
-		Value val = (*it);
-		transactioninfo_t tmp;
-
-		tmp.account = val["account"].asString();
-		tmp.address = val["address"].asString();
-		tmp.category = val["category"].asString();
-		tmp.amount = val["amount"].asDouble();
-		tmp.confirmations = val["confirmations"].asInt();
-		tmp.blockhash = val["blockhash"].asString();
-		tmp.blockindex = val["blockindex"].asInt();
-		tmp.blocktime = val["blocktime"].asInt();
-		tmp.txid = val["txid"].asString();
-
-		for (ValueIterator it2 = val["walletconflicts"].begin();
-				it2 != val["walletconflicts"].end(); it2++) {
-			tmp.walletconflicts.push_back((*it2).asString());
-		}
-
-		tmp.time = val["time"].asInt();
-		tmp.timereceived = val["timereceived"].asInt();
-
-		ret.push_back(tmp);
-	}
+	parsetransactions(result, ret);
 
 	return ret;
 }
@@ -608,30 +616,7 @@ vector<transactioninfo_t> BitcoinRPC::listtransactions(const string& account, in
 	params.append(from);
 	result = sendcommand(command, params);
 
-	for (ValueIterator it = result.begin(); it != result.end(); it++) {
-		Value val = (*it);
-		transactioninfo_t tmp;
-
-		tmp.account = val["account"].asString();
-		tmp.address = val["address"].asString();
-		tmp.category = val["category"].asString();
-		tmp.amount = val["amount"].asDouble();
-		tmp.confirmations = val["confirmations"].asInt();
-		tmp.blockhash = val["blockhash"].asString();
-		tmp.blockindex = val["blockindex"].asInt();
-		tmp.blocktime = val["blocktime"].asInt();
-		tmp.txid = val["txid"].asString();
-
-		for (ValueIterator it2 = val["walletconflicts"].begin();
-				it2 != val["walletconflicts"].end(); it2++) {
-			tmp.walletconflicts.push_back((*it2).asString());
-		}
-
-		tmp.time = val["time"].asInt();
-		tmp.timereceived = val["timereceived"].asInt();
-
-		ret.push_back(tmp);
-	}
+	parsetransactions(result, ret);
 
 	return ret;
 }
@@ -1018,30 +1003,7 @@ txsinceblock_t BitcoinRPC::listsinceblock(const string& blockhash, int target_co
 	params.append(target_confirmations);
 	result = sendcommand(command, params);
 
-	for(ValueIterator it = result["transactions"].begin(); it != result["transactions"].end(); it++){
-		Value val = (*it);
-		transactioninfo_t tmp;
-
-		tmp.account = val["account"].asString();
-		tmp.address = val["address"].asString();
-		tmp.category = val["category"].asString();
-		tmp.amount = val["amount"].asDouble();
-		tmp.confirmations = val["confirmations"].asInt();
-		tmp.blockhash = val["blockhash"].asString();
-		tmp.blockindex = val["blockindex"].asInt();
-		tmp.blocktime = val["blocktime"].asInt();
-		tmp.txid = val["txid"].asString();
-
-		for (ValueIterator it2 = val["walletconflicts"].begin();
-				it2 != val["walletconflicts"].end(); it2++) {
-			tmp.walletconflicts.push_back((*it2).asString());
-		}
-
-		tmp.time = val["time"].asInt();
-		tmp.timereceived = val["timereceived"].asInt();
-
-		ret.transactions.push_back(tmp);
-	}
+	parsetransactions(result["transactions"], ret.transactions);
 
 	ret.lastblock = result["lastblock"].asString();
 
@@ -39,6 +39,12 @@ public:
     Json::Value sendcommand( const std::string &command ,const Json::Value &params );
     void sendcommand( const std::string &command ,const Json::Value &params ,Json::Value &result );
 
+    //! Batch, several commands in one round trip
+    void sendbatch( bitcoinrpc::BatchCall &calls ,bitcoinrpc::BatchResponse &responses );
+
+    //! Result parsing (for batch results)
+    static void parsetransactions( const Json::Value &result ,std::vector<transactioninfo_t> &txs );
+
     std::string IntegerToString(int num);    
     std::string RoundDouble(double num);
 
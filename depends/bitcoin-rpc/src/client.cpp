@@ -45,7 +45,141 @@ Json::Value Client::CallMethod(const std::string &name, const Json::Value &param
     return result;
 }
 
-///--
+void Client::CallProcedures( BatchCall &calls ,BatchResponse &result ) {
+    std::string request ,response;
+
+    //! @note requests are built as v2, protocol version removed for v1
+    if( this->version == JSONRPC_CLIENT_V1 ) {
+        for( Json::Value &call : calls.result ) call.removeMember( KEY_PROTOCOL_VERSION );
+    }
+
+    request = calls.toString();
+    connector.SendMessage( request ,response );
+
+    Json::Value value;
+
+    try {
+        if( !(std::istringstream(response) >> value) )
+            throw BitcoinRpcException( ERROR_RPC_JSON_PARSE_ERROR ," " + response );
+    } catch( Json::Exception &e ) {
+        throw BitcoinRpcException( ERROR_RPC_JSON_PARSE_ERROR ," " + response );
+    }
+
+    //! @note a single error object is returned if the whole batch failed
+    if( !value.isArray() ) {
+        if( this->ValidateResponse(value) && this->HasError(value) )
+            this->throwErrorException(value);
+
+        throw BitcoinRpcException( ERROR_CLIENT_INVALID_RESPONSE ," " + value.toStyledString() );
+    }
+
+    for( const Json::Value &it : value ) {
+        if( !this->ValidateResponse(it) )
+            throw BitcoinRpcException( ERROR_CLIENT_INVALID_RESPONSE ," " + it.toStyledString() );
+
+        if( this->HasError(it) ) {
+            result.addResponse( it[KEY_ID] ,it[KEY_ERROR] ,true );
+        } else {
+            result.addResponse( it[KEY_ID] ,it[KEY_RESULT] ,false );
+        }
+    }
+}
+
+BatchResponse Client::CallProcedures( BatchCall &calls ) {
+    BatchResponse result;
+    this->CallProcedures(calls, result);
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! BatchCall
+
+BatchCall::BatchCall() : result(Json::arrayValue) ,id(1)
+{}
+
+int BatchCall::addCall( const std::string &method ,const Json::Value &parameter ,bool isNotification ) {
+    Json::Value call;
+
+    call["jsonrpc"] = "2.0";
+    call["method"] = method;
+
+    if( parameter != Json::nullValue )
+        call["params"] = parameter;
+
+    if( !isNotification ) {
+        call["id"] = id++;
+    }
+
+    result.append( call );
+
+    return isNotification ? -1 : (id - 1);
+}
+
+std::string BatchCall::toString( bool fast ) const {
+    Json::StreamWriterBuilder wbuilder;
+
+    if( fast ) wbuilder["indentation"] = "";
+
+    return Json::writeString( wbuilder ,result );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! BatchResponse
+
+BatchResponse::BatchResponse()
+{}
+
+void BatchResponse::addResponse( const Json::Value &id ,const Json::Value &response ,bool isError ) {
+    if( isError ) errorResponses[id] = true;
+
+    responses[id] = response;
+}
+
+Json::Value BatchResponse::getResult( int id ) {
+    Json::Value result;
+    this->getResult(Json::Value(id), result);
+    return result;
+}
+
+void BatchResponse::getResult( const Json::Value &id ,Json::Value &result ) {
+    auto it = responses.find(id);
+
+    if( it == responses.end() )
+        throw BitcoinRpcException( ERROR_CLIENT_INVALID_RESPONSE ," missing response for batch id " + id.toStyledString() );
+
+    if( errorResponses.find(id) != errorResponses.end() ) {
+        const Json::Value &error = it->second;
+
+        if( error.isMember("message") && error["message"].isString() )
+            throw BitcoinRpcException( error["code"].asInt() ,error["message"].asString() );
+
+        throw BitcoinRpcException( error["code"].asInt() );
+    }
+
+    result = it->second;
+}
+
+int BatchResponse::getErrorCode( const Json::Value &id ) {
+    auto it = responses.find(id);
+
+    if( it == responses.end() || errorResponses.find(id) == errorResponses.end() )
+        return 0;
+
+    return it->second["code"].asInt();
+}
+
+std::string BatchResponse::getErrorMessage( const Json::Value &id ) {
+    auto it = responses.find(id);
+
+    if( it == responses.end() || errorResponses.find(id) == errorResponses.end() )
+        return "";
+
+    return it->second["message"].asString();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//! Client protocol
+
 const std::string Client::KEY_PROTOCOL_VERSION = "jsonrpc";
 const std::string Client::KEY_PROCEDURE_NAME = "method";
 const std::string Client::KEY_ID = "id";
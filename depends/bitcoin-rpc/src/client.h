@@ -18,6 +18,7 @@
 #include "iclientconnector.h"
 
 #include <string>
+#include <map>
 
 ///////////////////////////////////////////////////////////////////////////////
 namespace bitcoinrpc {
@@ -25,6 +26,49 @@ namespace bitcoinrpc {
 ///////////////////////////////////////////////////////////////////////////////
 typedef enum { JSONRPC_CLIENT_V1, JSONRPC_CLIENT_V2 } clientVersion_t;
 
+///////////////////////////////////////////////////////////////////////////////
+//! Batch
+
+class BatchCall {
+public:
+    BatchCall();
+
+    //! @return id of the call, used to get its result from BatchResponse
+    int addCall( const std::string &method ,const Json::Value &parameter ,bool isNotification=false );
+
+    size_t size() const { return result.size(); }
+    bool empty() const { return result.empty(); }
+
+    std::string toString( bool fast=true ) const;
+
+protected:
+    friend class Client;
+
+    Json::Value result; //! array of requests
+    int id;
+};
+
+class BatchResponse {
+public:
+    BatchResponse();
+
+    void addResponse( const Json::Value &id ,const Json::Value &response ,bool isError=false );
+
+    Json::Value getResult( int id );
+    void getResult( const Json::Value &id ,Json::Value &result );
+
+    //! @note a call in error (or missing from response) throws its error when getting its result
+    int getErrorCode( const Json::Value &id );
+    std::string getErrorMessage( const Json::Value &id );
+
+    bool hasErrors() const { return !errorResponses.empty(); }
+    size_t size() const { return responses.size(); }
+
+protected:
+    std::map<Json::Value,Json::Value> responses; //! id -> result or error
+    std::map<Json::Value,bool> errorResponses;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 class Client {
 public:
@@ -34,6 +78,10 @@ public:
     void CallMethod( const std::string &name ,const Json::Value &parameter ,Json::Value &result );
     Json::Value CallMethod( const std::string &name ,const Json::Value &parameter );
 
+    //! @note all calls in a single message, responses demultiplexed by id
+    void CallProcedures( BatchCall &calls ,BatchResponse &response );
+    BatchResponse CallProcedures( BatchCall &calls );
+
 protected:
     //! @note from protocol
     static const std::string KEY_PROTOCOL_VERSION;
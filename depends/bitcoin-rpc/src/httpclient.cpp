@@ -66,6 +66,9 @@ using namespace bitcoinrpc;
 HttpClient::HttpClient( const std::string &url ) : url(url) {
     this->timeout = 10000;
     curl = curl_easy_init();
+
+    //! @note handle is reused for every message, http connection is kept alive between calls
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
 }
 
 HttpClient::~HttpClient() {
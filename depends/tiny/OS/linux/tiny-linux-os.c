@@ -30,9 +30,12 @@
 #include <unistd.h>
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
+#include <time.h>
 
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 
 #include <semaphore.h>
 #include <signal.h>
@@ -1039,7 +1042,21 @@ OsError OsWaitForObject( OsHandle handle ,int32_t timeoutMs )
 }
 
 OsError OsSleep( int32_t delayMs ) {
-	usleep(delayMs);
+	struct timespec delay ,left;
+
+	if( delayMs < 0 ) delayMs = 0;
+
+	delay.tv_sec = delayMs / 1000;
+	delay.tv_nsec = (long) (delayMs % 1000) * 1000000L;
+
+	//! @note resume for remaining time when interrupted by a signal
+	while( nanosleep( &delay ,&left ) != 0 ) {
+		if( errno != EINTR ) return EFAILED;
+
+		delay = left;
+	}
+
+	return ENOERROR;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -1080,9 +1097,11 @@ static struct FileHandle *CastFileHandle( OsHandle handle )
 
 static OsError DeleteFileHandle( OsHandle *handle )
 {
-	struct FileHandle *p = (struct FileHandle *) handle;
+	if( handle == NULL ) return EINVAL;
 
-    if( handle == OS_INVALID_HANDLE ) return ENOERROR;
+	struct FileHandle *p = CastFileHandle( *handle );
+
+    if( *handle == OS_INVALID_HANDLE ) return ENOERROR;
     
 	if( p == NULL ) return EINVAL;
 
@@ -1231,7 +1250,8 @@ TINYFUN OsError OsFileFlush( OsHandle handle )
 
     if( p->_file == NULL ) return EINVAL;
 
-    return fflush( p->_file ) == 0 ? ENOERROR : EFAILED;
+    //! @note down to disk, not only out of stdio buffers
+    return fflush( p->_file ) == 0 && fsync( fileno( p->_file ) ) == 0 ? ENOERROR : EFAILED;
 }
 
 TINYFUN OsError OsFileGetSize( OsHandle handle ,uint64_t *size )
@@ -1306,6 +1326,67 @@ TINYFUN OsError OsFileTell( OsHandle handle ,size_t *position )
     return ENOERROR;
 }
 
+TINYFUN OsError OsFileMap( OsHandle handle ,uint64_t offset ,size_t size ,int access ,void **memory )
+{
+    struct FileHandle *p = CastFileHandle( handle );
+
+    int prot = 0;
+    void *m = NULL;
+
+    if( p == NULL || memory == NULL || size == 0 ) return EINVAL;
+
+    if( p->_file == NULL ) return EINVAL;
+
+    prot = ((access & OS_MAP_READ) ? PROT_READ : 0) | ((access & OS_MAP_WRITE) ? PROT_WRITE : 0);
+
+    fflush( p->_file ); //! @note buffered writes visible through mapping
+
+    m = mmap( NULL ,size ,prot ,MAP_SHARED ,fileno(p->_file) ,(off_t) offset );
+
+    if( m == MAP_FAILED ) return errno;
+
+    *memory = m;
+
+    return ENOERROR;
+}
+
+TINYFUN OsError OsFileUnmap( void *memory ,size_t size )
+{
+    if( memory == NULL ) return EINVAL;
+
+    return munmap( memory ,size ) == 0 ? ENOERROR : errno;
+}
+
+TINYFUN OsError OsFileSync( void *memory ,size_t size )
+{
+    if( memory == NULL ) return EINVAL;
+
+    return msync( memory ,size ,MS_SYNC ) == 0 ? ENOERROR : errno;
+}
+
+TINYFUN OsError OsFileGetSizeByName( const char_t *filename ,uint64_t *size )
+{
+    struct stat st;
+
+    if( filename == NULL || size == NULL ) return EINVAL;
+
+    if( stat( filename ,&st ) != 0 ) return errno;
+
+    *size = (uint64_t) st.st_size;
+
+    return ENOERROR;
+}
+
+TINYFUN OsError OsFileMove( const char_t *oldFileName ,const char_t *newFileName )
+{
+    return rename( oldFileName ,newFileName ) == 0 ? ENOERROR : errno;
+}
+
+TINYFUN OsError OsFileDelete( const char_t *fileName )
+{
+    return unlink( fileName ) == 0 ? ENOERROR : errno;
+}
+
 //////////////////////////////////////////////////////////////////////////
 //! Network
 
@@ -1346,9 +1427,11 @@ static struct NetHandle *CastNetSocketHandle( OsHandle handle )
 
 static OsError DeleteNetHandle( OsHandle *handle )
 {
-	struct NetHandle *p = (struct NetHandle *) handle;
+	if( handle == NULL ) return EINVAL;
 
-    if( handle == OS_INVALID_HANDLE ) return ENOERROR;
+	struct NetHandle *p = (struct NetHandle *) *handle;
+
+    if( *handle == OS_INVALID_HANDLE ) return ENOERROR;
     
 	if( p == NULL ) return EINVAL;
 
@@ -1962,7 +2045,7 @@ enum OsHandleType guiHandleGetType( OsHandle handle )
 
 static OsError guiHandleDestroy( OsHandle *handle )
 {
-	struct GuiSystemHandle *p = CastGuiSystemHandle( handle );
+	struct GuiSystemHandle *p = CastGuiSystemHandle( *handle );
 
 	if( p == NULL ) { _ASSERT( 0 ); return EINVAL; }
 
@@ -1997,9 +2080,11 @@ TINYFUN enum OsHandleType OsHandleGetType( OsHandle handle )
 
 TINYFUN OsError OsHandleDestroy( OsHandle *handle )
 {
-	struct AnyHandle *p = (struct AnyHandle *) handle;
+	if( handle == NULL ) return EINVAL;
 
-	if( p == NULL ) return EINVAL;
+	struct AnyHandle *p = (struct AnyHandle *) *handle; //! @note handle points to the handle to destroy
+
+	if( p == NULL ) return ENOERROR; //! @note already destroyed
 
 	switch( p->_magic )
 	{
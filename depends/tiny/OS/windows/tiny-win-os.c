@@ -1527,6 +1527,17 @@ OsError OsFileWrite( OsHandle handle ,const uint8_t *memory ,size_t size ,size_t
 	return ENOERROR;
 }
 
+OsError OsFileFlush( OsHandle handle )
+{
+	struct FileHandle *p = CastFileHandle( handle );
+
+	if( p == NULL ) return EINVAL;
+
+	if( p->_handle == INVALID_HANDLE_VALUE ) return EINVAL;
+
+	return FlushFileBuffers( p->_handle ) ? ENOERROR : GetLastOsError();
+}
+
 OsError OsFileGetSize( OsHandle handle ,uint64_t *size )
 {
 	struct FileHandle *p = CastFileHandle( handle );
@@ -1547,6 +1558,51 @@ OsError OsFileSeek( OsHandle handle ,size_t distance ,int seekpos )
 	return ENOSYS;
 }
 
+OsError OsFileMap( OsHandle handle ,uint64_t offset ,size_t size ,int access ,void **memory )
+{
+	struct FileHandle *p = CastFileHandle( handle );
+
+	DWORD protect = (access & OS_MAP_WRITE) ? PAGE_READWRITE : PAGE_READONLY;
+	DWORD desired = (access & OS_MAP_WRITE) ? FILE_MAP_WRITE : FILE_MAP_READ;
+
+	uint64_t end = offset + size;
+
+	HANDLE hmap;
+	void *m;
+
+	if( p == NULL || memory == NULL || size == 0 ) return EINVAL;
+
+	if( p->_handle == INVALID_HANDLE_VALUE ) return EINVAL;
+
+	hmap = CreateFileMapping( p->_handle ,NULL ,protect ,(DWORD) (end >> 32) ,(DWORD) end ,NULL );
+
+	if( hmap == NULL ) return GetLastOsError();
+
+	m = MapViewOfFile( hmap ,desired ,(DWORD) (offset >> 32) ,(DWORD) offset ,size );
+
+	CloseHandle( hmap ); //! @note view keeps the mapping open
+
+	if( m == NULL ) return GetLastOsError();
+
+	*memory = m;
+
+	return ENOERROR;
+}
+
+OsError OsFileUnmap( void *memory ,size_t size )
+{
+	if( memory == NULL ) return EINVAL;
+
+	return UnmapViewOfFile( memory ) ? ENOERROR : GetLastOsError();
+}
+
+OsError OsFileSync( void *memory ,size_t size )
+{
+	if( memory == NULL ) return EINVAL;
+
+	return FlushViewOfFile( memory ,size ) ? ENOERROR : GetLastOsError();
+}
+
 //////////////////////////////////////////////////////////////////////////
 //! Network
 
@@ -194,6 +194,16 @@ String &toString( const guid_t &p ,String &s ) {
     s = ch; return s;
 }
 
+template <>
+bool fromBinary( guid_t &p ,BinaryReader &r ) {
+    return r.Read( p ,sizeof(guid_t) );
+}
+
+template <>
+void toBinary( const guid_t &p ,BinaryWriter &w ) {
+    w.Write( p ,sizeof(guid_t) );
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //! Generate
 
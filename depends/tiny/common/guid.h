@@ -75,6 +75,12 @@ guid_t &fromString( guid_t &p ,const String &s ,size_t &size );
 template <>
 String &toString( const guid_t &p ,String &s );
 
+template <>
+bool fromBinary( guid_t &p ,BinaryReader &r );
+
+template <>
+void toBinary( const guid_t &p ,BinaryWriter &w );
+
 //////////////////////////////////////////////////////////////////////////////
 } //TINY_NAMESPACE
 
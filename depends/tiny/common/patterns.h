@@ -514,10 +514,178 @@ protected:
 //////////////////////////////////////////////////////////////////////////////
 //! Cache
 
+    //! @brief bounded map, least recently used items evicted with a CLOCK sweep
+    //! @note items are stable in memory until evicted or removed
+    //! @note pinned and dirty items are never evicted, cache may then go past its capacity
+    //! @note with a capacity of 0 only the last inserted item (and pinned/dirty ones) are kept
+
+#define CACHE_UNBOUNDED ((size_t) -1)
+
 template<typename TKey ,typename TValue>
-class Cache_ : public Map_<TKey,TValue> {
+class Cache_ {
+public:
+    struct Slot {
+        TValue value;
+
+        int pinned = 0;
+        bool dirty = false;
+        bool referenced = false; //! @note used since last sweep
+    };
+
+    typedef MapOf<TKey,Slot> map_t;
+
+public:
+    explicit Cache_( size_t capacity=CACHE_UNBOUNDED ) : m_capacity(capacity) ,m_hand(m_map.end())
+    {}
+
+    size_t getCount() const { return m_map.size(); }
+
+    size_t getCapacity() const { return m_capacity; }
+
+    void setCapacity( size_t capacity ) {
+        m_capacity = capacity;
+
+        while( m_map.size() > m_capacity && Evict() ) {}
+    }
+
+//-- stats
+    uint64_t getHits() const { return m_hits; }
+    uint64_t getMisses() const { return m_misses; }
+    uint64_t getEvictions() const { return m_evictions; }
+
+    double getHitRate() const {
+        uint64_t n = m_hits + m_misses; return n ? (double) m_hits / n : 0.;
+    }
+
+    void ResetStats() {
+        m_hits = m_misses = m_evictions = 0;
+    }
+
 public:
-    //TODO handle cache hit and limit quantity of index in the map
+    //! @brief lookup counted as a hit or a miss
+    TValue *findItem( const TKey &key ) {
+        auto it = m_map.find( key );
+
+        if( it == m_map.end() ) {
+            ++m_misses; return NullPtr;
+        }
+
+        ++m_hits; it->second.referenced = true;
+
+        return &(it->second.value);
+    }
+
+    //! @brief lookup, not counted nor referenced
+    TValue *peekItem( const TKey &key ) {
+        auto it = m_map.find( key );
+
+        return it != m_map.end() ? &(it->second.value) : NullPtr;
+    }
+
+    //! @brief add or replace item, making room first if at capacity
+    TValue &setItem( const TKey &key ,const TValue &value ,bool dirty=false ) {
+        auto it = m_map.find( key );
+
+        if( it == m_map.end() ) {
+            while( m_map.size() >= m_capacity && Evict() ) {}
+
+            it = m_map.emplace( key ,Slot() ).first;
+        }
+
+        Slot &slot = it->second;
+
+        slot.value = value;
+        slot.dirty = slot.dirty || dirty;
+        slot.referenced = true;
+
+        return slot.value;
+    }
+
+    void delItem( const TKey &key ) {
+        auto it = m_map.find( key );
+
+        if( it == m_map.end() ) return;
+
+        if( it == m_hand ) ++m_hand;
+
+        m_map.erase( it );
+    }
+
+    void Clear() {
+        m_map.clear(); m_hand = m_map.end();
+    }
+
+//-- pinning
+    bool Pin( const TKey &key ) {
+        auto it = m_map.find( key );
+
+        if( it == m_map.end() ) return false;
+
+        ++(it->second.pinned); return true;
+    }
+
+    void Unpin( const TKey &key ) {
+        auto it = m_map.find( key );
+
+        if( it != m_map.end() && it->second.pinned > 0 ) --(it->second.pinned);
+    }
+
+//-- dirty
+    void setDirty( const TKey &key ,bool dirty=true ) {
+        auto it = m_map.find( key );
+
+        if( it != m_map.end() ) it->second.dirty = dirty;
+    }
+
+    bool isDirty( const TKey &key ) const {
+        auto it = m_map.find( key );
+
+        return it != m_map.end() && it->second.dirty;
+    }
+
+    //! @brief dirty items, in key order
+    //! @note filter does not clean items, use setDirty
+    template <typename F>
+    void eachDirty( F &&filter ) {
+        for( auto &it : m_map ) if( it.second.dirty ) {
+            if( !filter( it.first ,it.second.value ) ) return;
+        }
+    }
+
+protected:
+    //! @return false if no item could be evicted
+    bool Evict() {
+        //! @note two sweeps at most, first one clearing references
+        for( size_t i=0, n=2*m_map.size(); i<n; ++i ) {
+            if( m_hand == m_map.end() ) m_hand = m_map.begin();
+
+            Slot &slot = m_hand->second;
+
+            if( slot.pinned > 0 || slot.dirty ) {
+                ++m_hand; continue;
+            }
+
+            if( slot.referenced ) {
+                slot.referenced = false; ++m_hand; continue;
+            }
+
+            m_hand = m_map.erase( m_hand ); ++m_evictions;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    map_t m_map;
+
+    size_t m_capacity;
+
+    typename map_t::iterator m_hand; //! @note clock hand
+
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
 };
 
 //////////////////////////////////////////////////////////////////////////////
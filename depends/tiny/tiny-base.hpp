@@ -564,6 +564,227 @@ Params &toParamsWithSchema( const T &p ,Params &manifest ,bool listEmpty=false )
     INLINE_FROMMANIFEST(__class,Params) { return fromParamsWithSchema( p ,manifest ); } \
     INLINE_TOMANIFEST(__class,Params) { return toParamsWithSchema( p ,manifest ); }
 
+//////////////////////////////////////////////////////////////////////////////
+//! Binary
+
+    //! @brief compact binary form, no text formatting or parsing involved
+    //! @note integers are varint (zigzag when signed), double is 8 raw bytes, String is size prefixed
+    //! @note struct with schema is a sequence of [member+1][size][value] ending with 0,
+    //!     unknown members are skipped and missing members left untouched, schemas may only be appended to
+
+struct BinaryWriter {
+    ListOf<byte> &bytes;
+
+    explicit BinaryWriter( ListOf<byte> &a_bytes ) : bytes(a_bytes)
+    {}
+
+    void Write( const void *data ,size_t size ) {
+        const byte *p = (const byte*) data; bytes.insert( bytes.end() ,p ,p+size );
+    }
+
+    void WriteVarint( uint64_t v ) {
+        while( v >= 0x80 ) {
+            bytes.push_back( (byte) (v | 0x80) ); v >>= 7;
+        }
+
+        bytes.push_back( (byte) v );
+    }
+
+    //! @return value offset, to pass to endField once value is written
+    size_t beginField( int m ) {
+        WriteVarint( (uint64_t) m + 1 ); bytes.push_back( 0 ); return bytes.size();
+    }
+
+    void endField( size_t at ) {
+        uint64_t size = bytes.size() - at;
+
+        if( size < 0x80 ) { //! @note most fields, size fits the byte reserved
+            bytes[at-1] = (byte) size; return;
+        }
+
+        byte head[10]; int n = 0;
+
+        while( size >= 0x80 ) {
+            head[n++] = (byte) (size | 0x80); size >>= 7;
+        }
+
+        head[n++] = (byte) size;
+
+        bytes[at-1] = head[0];
+        bytes.insert( bytes.begin() + at ,head+1 ,head+n );
+    }
+};
+
+struct BinaryReader {
+    const byte *p ,*end;
+
+    bool ok; //! false once a read went past end or data is malformed
+
+    BinaryReader( const byte *data=NullPtr ,size_t size=0 ) : p(data) ,end(data ? data+size : data) ,ok(data != NullPtr)
+    {}
+
+    bool Read( void *data ,size_t size ) {
+        if( !ok || (size_t) (end - p) < size ) return ok = false;
+
+        memcpy( data ,p ,size ); p += size;
+
+        return true;
+    }
+
+    bool ReadVarint( uint64_t &v ) {
+        v = 0;
+
+        for( int shift=0; ok && shift < 64; shift += 7 ) {
+            if( p >= end ) break;
+
+            byte b = *p++;
+
+            v |= (uint64_t) (b & 0x7f) << shift;
+
+            if( (b & 0x80) == 0 ) return true;
+        }
+
+        return ok = false;
+    }
+
+    //! @brief read next field of a struct, false at end of struct
+    bool nextField( int &m ,BinaryReader &field ) {
+        uint64_t tag ,size;
+
+        if( !ok || p >= end ) return false; //! @note end of data also ends struct
+
+        if( !ReadVarint( tag ) || tag == 0 ) return false;
+
+        if( !ReadVarint( size ) || (uint64_t) (end - p) < size ) return ok = false;
+
+        m = (int) (tag - 1);
+        field = BinaryReader( p ,(size_t) size );
+
+        p += size;
+
+        return true;
+    }
+};
+
+///-- from / to
+template <typename T>
+bool fromBinary( T &p ,BinaryReader &r ); //! @note no default by design
+
+template <typename T>
+void toBinary( const T &p ,BinaryWriter &w ); //! @note no default by design
+
+#define INLINE_FROMBINARY(__class) \
+    template <> inline bool fromBinary( __class &p ,BinaryReader &r )
+
+#define DEFINE_FROMBINARY(__class) \
+    template <> bool fromBinary( __class &p ,BinaryReader &r )
+
+#define INLINE_TOBINARY(__class) \
+    template <> inline void toBinary( const __class &p ,BinaryWriter &w )
+
+#define DEFINE_TOBINARY(__class) \
+    template <> void toBinary( const __class &p ,BinaryWriter &w )
+
+#define DEFINE_BINARY_API(__class) \
+    DEFINE_FROMBINARY(__class); \
+    DEFINE_TOBINARY(__class);
+
+DEFINE_BINARY_API(bool);
+DEFINE_BINARY_API(int32_t);
+DEFINE_BINARY_API(uint32_t);
+DEFINE_BINARY_API(int64_t);
+DEFINE_BINARY_API(uint64_t);
+DEFINE_BINARY_API(double);
+DEFINE_BINARY_API(String);
+
+template <typename T>
+bool fromBinary( ListOf<T> &p ,BinaryReader &r ) {
+    uint64_t n; if( !r.ReadVarint( n ) || n > (uint64_t) (r.end - r.p) ) return r.ok = false;
+
+    p.resize( (size_t) n );
+
+    for( auto &it : p ) if( !fromBinary( it ,r ) ) return false;
+
+    return true;
+}
+
+template <typename T>
+void toBinary( const ListOf<T> &p ,BinaryWriter &w ) {
+    w.WriteVarint( p.size() );
+
+    for( const auto &it : p ) toBinary( it ,w );
+}
+
+template <typename T>
+bool enumFromBinary( T &p ,BinaryReader &r ) {
+    int32_t v; if( !fromBinary( v ,r ) ) return false;
+
+    p = (T) v; return true;
+}
+
+template <typename T>
+void enumToBinary( const T &p ,BinaryWriter &w ) {
+    toBinary( (int32_t) p ,w );
+}
+
+///-- members
+template <class T>
+void setMember( T &p ,int m ,BinaryReader &r );
+
+template <class T>
+void getMember( const T &p ,int m ,BinaryWriter &w );
+
+#define DEFINE_SETMEMBER_BINARY(__class) \
+    template <> void setMember( __class &p ,int m ,BinaryReader &r )
+
+#define DEFINE_GETMEMBER_BINARY(__class) \
+    template <> void getMember( const __class &p ,int m ,BinaryWriter &w )
+
+#define DEFINE_MEMBER_BINARY_API(__class) \
+    DEFINE_SETMEMBER_BINARY(__class); \
+    DEFINE_GETMEMBER_BINARY(__class);
+
+#define DECLARE_SCHEMA_BINARY \
+    void setMember( int m ,BinaryReader &r ); \
+    void getMember( int m ,BinaryWriter &w ) const;
+
+#define CLASS_SCHEMA_BINARY(__class) \
+    template <> inline void setMember( __class &p ,int m ,BinaryReader &r ) { p.setMember(m,r); } \
+    template <> inline void getMember( const __class &p ,int m ,BinaryWriter &w ) { p.getMember(m,w); }
+
+///-- with schema
+template <typename T>
+bool fromBinaryWithSchema( T &p ,BinaryReader &r ) {
+    int n = (int) Schema_<T>::schema.size() ,m;
+
+    BinaryReader field;
+
+    while( r.nextField( m ,field ) ) {
+        if( m < n ) setMember( p ,m ,field );
+    }
+
+    return r.ok;
+}
+
+template <typename T>
+void toBinaryWithSchema( const T &p ,BinaryWriter &w ) {
+    int n = (int) Schema_<T>::schema.size();
+
+    for( int m=0; m<n; ++m ) {
+        size_t at = w.beginField( m );
+
+        getMember( p ,m ,w );
+
+        w.endField( at );
+    }
+
+    w.WriteVarint( 0 );
+}
+
+#define DEFINE_WITHBINARY_API(__class) \
+    INLINE_FROMBINARY(__class) { return fromBinaryWithSchema( p ,r ); } \
+    INLINE_TOBINARY(__class) { toBinaryWithSchema( p ,w ); }
+
 //////////////////////////////////////////////////////////////////////////////
 //! Convert
 
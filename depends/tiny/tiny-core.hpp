@@ -472,6 +472,10 @@ public:
 	OsError Seek( size_t distance ,int seekpos ) { return OsFileSeek( m_hfile ,distance ,seekpos ); }
     OsError Tell( size_t &distance ) { return OsFileTell( m_hfile ,&distance ); }
 
+    OsError Map( uint64_t offset ,size_t size ,int access ,void **memory ) { return OsFileMap( m_hfile ,offset ,size ,access ,memory ); }
+    static OsError Unmap( void *memory ,size_t size ) { return OsFileUnmap( memory ,size ); }
+    static OsError Sync( void *memory ,size_t size ) { return OsFileSync( memory ,size ); }
+
 	void Close( void ) { OsHandleDestroy( &m_hfile ); }
 
 protected:
@@ -660,6 +660,14 @@ TINYFUN OsError OsFileSetSize( OsHandle handle ,uint64_t size );
 TINYFUN OsError OsFileSeek( OsHandle handle ,size_t distance ,int seekpos );
 TINYFUN OsError OsFileTell( OsHandle handle ,size_t *position );
 
+//-- mapping
+#define OS_MAP_READ			1
+#define OS_MAP_WRITE		2
+
+TINYFUN OsError OsFileMap( OsHandle handle ,uint64_t offset ,size_t size ,int access ,void **memory ); //! @note size within file size
+TINYFUN OsError OsFileUnmap( void *memory ,size_t size );
+TINYFUN OsError OsFileSync( void *memory ,size_t size ); //! @note write mapped memory to file, blocking
+
 //////////////////////////////////////////////////////////////////////////
 //! network
 
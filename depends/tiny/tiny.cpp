@@ -560,6 +560,97 @@ StringList &paramsToList( StringList &values ,const Schema &schema ,Params &mani
     return values;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//! Binary
+
+static uint64_t zigzag( int64_t v ) { return ((uint64_t) v << 1) ^ (uint64_t) (v >> 63); }
+static int64_t unzigzag( uint64_t v ) { return (int64_t) (v >> 1) ^ -(int64_t) (v & 1); }
+
+//--
+template <>
+bool fromBinary( bool &p ,BinaryReader &r ) {
+    byte b = 0; if( !r.Read( &b ,1 ) ) return false;
+
+    p = b != 0; return true;
+}
+
+template <>
+void toBinary( const bool &p ,BinaryWriter &w ) {
+    byte b = p ? 1 : 0; w.Write( &b ,1 );
+}
+
+template <>
+bool fromBinary( int32_t &p ,BinaryReader &r ) {
+    int64_t v; if( !fromBinary( v ,r ) ) return false;
+
+    p = (int32_t) v; return true;
+}
+
+template <>
+void toBinary( const int32_t &p ,BinaryWriter &w ) {
+    w.WriteVarint( zigzag( p ) );
+}
+
+template <>
+bool fromBinary( uint32_t &p ,BinaryReader &r ) {
+    uint64_t v; if( !r.ReadVarint( v ) ) return false;
+
+    p = (uint32_t) v; return true;
+}
+
+template <>
+void toBinary( const uint32_t &p ,BinaryWriter &w ) {
+    w.WriteVarint( p );
+}
+
+template <>
+bool fromBinary( int64_t &p ,BinaryReader &r ) {
+    uint64_t v; if( !r.ReadVarint( v ) ) return false;
+
+    p = unzigzag( v ); return true;
+}
+
+template <>
+void toBinary( const int64_t &p ,BinaryWriter &w ) {
+    w.WriteVarint( zigzag( p ) );
+}
+
+template <>
+bool fromBinary( uint64_t &p ,BinaryReader &r ) {
+    return r.ReadVarint( p );
+}
+
+template <>
+void toBinary( const uint64_t &p ,BinaryWriter &w ) {
+    w.WriteVarint( p );
+}
+
+template <>
+bool fromBinary( double &p ,BinaryReader &r ) {
+    return r.Read( &p ,sizeof(double) ); //! @note little endian hosts only, as book files
+}
+
+template <>
+void toBinary( const double &p ,BinaryWriter &w ) {
+    w.Write( &p ,sizeof(double) );
+}
+
+template <>
+bool fromBinary( String &p ,BinaryReader &r ) {
+    uint64_t size; if( !r.ReadVarint( size ) ) return false;
+
+    if( (uint64_t) (r.end - r.p) < size ) return r.ok = false;
+
+    p.assign( (const char*) r.p ,(size_t) size ); r.p += size;
+
+    return true;
+}
+
+template <>
+void toBinary( const String &p ,BinaryWriter &w ) {
+    w.WriteVarint( p.size() ); w.Write( p.c_str() ,p.size() );
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //! Arguments
 
@@ -26,7 +26,11 @@
 
 //////////////////////////////////////////////////////////////////////////////
 #include "App.h"
+#include "backend/common/Hashrate.h"
+#include "backend/common/interfaces/IBackend.h"
 #include "backend/cpu/Cpu.h"
+#include "backend/cpu/CpuBackend.h"
+#include "backend/cpu/CpuConfig.h"
 #include "base/io/Console.h"
 #include "base/io/log/Log.h"
 #include "base/io/log/Tags.h"
@@ -34,18 +38,36 @@
 #include "base/kernel/Platform.h"
 #include "core/config/Config.h"
 #include "core/Controller.h"
+#include "core/Miner.h"
+#include "crypto/ghostrider/ghostrider.h"
+#include "base/net/stratum/Job.h"
+#include "base/net/stratum/Pools.h"
+#include "3rdparty/rapidjson/document.h"
 #include "Summary.h"
 
 #include <uv.h>
 
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////////////////
+#define TELEMETRY_INTERVAL      2000 //! ms
+
 //////////////////////////////////////////////////////////////////////////////
-xmrig::App::App(Process *process) : m_loop(nullptr)
+xmrig::App::App(Process *process) : m_loop(nullptr) ,m_async(nullptr) ,m_timer(nullptr)
 {
+    m_mutex = new uv_mutex_t;
+
+    uv_mutex_init( (uv_mutex_t*) m_mutex );
+
     m_controller = std::make_shared<Controller>(process);
 }
 
 xmrig::App::~App()
 {
+    uv_mutex_destroy( (uv_mutex_t*) m_mutex );
+
+    delete (uv_mutex_t*) m_mutex;
+
     Cpu::release();
 }
 
@@ -103,7 +125,47 @@ int xmrig::App::Exec( IStrategyListener *strategyListener )
 
     m_loop = (void*) loop;
 
+    //! @note not keeping loop alive, only waking it for setPools
+    auto *async = new uv_async_t;
+
+    uv_async_init( loop ,async ,[]( uv_async_t *handle ) { onAsync( handle ); } );
+    uv_unref( (uv_handle_t*) async );
+
+    async->data = this;
+
+    uv_mutex_lock( (uv_mutex_t*) m_mutex );
+    {
+        m_async = (void*) async;
+
+        if( !m_pools.empty() ) uv_async_send( async );
+    }
+    uv_mutex_unlock( (uv_mutex_t*) m_mutex );
+
+    //! @note telemetry, not keeping loop alive either
+    auto *timer = new uv_timer_t;
+
+    uv_timer_init( loop ,timer );
+    uv_unref( (uv_handle_t*) timer );
+
+    timer->data = this; m_timer = (void*) timer;
+
+    uv_timer_start( timer ,[]( uv_timer_t *handle ) { onTelemetryTimer( handle ); } ,TELEMETRY_INTERVAL ,TELEMETRY_INTERVAL );
+
     rc = uv_run( loop ,UV_RUN_DEFAULT );
+
+    uv_mutex_lock( (uv_mutex_t*) m_mutex );
+    {
+        m_async = nullptr;
+        m_telemetry = AppTelemetry();
+    }
+    uv_mutex_unlock( (uv_mutex_t*) m_mutex );
+
+    uv_timer_stop( timer ); m_timer = nullptr;
+
+    uv_close( (uv_handle_t*) timer ,[]( uv_handle_t *handle ) { delete (uv_timer_t*) handle; } );
+    uv_close( (uv_handle_t*) async ,[]( uv_handle_t *handle ) { delete (uv_async_t*) handle; } );
+    uv_run( loop ,UV_RUN_NOWAIT );
+
     uv_loop_close(loop);
 
     close();
@@ -133,6 +195,158 @@ void xmrig::App::doCommand( char cmd ) {
     }
 };
 
+void xmrig::App::setPools( const char *pools ) {
+    uv_mutex_lock( (uv_mutex_t*) m_mutex );
+    {
+        m_pools = pools ? pools : "";
+
+        if( m_async && !m_pools.empty() ) uv_async_send( (uv_async_t*) m_async );
+    }
+    uv_mutex_unlock( (uv_mutex_t*) m_mutex );
+}
+
+void xmrig::App::onAsync( void *handle ) {
+    auto *app = (App*) ((uv_async_t*) handle)->data;
+
+    if( app ) app->applyPools();
+}
+
+void xmrig::App::applyPools() {
+    std::string pools;
+
+    uv_mutex_lock( (uv_mutex_t*) m_mutex );
+    {
+        pools.swap( m_pools );
+    }
+    uv_mutex_unlock( (uv_mutex_t*) m_mutex );
+
+    if( pools.empty() ) return;
+
+    rapidjson::Document doc;
+
+    m_controller->config()->getJSON( doc );
+
+    rapidjson::Document poolsDoc;
+
+    poolsDoc.Parse( pools.c_str() );
+
+    if( poolsDoc.HasParseError() || !poolsDoc.IsArray() ) {
+        LOG_ERR( "%s " RED("invalid pools") ,Tags::config() );
+        return;
+    }
+
+    rapidjson::Value value;
+
+    value.CopyFrom( poolsDoc ,doc.GetAllocator() );
+
+    auto it = doc.FindMember( Pools::kPools );
+
+    if( it != doc.MemberEnd() )
+        it->value = value;
+    else
+        doc.AddMember( rapidjson::StringRef(Pools::kPools) ,value ,doc.GetAllocator() );
+
+    //! @note network swaps strategy on pools change, backends keep their threads
+    m_controller->reload( doc );
+}
+
+///--
+bool xmrig::App::getTelemetry( AppTelemetry &telemetry ) {
+    bool valid;
+
+    uv_mutex_lock( (uv_mutex_t*) m_mutex );
+    {
+        valid = m_telemetry.timestamp != 0;
+
+        if( valid ) telemetry = m_telemetry;
+    }
+    uv_mutex_unlock( (uv_mutex_t*) m_mutex );
+
+    return valid;
+}
+
+void xmrig::App::onTelemetryTimer( void *handle ) {
+    auto *app = (App*) ((uv_timer_t*) handle)->data;
+
+    if( app ) app->updateTelemetry();
+}
+
+void xmrig::App::updateTelemetry() {
+    static const size_t intervals[AppTelemetry::intervalCount] = {
+        Hashrate::ShortInterval ,Hashrate::MediumInterval ,Hashrate::LargeInterval
+    };
+
+    auto normal = []( double h ) { return std::isnormal(h) ? h : 0.; };
+
+    Miner *miner = m_controller->miner();
+
+    if( !miner ) return;
+
+    AppTelemetry telemetry;
+
+    for( IBackend *backend : miner->backends() ) {
+        const Hashrate *hashrate = backend->isEnabled() ? backend->hashrate() : nullptr;
+
+        if( !hashrate ) continue;
+
+        telemetry.backend = backend->type().data();
+
+        for( int i=0; i<AppTelemetry::intervalCount; ++i ) {
+            telemetry.hashrate[i] = normal( hashrate->calc( intervals[i] ) );
+        }
+
+        //! @note affinities are in thread order, as hashrate
+        std::vector<int64_t> affinities;
+
+        if( backend->type() == CpuConfig::kField ) { //! @note built without rtti
+            auto *cpu = static_cast<CpuBackend*>( backend );
+
+            HugePagesInfo pages = cpu->hugePages();
+
+            telemetry.hugePagesAllocated = pages.allocated;
+            telemetry.hugePagesTotal = pages.total;
+
+            affinities = cpu->affinities();
+        }
+
+        for( size_t t=0; t<hashrate->threads(); ++t ) {
+            AppTelemetry::Thread thread;
+
+            thread.affinity = t < affinities.size() ? affinities[t] : -1;
+
+            for( int i=0; i<AppTelemetry::intervalCount; ++i ) {
+                thread.hashrate[i] = normal( hashrate->calc( t ,intervals[i] ) );
+            }
+
+            telemetry.threads.emplace_back( thread );
+        }
+
+        break; //! @note first active backend only (cpu)
+    }
+
+    const Algorithm algorithm = miner->job().algorithm();
+
+    telemetry.algo = algorithm.isValid() ? algorithm.name() : "";
+
+    if( algorithm.family() == Algorithm::GHOSTRIDER ) {
+        ghostrider::VariantTune tunes[ghostrider::kVariantCount];
+
+        size_t n = ghostrider::variant_tunes( tunes ,ghostrider::kVariantCount );
+
+        for( size_t i=0; i<n; ++i ) {
+            telemetry.variants.push_back( { tunes[i].name ,tunes[i].hashrate ,tunes[i].step ,tunes[i].threads } );
+        }
+    }
+
+    telemetry.timestamp = uv_now( (uv_loop_t*) m_loop );
+
+    uv_mutex_lock( (uv_mutex_t*) m_mutex );
+    {
+        m_telemetry = std::move( telemetry );
+    }
+    uv_mutex_unlock( (uv_mutex_t*) m_mutex );
+}
+
 //////////////////////////////////////////////////////////////////////////////
 void xmrig::App::onConsoleCommand( char command ) {
     doCommand(command);
@@ -35,6 +35,8 @@
 #include "base/tools/Object.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 //////////////////////////////////////////////////////////////////////////////
 namespace xmrig {
@@ -46,6 +48,39 @@ class Network;
 class Process;
 class Signals;
 
+//////////////////////////////////////////////////////////////////////////////
+//! @brief backend state snapshot, for the embedding application
+struct AppTelemetry {
+    enum Interval {
+        intervalShort=0 ,intervalMedium ,intervalLarge ,intervalCount //! 10s, 60s, 15m
+    };
+
+    struct Thread {
+        int64_t affinity; //! logical cpu, -1 if none
+        double hashrate[intervalCount]; //! h/s, 0 if no data
+    };
+
+    struct Variant { //! cn variant of GhostRider, from benchmark
+        std::string name;
+        double hashrate; //! h/s, 0 if not benchmarked
+        uint32_t step;
+        uint32_t threads;
+    };
+
+    uint64_t timestamp = 0; //! ms, 0 if none taken yet
+
+    std::string backend;
+    std::string algo;
+
+    double hashrate[intervalCount] = {};
+
+    uint64_t hugePagesAllocated = 0;
+    uint64_t hugePagesTotal = 0;
+
+    std::vector<Thread> threads;
+    std::vector<Variant> variants;
+};
+
 //////////////////////////////////////////////////////////////////////////////
 class App : public IConsoleListener, public ISignalListener
 {
@@ -63,6 +98,14 @@ public:
 
     void doCommand( char command );
 
+    //! @brief replace pools (job sources) from any thread, workers are kept running
+    //! @note pools is a json array of pool objects, as in config file
+    void setPools( const char *pools );
+
+    //! @brief last backend snapshot, from any thread
+    //! @note taken on loop thread every TELEMETRY_INTERVAL ms, false if none yet
+    bool getTelemetry( AppTelemetry &telemetry );
+
 protected:
     void onConsoleCommand( char command ) override;
     void onSignal( int signum ) override;
@@ -71,12 +114,25 @@ private:
     bool background( int &rc );
     void close();
 
+    static void onAsync( void *handle );
+    void applyPools(); //! @note on loop thread
+
+    static void onTelemetryTimer( void *handle );
+    void updateTelemetry(); //! @note on loop thread
+
     std::shared_ptr<Console> m_console;
     std::shared_ptr<Controller> m_controller;
     std::shared_ptr<Signals> m_signals;
 
     volatile bool m_running;
     void *m_loop;
+    void *m_async; //! uv_async_t, wakes loop for setPools
+
+    void *m_mutex; //! uv_mutex_t, guards m_async, m_pools and m_telemetry
+    std::string m_pools; //! pending pools, empty if none
+
+    void *m_timer; //! uv_timer_t, telemetry snapshots
+    AppTelemetry m_telemetry;
 };
 
 //////////////////////////////////////////////////////////////////////////////
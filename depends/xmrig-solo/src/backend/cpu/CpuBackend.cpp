@@ -409,6 +409,38 @@ void xmrig::CpuBackend::stop()
 }
 
 
+xmrig::HugePagesInfo xmrig::CpuBackend::hugePages() const
+{
+    HugePagesInfo pages;
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (d_ptr->algo.family() == Algorithm::RANDOM_X) {
+        pages += Rx::hugePages();
+    }
+#   endif
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    pages += d_ptr->status.hugePages();
+
+    return pages;
+}
+
+
+std::vector<int64_t> xmrig::CpuBackend::affinities() const
+{
+    std::vector<int64_t> out;
+
+    out.reserve(d_ptr->threads.size());
+
+    for (const CpuLaunchData &data : d_ptr->threads) {
+        out.push_back(data.affinity);
+    }
+
+    return out;
+}
+
+
 #ifdef XMRIG_FEATURE_API
 rapidjson::Value xmrig::CpuBackend::toJSON(rapidjson::Document &doc) const
 {
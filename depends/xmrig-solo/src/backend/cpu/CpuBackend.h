@@ -22,9 +22,11 @@
 
 #include "backend/common/interfaces/IBackend.h"
 #include "base/tools/Object.h"
+#include "crypto/common/HugePagesInfo.h"
 
 
 #include <utility>
+#include <vector>
 
 
 namespace xmrig {
@@ -43,6 +45,10 @@ public:
     CpuBackend(Controller *controller);
     ~CpuBackend() override;
 
+    // solominer telemetry, on loop thread
+    HugePagesInfo hugePages() const;
+    std::vector<int64_t> affinities() const;
+
 protected:
     inline void execCommand(char) override {}
 
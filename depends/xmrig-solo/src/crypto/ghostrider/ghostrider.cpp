@@ -457,6 +457,20 @@ void benchmark()
 }
 
 
+size_t variant_tunes(VariantTune* tunes, size_t count, bool is8MB)
+{
+    const AlgoTune* tune = is8MB ? tune8MB : tuneDefault;
+
+    size_t n = 0;
+
+    for (; (n < count) && (n < kVariantCount); ++n) {
+        tunes[n] = { cn_names[n], tune[n].hashrate, tune[n].step, tune[n].threads };
+    }
+
+    return n;
+}
+
+
 template <typename func>
 static inline bool findByType(hwloc_obj_t obj, hwloc_obj_type_t type, func lambda)
 {
@@ -785,6 +799,7 @@ void hash_octa(const uint8_t* data, size_t size, uint8_t* output, cryptonight_ct
 
 
 void benchmark() {}
+size_t variant_tunes(VariantTune*, size_t, bool) { return 0; }
 HelperThread* create_helper_thread(int64_t, int, const std::vector<int64_t>&) { return nullptr; }
 void destroy_helper_thread(HelperThread*) {}
 
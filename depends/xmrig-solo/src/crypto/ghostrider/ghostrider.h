@@ -38,6 +38,19 @@ namespace ghostrider
 
 struct HelperThread;
 
+// solominer telemetry, cn variant tuning from benchmark (0 hashrate if not run)
+struct VariantTune
+{
+    const char* name;
+    double hashrate;
+    uint32_t step;
+    uint32_t threads;
+};
+
+constexpr size_t kVariantCount = 6;
+
+size_t variant_tunes(VariantTune* tunes, size_t count, bool is8MB = false);
+
 void benchmark();
 HelperThread* create_helper_thread(int64_t cpu_index, int priority, const std::vector<int64_t>& affinities);
 void destroy_helper_thread(HelperThread* t);
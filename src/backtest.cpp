@@ -0,0 +1,172 @@
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+//////////////////////////////////////////////////////////////////////////////
+#include "backtest.h"
+
+#include <chains/forecast.h>
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Backtest
+
+static const char *g_backtestStrategyNames[] = {
+    "instant" ,"forecast"
+};
+
+const char *getBacktestStrategyName( BacktestStrategy strategy ) {
+    return g_backtestStrategyNames[ CLAMP( (int) strategy ,0 ,(int) backtestStrategyCount-1 ) ];
+}
+
+///--
+struct BacktestCoin {
+    String coin;
+    double hps; //! host hashrate for coin algorithm
+
+    ListOf<SeriesRecord> records;
+
+    size_t first = 0; //! first record within forecast window
+    size_t next = 0; //! first record at or after current time
+};
+
+struct BacktestRun {
+    BacktestResult result;
+
+    ProfitSwitchRule rule;
+
+    int current = -1;
+    time_t switchedAt = 0;
+    double downtime = 0; //! s, left from last switch
+};
+
+IRESULT runBacktest( const BacktestConfig &config ,ListOf<BacktestResult> &results ) {
+    const time_t period = getSeriesPeriod( seriesMinute );
+
+    if( config.to <= config.from ) return IBADARGS;
+
+///-- load history
+    ListOf<BacktestCoin> coins;
+
+    for( auto &it : config.coins ) {
+        BacktestCoin coin;
+
+        coin.coin = it; toupper( coin.coin );
+
+        CCoinRef p; auto hps = config.algorithmHps.end();
+
+        if( CCoinStore::getInstance().findCoinByTicker( coin.coin.c_str() ,p ) && p ) hps = config.algorithmHps.find( p->getAlgorithm() );
+
+        coin.hps = hps != config.algorithmHps.end() ? hps->second : config.hostHps;
+
+        getChainHistory().Query( coin.coin.c_str() ,seriesMinute ,config.from - PROFIT_FORECAST_WINDOW ,config.to ,coin.records );
+
+        if( !coin.records.empty() ) coins.emplace_back( coin );
+    }
+
+    if( coins.size() < 2 ) return INODATA;
+
+///-- replay
+    BacktestRun runs[backtestStrategyCount];
+
+    for( int s=0; s<backtestStrategyCount; ++s ) {
+        Zero( runs[s].result );
+
+        runs[s].result.strategy = (BacktestStrategy) s;
+    }
+
+    ListOf<ProfitScore> scores[backtestStrategyCount];
+    ListOf<double> realized( coins.size() );
+
+    for( time_t t = config.from - config.from % period; t < config.to; t += period ) {
+        for( int s=0; s<backtestStrategyCount; ++s ) scores[s].clear();
+
+        for( size_t i=0; i<coins.size(); ++i ) {
+            auto &coin = coins[i];
+            auto &records = coin.records;
+
+            //! @note only history before t is known when deciding
+            while( coin.next < records.size() && records[coin.next].time < t ) ++coin.next;
+            while( coin.first < coin.next && records[coin.first].time < t - PROFIT_FORECAST_WINDOW ) ++coin.first;
+
+            ProfitScore instant = { (int) i ,0. ,false };
+            ProfitScore forecast = instant;
+
+            realized[i] = 0.;
+
+            if( coin.next > 0 ) {
+                ChainInfo info = {};
+
+                toChainInfo( records[coin.next-1] ,info );
+
+                if( info.networkHPS > 0 && info.price > 0 ) {
+                    instant.earning = getProfitEarning( info ,getMiningReward( coin.coin.c_str() ,info ) ,coin.hps );
+                    instant.isPriced = true;
+
+                    forecast = instant;
+
+                    ChainForecast f;
+
+                    if( ISUCCESS( forecastChain( coin.coin.c_str() ,&records[coin.first] ,coin.next - coin.first ,period ,info ,PROFIT_SWITCH_HORIZON ,f ) ) )
+                        forecast.earning = getForecastEarning( instant.earning ,info ,f );
+                }
+
+                //! @note realized from the actual record of this minute, last known if none
+                if( coin.next < records.size() && records[coin.next].time == t )
+                    toChainInfo( records[coin.next] ,info );
+
+                realized[i] = getProfitEarning( info ,getMiningReward( coin.coin.c_str() ,info ) ,coin.hps );
+            }
+
+            scores[backtestInstant].emplace_back( instant );
+            scores[backtestForecast].emplace_back( forecast );
+        }
+
+        for( int s=0; s<backtestStrategyCount; ++s ) {
+            auto &run = runs[s];
+
+            const ProfitScore *best = NullPtr;
+
+            for( auto &score : scores[s] ) {
+                if( score.isPriced && (!best || score.earning > best->earning) ) best = &score;
+            }
+
+            if( !best ) continue;
+
+            if( run.current < 0 ) { //! @note start on best, no switch cost
+                run.current = best->id; run.switchedAt = t;
+            }
+            else if( run.rule.Check( *best ,scores[s][run.current] ,config.switchCost ,t ,run.switchedAt ) ) {
+                run.current = best->id; run.switchedAt = t;
+                run.downtime = config.switchCost;
+
+                ++run.result.switches;
+            }
+
+            double mining = (double) period - MIN( run.downtime ,(double) period );
+
+            run.downtime = MAX( run.downtime - period ,0. );
+
+            run.result.earning += realized[run.current] * mining / 86400;
+            run.result.energy += config.watts * period / 3600 / 1000;
+        }
+    }
+
+///-- results
+    for( auto &run : runs ) {
+        auto &result = run.result;
+
+        result.earningPerKwh = result.energy > 0 ? result.earning / result.energy : 0.;
+
+        results.emplace_back( result );
+    }
+
+    return IOK;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//EOF
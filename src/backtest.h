@@ -0,0 +1,62 @@
+#pragma once
+
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SOLOMINER_BACKTEST_H
+#define SOLOMINER_BACKTEST_H
+
+//////////////////////////////////////////////////////////////////////////////
+#include "connections.h"
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Backtest
+
+enum BacktestStrategy {
+    backtestInstant=0 //! score on last recorded chain info
+    ,backtestForecast //! score on chain info forecast over switch horizon
+    ,backtestStrategyCount
+};
+
+struct BacktestConfig {
+    ListOf<String> coins; //! auto connections, one per coin
+
+    time_t from ,to; //! replayed period
+
+    double hostHps = 1000.; //! for algorithms without their own hashrate
+    MapOf<PowAlgorithm,double> algorithmHps; //! host hashrate per algorithm, coins mine at their algorithm's
+    double watts = 100.; //! host power draw while mining
+    double switchCost = PROFIT_SWITCH_COST; //! s, downtime per switch
+};
+
+struct BacktestResult {
+    BacktestStrategy strategy;
+
+    double earning; //! usd, realized
+    double energy; //! kWh
+
+    double earningPerKwh;
+
+    int switches;
+};
+
+const char *getBacktestStrategyName( BacktestStrategy strategy );
+
+/**
+ * @brief replay recorded chain history, comparing switch strategies by realized earnings
+ * @note at each minute strategies only see history before that minute,
+ *      realized earning is from the minute actual record, nothing earned during switch downtime
+ * @note all strategies use the engine switch rule (margin, confirmation, dwell)
+ */
+
+IRESULT runBacktest( const BacktestConfig &config ,ListOf<BacktestResult> &results );
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//////////////////////////////////////////////////////////////////////////////
+#endif //SOLOMINER_BACKTEST_H
@@ -4,6 +4,7 @@
 
 //////////////////////////////////////////////////////////////////////////////
 #include "chains.h"
+#include "history.h"
 
 //////////////////////////////////////////////////////////////////////////////
 namespace solominer {
@@ -71,6 +72,168 @@ IAPI_DEF CChainStore::getInterface( PUID id ,void **ppv ) {
     ;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//! CChainRefresher
+
+String CChainRefresher::makeKey( CChainService &chain ,const char *coin ) {
+    String key = chain.info().name;
+
+    key += '/'; key += coin;
+
+    return key;
+}
+
+IRESULT CChainRefresher::getInfo( CChainService &chain ,const char *coin ,ChainInfo &info ) {
+    String key = makeKey( chain ,coin );
+
+    snapshot_t snapshot;
+
+    { CriticalSection::Guard guard(m_cs);
+
+        auto it = m_entries.find( key );
+
+        if( it == m_entries.end() ) {
+            Entry &entry = m_entries[key];
+
+            entry.chain = chain;
+            entry.coin = coin;
+        } else {
+            snapshot = it->second.snapshot;
+        }
+
+        if( !m_running ) {
+            m_quit = false;
+            m_running = Thread::Start() == ENOERROR;
+        }
+    }
+
+    if( !snapshot )
+        return INODATA;
+
+    info = *snapshot;
+
+    return IOK;
+}
+
+static int countStatFields( int fields ) {
+    int n = 0;
+
+    for( int f = fields & ~ChainInfoFlags::currentPrice; f; f &= f-1 ) ++n;
+
+    return n;
+}
+
+bool CChainRefresher::mergeSnapshots( const String &coin ,ChainInfo &info ) {
+    const ChainInfo *stats = NullPtr;
+    const ChainInfo *price = NullPtr;
+
+    for( auto &it : m_entries ) {
+        const Entry &entry = it.second;
+
+        if( !entry.snapshot || stricmp( entry.coin.c_str() ,coin.c_str() ) != 0 ) continue;
+
+        const ChainInfo &snapshot = *entry.snapshot;
+
+        //! @note local core has more statistics (IE block height) than a market data source
+        if( !stats || countStatFields( snapshot.fields ) > countStatFields( stats->fields ) )
+            stats = &snapshot;
+
+        if( (snapshot.fields & ChainInfoFlags::currentPrice) && (!price || snapshot.timestamp > price->timestamp) )
+            price = &snapshot;
+    }
+
+    if( !stats ) return false;
+
+    info = *stats;
+
+    if( price ) {
+        info.price = price->price;
+        info.fields |= ChainInfoFlags::currentPrice;
+        info.timestamp = MAX( info.timestamp ,price->timestamp );
+    }
+
+    //! @note sources may serve the same cached info again, recorded once
+    String ticker = coin; toupper( ticker );
+
+    time_t &recorded = m_recorded[ticker];
+
+    if( info.timestamp <= recorded ) return false;
+
+    recorded = info.timestamp;
+
+    return true;
+}
+
+void CChainRefresher::Invalidate( CChainService &chain ) {
+    CriticalSection::Guard guard(m_cs);
+
+    for( auto &it : m_entries ) {
+        if( it.second.chain == chain ) it.second.fetchAt = 0;
+    }
+}
+
+void CChainRefresher::Shutdown() {
+    if( !m_running ) return;
+
+    m_quit = true;
+
+    WaitFor();
+
+    m_running = false;
+}
+
+OsError CChainRefresher::Main() {
+    while( !m_quit ) {
+        Entry *entry = NullPtr;
+
+        { CriticalSection::Guard guard(m_cs);
+
+            time_t now = time(NullPtr);
+
+            for( auto &it : m_entries ) {
+                if( it.second.fetching || it.second.fetchAt > now ) continue;
+
+                entry = &it.second; entry->fetching = true; break;
+            }
+        }
+
+        if( !entry ) {
+            OsSleep( CHAIN_REFRESH_TICK ); continue;
+        }
+
+        ChainInfo info = {};
+
+        IRESULT result = entry->chain->getInfo( entry->coin.c_str() ,info ,ChainInfoFlags::noFlags );
+
+        time_t now = time(NullPtr);
+
+        if( ISUCCESS(result) && info.timestamp == 0 ) info.timestamp = now;
+
+        ChainInfo merged = {};
+
+        bool record = false;
+
+        { CriticalSection::Guard guard(m_cs);
+
+            entry->fetching = false;
+
+            if( ISUCCESS(result) ) {
+                entry->snapshot = std::make_shared<const ChainInfo>( info );
+                entry->fetchAt = now + CHAIN_REFRESH_INTERVAL;
+
+                record = mergeSnapshots( entry->coin ,merged );
+            } else {
+                entry->fetchAt = now + CHAIN_REFRESH_RETRY; //! @note last good snapshot kept
+            }
+        }
+
+        //! @note one series per coin, sources are not averaged together
+        if( record ) getChainHistory().Record( entry->coin.c_str() ,merged );
+    }
+
+    return ENOERROR;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 } //namespace solominer
 
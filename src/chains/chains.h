@@ -116,6 +116,74 @@ inline bool getChain( const char *name ,CChainServiceRef &service ) {
     return getService_( name ,service );
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//! Chain refresher
+
+#define CHAIN_REFRESH_INTERVAL  30 //! s, between two fetches of a coin info
+#define CHAIN_REFRESH_RETRY     5 //! s, after a failed fetch
+#define CHAIN_REFRESH_TICK      100 //! ms, refresher thread idle sleep
+
+/**
+ * @brief keep chain info of watched coins fresh, from a background thread
+ * @note readers get the last good snapshot right away (stale while revalidating), never waiting on network
+ * @note watched chains are only queried from the refresher thread
+ */
+
+class CChainRefresher : public Singleton_<CChainRefresher> ,protected Thread {
+protected:
+    typedef PtrOf<const ChainInfo> snapshot_t; //! @note immutable once published
+
+    struct Entry {
+        CChainServiceRef chain;
+        String coin;
+
+        snapshot_t snapshot; //! last good info, null until first fetch
+
+        time_t fetchAt = 0; //! next fetch
+        bool fetching = false;
+    };
+
+    CriticalSection m_cs;
+
+    MapOf<String,Entry> m_entries; //! chain/coin -> entry
+    MapOf<String,time_t> m_recorded; //! coin -> timestamp of last history sample
+
+    volatile bool m_running;
+    volatile bool m_quit;
+
+public:
+    CChainRefresher() : m_running(false) ,m_quit(false)
+    {}
+
+    ~CChainRefresher() {
+        Shutdown();
+    }
+
+public:
+    //! @brief last good info for coin from chain, coin is watched from now on
+    //! @return IOK with info and its age (timestamp), INODATA if not fetched yet
+    IRESULT getInfo( CChainService &chain ,const char *coin ,ChainInfo &info );
+
+    //! @brief fetch again as soon as possible (IE on new block), last good info is still served meanwhile
+    void Invalidate( CChainService &chain );
+
+    void Shutdown();
+
+protected:
+    static String makeKey( CChainService &chain ,const char *coin );
+
+    //! @brief info of coin merged across sources, statistics from the most complete source, price from any
+    //! @return true if changed since last recorded to history
+    //! @note under lock
+    bool mergeSnapshots( const String &coin ,ChainInfo &info );
+
+    OsError Main() override;
+};
+
+inline CChainRefresher &getChainRefresher() {
+    return CChainRefresher::getInstance();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 } //namespace solominer
 
@@ -0,0 +1,132 @@
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+//////////////////////////////////////////////////////////////////////////////
+#include "forecast.h"
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+#define FORECAST_MINSAMPLES     5
+
+//////////////////////////////////////////////////////////////////////////////
+//! Smoothing
+
+void HoltSmoother::Add( double x ) {
+    if( n == 0 ) {
+        level = x; trend = 0.;
+    } else {
+        double previous = level;
+
+        level = alpha * x + (1 - alpha) * (level + trend);
+        trend = beta * (level - previous) + (1 - beta) * trend;
+    }
+
+    ++n;
+}
+
+double HoltSmoother::getMean( double steps ) const {
+    //! @note mean of a linear forecast over [0,steps] is its value at mid horizon
+    double mean = level + trend * steps / 2;
+
+    return CLAMP( mean ,level / FORECAST_MAXRATIO ,level * FORECAST_MAXRATIO );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! Retarget
+
+//! @note block time is only used by epoch rules
+static const RetargetRule g_retargetRules[] = {
+    { "" ,retargetPerBlock ,0 ,0 } //! default, difficulty follows its own trend
+    ,{ "BTC" ,retargetEpoch ,2016 ,600 }
+    ,{ "BCH" ,retargetPerBlock ,0 ,600 }
+    ,{ "LTC" ,retargetEpoch ,2016 ,150 }
+    ,{ "DOGE" ,retargetPerBlock ,0 ,60 }
+    ,{ "RTM" ,retargetPerBlock ,0 ,120 }
+    //! @note raptoreum forks, dark gravity wave retarget on each block
+    ,{ "RTC" ,retargetPerBlock ,0 ,0 }
+    ,{ "BTRM" ,retargetPerBlock ,0 ,0 }
+    ,{ "MAXE" ,retargetPerBlock ,0 ,0 }
+};
+
+const RetargetRule &getRetargetRule( const char *coin ) {
+    for( auto &it : g_retargetRules ) {
+        if( coin && stricmp( coin ,it.coin ) == 0 ) return it;
+    }
+
+    return g_retargetRules[0];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! Forecast
+
+IRESULT forecastChain( const char *coin ,const SeriesRecord *records ,size_t count ,time_t period
+    ,const ChainInfo &current ,time_t horizon ,ChainForecast &forecast
+) {
+    if( period <= 0 ) return IBADARGS;
+
+    HoltSmoother diff( FORECAST_DIFF_ALPHA ,FORECAST_DIFF_BETA );
+    HoltSmoother hps( FORECAST_DIFF_ALPHA ,FORECAST_DIFF_BETA );
+    HoltSmoother price( FORECAST_PRICE_ALPHA );
+
+    for( size_t i=0; i<count; ++i ) {
+        const SeriesRecord &record = records[i];
+
+        if( record.hasField(seriesDiff) && record.value[seriesDiff] > 0 ) diff.Add( record.value[seriesDiff] );
+        if( record.hasField(seriesHPS) && record.value[seriesHPS] > 0 ) hps.Add( record.value[seriesHPS] );
+        if( record.hasField(seriesPrice) && record.value[seriesPrice] > 0 ) price.Add( record.value[seriesPrice] );
+    }
+
+    if( diff.n < FORECAST_MINSAMPLES )
+        return INODATA;
+
+    double steps = (double) horizon / period;
+
+    forecast.samples = diff.n;
+    forecast.networkHPS = hps.n >= FORECAST_MINSAMPLES ? hps.getMean( steps ) : current.networkHPS;
+    forecast.price = price.n >= FORECAST_MINSAMPLES ? price.getMean( steps ) : current.price;
+
+    const RetargetRule &rule = getRetargetRule( coin );
+
+    if( rule.type == retargetPerBlock ) {
+        forecast.networkDiff = diff.getMean( steps );
+        return IOK;
+    }
+
+///-- epoch, difficulty is known until next retarget, then follows hashrate
+    forecast.networkDiff = current.networkDiff;
+
+    if( current.blockHeight <= 0 || rule.epochBlocks <= 0 || current.networkHPS <= 0 )
+        return IOK;
+
+    int64_t blocksLeft = rule.epochBlocks - (current.blockHeight % rule.epochBlocks);
+
+    double secondsLeft = (double) blocksLeft * rule.blockTime;
+
+    if( secondsLeft >= horizon )
+        return IOK;
+
+    double retargetDiff = current.networkDiff * (forecast.networkHPS / current.networkHPS);
+
+    double w = secondsLeft / horizon;
+
+    forecast.networkDiff = w * current.networkDiff + (1 - w) * retargetDiff;
+
+    return IOK;
+}
+
+double getForecastEarning( double earning ,const ChainInfo &current ,const ChainForecast &forecast ) {
+    if( forecast.networkDiff > 0 && current.networkDiff > 0 )
+        earning *= current.networkDiff / forecast.networkDiff;
+
+    if( forecast.price > 0 && current.price > 0 )
+        earning *= forecast.price / current.price;
+
+    return earning;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//EOF
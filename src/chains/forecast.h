@@ -0,0 +1,94 @@
+#pragma once
+
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SOLOMINER_FORECAST_H
+#define SOLOMINER_FORECAST_H
+
+//////////////////////////////////////////////////////////////////////////////
+#include "history.h"
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Smoothing
+
+#define FORECAST_DIFF_ALPHA     0.2 //! difficulty level smoothing
+#define FORECAST_DIFF_BETA      0.05 //! difficulty trend smoothing
+#define FORECAST_PRICE_ALPHA    0.1 //! price smoothing, no trend (EWMA)
+#define FORECAST_MAXRATIO       2. //! forecast kept within [1/ratio,ratio] of last level
+
+/**
+ * @brief Holt double exponential smoothing, level and trend per step
+ * @note with beta = 0 trend stays 0, IE plain EWMA
+ */
+
+struct HoltSmoother {
+    double alpha ,beta;
+
+    double level = 0.;
+    double trend = 0.;
+
+    int n = 0;
+
+    HoltSmoother( double a_alpha ,double a_beta=0. ) : alpha(a_alpha) ,beta(a_beta)
+    {}
+
+    void Add( double x );
+
+    //! @brief mean of forecast over the next steps
+    double getMean( double steps ) const;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+//! Retarget
+
+enum RetargetType {
+    retargetPerBlock=0 //! difficulty follows hashrate every block (DGW, LWMA ...)
+    ,retargetEpoch //! difficulty fixed for an epoch of blocks (bitcoin)
+};
+
+struct RetargetRule {
+    const char *coin;
+
+    RetargetType type;
+
+    int epochBlocks; //! blocks per epoch, retargetEpoch only
+    int blockTime; //! s, target time per block
+};
+
+//! @note coins not listed retarget per block
+const RetargetRule &getRetargetRule( const char *coin );
+
+//////////////////////////////////////////////////////////////////////////////
+//! Forecast
+
+struct ChainForecast {
+    double networkDiff; //! expected mean over horizon
+    double networkHPS;
+    double price;
+
+    int samples; //! history records used
+};
+
+/**
+ * @brief forecast chain statistics over horizon from recorded history
+ * @param records history at a single resolution, oldest first, up to current
+ * @return INODATA if history is too short to say anything
+ */
+
+IRESULT forecastChain( const char *coin ,const SeriesRecord *records ,size_t count ,time_t period
+    ,const ChainInfo &current ,time_t horizon ,ChainForecast &forecast
+);
+
+//! @brief scale an earning estimated on current chain info to forecast conditions
+double getForecastEarning( double earning ,const ChainInfo &current ,const ChainForecast &forecast );
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//////////////////////////////////////////////////////////////////////////////
+#endif //SOLOMINER_FORECAST_H
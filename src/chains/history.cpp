@@ -0,0 +1,322 @@
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+//////////////////////////////////////////////////////////////////////////////
+#include "history.h"
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Record
+
+static const time_t g_seriesPeriods[] = {
+    60 ,3600 ,86400
+};
+
+static const char *g_seriesNames[] = {
+    "1m" ,"1h" ,"1d"
+};
+
+time_t getSeriesPeriod( SeriesResolution resolution ) {
+    return g_seriesPeriods[ CLAMP( (int) resolution ,0 ,(int) seriesResolutionCount-1 ) ];
+}
+
+void SeriesRecord::Add( SeriesField field ,double v ) {
+    uint16_t &n = count[field];
+
+    if( n == 0xffff ) return;
+
+    value[field] = (float) (n > 0 ? value[field] + (v - value[field]) / (n+1) : v);
+
+    ++n;
+
+    fields |= (1 << field);
+}
+
+void SeriesRecord::Add( const ChainInfo &info ) {
+    //! @note info without fields set is from an older source, assuming all but price
+    int f = info.fields ? info.fields : (currentDiff | networkHPS | blockReward | secondsPerBlock);
+
+    if( f & currentDiff ) Add( seriesDiff ,info.networkDiff );
+    if( f & networkHPS ) Add( seriesHPS ,info.networkHPS );
+    if( f & blockReward ) Add( seriesReward ,info.blockReward );
+    if( f & secondsPerBlock ) Add( seriesBlockPerHour ,info.blockPerHour );
+    if( f & currentPrice ) Add( seriesPrice ,info.price );
+}
+
+void SeriesRecord::Merge( const SeriesRecord &record ) {
+    for( int i=0; i<seriesFieldCount; ++i ) {
+        int n = record.count[i]; if( n == 0 ) continue;
+
+        int total = MIN( (int) count[i] + n ,0xffff );
+
+        value[i] = (float) (((double) value[i] * count[i] + (double) record.value[i] * n) / (count[i] + n));
+        count[i] = (uint16_t) total;
+    }
+
+    fields |= record.fields;
+}
+
+ChainInfo &toChainInfo( const SeriesRecord &record ,ChainInfo &info ) {
+    info.blockHeight = 0;
+
+    info.networkDiff = record.value[seriesDiff];
+    info.networkHPS = record.value[seriesHPS];
+    info.blockReward = record.value[seriesReward];
+    info.blockPerHour = record.value[seriesBlockPerHour];
+    info.price = record.value[seriesPrice];
+
+    info.timestamp = record.time;
+    info.fields = 0;
+
+    if( record.hasField(seriesDiff) ) info.fields |= currentDiff;
+    if( record.hasField(seriesHPS) ) info.fields |= networkHPS;
+    if( record.hasField(seriesReward) ) info.fields |= blockReward;
+    if( record.hasField(seriesBlockPerHour) ) info.fields |= secondsPerBlock;
+    if( record.hasField(seriesPrice) ) info.fields |= currentPrice;
+
+    return info;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! CSeriesFile
+
+IRESULT CSeriesFile::Open( const char *filepath ,const char *coin ,time_t period ) {
+    if( isOpen() ) return IALREADY;
+
+    if( !filepath || !coin || strlen(coin) >= 16 || period <= 0 )
+        return IBADARGS;
+
+    if( m_file.Open( filepath ,OS_ACCESS_ALL ,OS_SHARE_READ ,OS_CREATE_NOEXIST ) != ENOERROR )
+        return IERROR;
+
+    m_period = period;
+
+    Header header;
+
+    uint64_t size = m_file.GetSize();
+
+    if( size == 0 ) { //! new file
+        Zero( header );
+
+        memcpy( header.magic ,SERIES_MAGIC ,sizeof(header.magic) );
+        header.version = SERIES_VERSION;
+        header.sizeofRecord = sizeof(SeriesRecord);
+        header.period = (uint32_t) period;
+        strcpy( header.coin ,coin );
+
+        if( m_file.Write( (byte*) &header ,sizeof(header) ) != ENOERROR ) {
+            Close(); return IERROR;
+        }
+
+        m_count = 0;
+
+        return IOK;
+    }
+
+    bool valid =
+        m_file.Seek( 0 ,SEEK_SET ) == ENOERROR && m_file.Read( (byte*) &header ,sizeof(header) ) == ENOERROR
+        && memcmp( header.magic ,SERIES_MAGIC ,sizeof(header.magic) ) == 0
+        && header.version == SERIES_VERSION
+        && header.sizeofRecord == sizeof(SeriesRecord)
+        && header.period == (uint32_t) period
+    ;
+
+    if( !valid ) {
+        Close(); return IBADDATA;
+    }
+
+    //! @note a partly written trailing record is dropped (overwritten by next append)
+    m_count = (size_t) ((size - sizeof(Header)) / sizeof(SeriesRecord));
+
+    if( m_count > 0 && !readRecord( m_count-1 ,m_last ) ) {
+        Close(); return IERROR;
+    }
+
+    return IOK;
+}
+
+void CSeriesFile::Close() {
+    m_file.Close();
+
+    m_count = 0;
+}
+
+IRESULT CSeriesFile::Add( time_t time ,const SeriesRecord &record ) {
+    if( !isOpen() ) return IBADENV;
+
+    uint32_t t = (uint32_t) (time - time % m_period);
+
+    if( m_count > 0 && t < m_last.time )
+        return IREFUSED;
+
+    if( m_count > 0 && t == m_last.time ) { //! @note open period
+        m_last.Merge( record );
+
+        return writeRecord( m_count-1 ,m_last ) ? IOK : IERROR;
+    }
+
+    SeriesRecord last = record;
+
+    last.time = t;
+
+    if( !writeRecord( m_count ,last ) )
+        return IERROR;
+
+    m_last = last; ++m_count;
+
+    return IOK;
+}
+
+IRESULT CSeriesFile::Query( time_t from ,time_t to ,ListOf<SeriesRecord> &records ) {
+    if( !isOpen() ) return IBADENV;
+
+    size_t a = findRecord( from );
+    size_t b = findRecord( to );
+
+    if( a >= b ) return INODATA;
+
+    size_t n = records.size();
+
+    records.resize( n + (b-a) );
+
+    //! @note range is contiguous on file, single read
+    size_t offset = sizeof(Header) + a * sizeof(SeriesRecord);
+
+    if( m_file.Seek( offset ,SEEK_SET ) == ENOERROR && m_file.Read( (byte*) &records[n] ,(b-a) * sizeof(SeriesRecord) ) == ENOERROR ) {} else {
+        records.resize( n ); return IERROR;
+    }
+
+    return IOK;
+}
+
+///-- protected
+bool CSeriesFile::readRecord( size_t index ,SeriesRecord &record ) {
+    size_t offset = sizeof(Header) + index * sizeof(SeriesRecord);
+
+    return m_file.Seek( offset ,SEEK_SET ) == ENOERROR && m_file.Read( (byte*) &record ,sizeof(SeriesRecord) ) == ENOERROR;
+}
+
+bool CSeriesFile::writeRecord( size_t index ,const SeriesRecord &record ) {
+    size_t offset = sizeof(Header) + index * sizeof(SeriesRecord);
+
+    return m_file.Seek( offset ,SEEK_SET ) == ENOERROR && m_file.Write( (const byte*) &record ,sizeof(SeriesRecord) ) == ENOERROR;
+}
+
+size_t CSeriesFile::findRecord( time_t time ) {
+    size_t a = 0 ,b = m_count;
+
+    if( b > 0 && (time_t) m_last.time < time ) return b; //! @note most queries are about recent history
+
+    SeriesRecord record;
+
+    while( a < b ) {
+        size_t m = a + (b-a) / 2;
+
+        if( !readRecord( m ,record ) ) return m_count;
+
+        if( (time_t) record.time < time ) a = m+1; else b = m;
+    }
+
+    return a;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! CChainHistory
+
+void CChainHistory::Open( const char *path ) {
+    CriticalSection::Guard guard(m_cs);
+
+    m_path = path ? path : "";
+}
+
+void CChainHistory::Close() {
+    CriticalSection::Guard guard(m_cs);
+
+    m_series.clear();
+}
+
+String CChainHistory::makeFilepath( const char *path ,const char *coin ,SeriesResolution resolution ) {
+    String filepath = path ? path : "";
+
+    filepath += coin;
+    filepath += '-';
+    filepath += g_seriesNames[resolution];
+    filepath += SERIES_EXTENSION;
+
+    return filepath;
+}
+
+IRESULT CChainHistory::Record( const char *coin ,const ChainInfo &info ) {
+    if( !coin || !*coin ) return IBADARGS;
+
+    SeriesRecord record;
+
+    Zero( record );
+
+    record.Add( info );
+
+    if( record.fields == 0 ) return INODATA;
+
+    time_t time = info.timestamp ? info.timestamp : ::time(NullPtr);
+
+    CriticalSection::Guard guard(m_cs);
+
+    CoinSeries *series = getSeries( coin );
+
+    if( !series ) return IERROR;
+
+    IRESULT result = IOK;
+
+    for( int i=0; i<seriesResolutionCount; ++i ) {
+        IRESULT ir = series->files[i].Add( time ,record );
+
+        if( IFAILED(ir) ) result = ir;
+    }
+
+    return result;
+}
+
+IRESULT CChainHistory::Query( const char *coin ,SeriesResolution resolution ,time_t from ,time_t to ,ListOf<SeriesRecord> &records ) {
+    if( !coin || !*coin || resolution < 0 || resolution >= seriesResolutionCount ) return IBADARGS;
+
+    CriticalSection::Guard guard(m_cs);
+
+    CoinSeries *series = getSeries( coin );
+
+    if( !series ) return IERROR;
+
+    return series->files[resolution].Query( from ,to ,records );
+}
+
+///-- protected
+CChainHistory::CoinSeries *CChainHistory::getSeries( const char *coin ) {
+    String ticker = coin; toupper( ticker );
+
+    auto it = m_series.find( ticker );
+
+    if( it != m_series.end() )
+        return it->second.get();
+
+    auto series = std::make_shared<CoinSeries>();
+
+    for( int i=0; i<seriesResolutionCount; ++i ) {
+        auto resolution = (SeriesResolution) i;
+
+        String filepath = makeFilepath( m_path.c_str() ,ticker.c_str() ,resolution );
+
+        if( IFAILED( series->files[i].Open( filepath.c_str() ,ticker.c_str() ,getSeriesPeriod(resolution) ) ) )
+            return NullPtr;
+    }
+
+    m_series[ticker] = series;
+
+    return series.get();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//EOF
@@ -0,0 +1,167 @@
+#pragma once
+
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SOLOMINER_HISTORY_H
+#define SOLOMINER_HISTORY_H
+
+//////////////////////////////////////////////////////////////////////////////
+#include <common/common.h>
+
+#include <interface/IChain.h>
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Record
+
+#define SERIES_MAGIC            "SMSERIES"
+#define SERIES_VERSION          1
+#define SERIES_EXTENSION        ".series"
+
+enum SeriesField {
+    seriesDiff=0 ,seriesHPS ,seriesReward ,seriesBlockPerHour ,seriesPrice
+    ,seriesFieldCount
+};
+
+enum SeriesResolution {
+    seriesMinute=0 ,seriesHour ,seriesDay
+    ,seriesResolutionCount
+};
+
+//! @brief period in seconds of a resolution
+time_t getSeriesPeriod( SeriesResolution resolution );
+
+/**
+ * @brief one period of coin history, fixed size on file
+ * @note values are the mean of samples received during the period, per field
+ */
+
+struct SeriesRecord {
+    uint32_t time; //! period start, unix time
+    uint16_t fields; //! (1 << SeriesField) of fields with samples
+    uint16_t count[seriesFieldCount]; //! samples per field
+
+    float value[seriesFieldCount];
+
+    bool hasField( SeriesField field ) const { return (fields & (1 << field)) != 0; }
+
+    void Add( const ChainInfo &info );
+    void Add( SeriesField field ,double value );
+
+    //! @brief merge a finer record into this one (rollup)
+    void Merge( const SeriesRecord &record );
+};
+
+//! @brief chain info as recorded, fields without samples are left 0
+ChainInfo &toChainInfo( const SeriesRecord &record ,ChainInfo &info );
+
+//////////////////////////////////////////////////////////////////////////////
+//! Series file
+
+/**
+ * @brief append only file of fixed size records, one per period
+ * @note last (open) period is rewritten in place until next period starts
+ * @note records are ordered by time, range lookup is a binary search on file
+ */
+
+class CSeriesFile {
+protected:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t sizeofRecord;
+        uint32_t period; //! seconds per record
+        uint32_t reserved;
+        char coin[16];
+        byte user[24];
+    };
+
+    File m_file;
+
+    time_t m_period;
+    size_t m_count; //! records on file
+
+    SeriesRecord m_last; //! last record, as on file
+
+public:
+    CSeriesFile() : m_period(0) ,m_count(0)
+    {}
+
+    bool isOpen() { return m_file.isOpen(); }
+
+    time_t period() const { return m_period; }
+    size_t count() const { return m_count; }
+
+public:
+    IRESULT Open( const char *filepath ,const char *coin ,time_t period );
+    void Close();
+
+    //! @brief add to period of time, appending a new record if period is past last one
+    //! @note records older than last period are ignored (append only)
+    IRESULT Add( time_t time ,const SeriesRecord &record );
+
+    //! @brief records with from <= time < to
+    IRESULT Query( time_t from ,time_t to ,ListOf<SeriesRecord> &records );
+
+protected:
+    bool readRecord( size_t index ,SeriesRecord &record );
+    bool writeRecord( size_t index ,const SeriesRecord &record );
+
+    size_t findRecord( time_t time ); //! index of first record at or after time
+};
+
+//////////////////////////////////////////////////////////////////////////////
+//! Chain history
+
+/**
+ * @brief per coin time series of chain statistics, at minute, hour and day resolution
+ * @note each sample is rolled up into all resolutions as it is recorded
+ */
+
+class CChainHistory : public Singleton_<CChainHistory> {
+protected:
+    struct CoinSeries {
+        CSeriesFile files[seriesResolutionCount];
+    };
+
+    CriticalSection m_cs;
+
+    String m_path; //! folder of series files
+
+    MapOf<String,PtrOf<CoinSeries> > m_series; //! coin -> opened series
+
+public:
+    CChainHistory() DEFAULT;
+
+    ~CChainHistory() {
+        Close();
+    }
+
+public:
+    void Open( const char *path );
+    void Close();
+
+    static String makeFilepath( const char *path ,const char *coin ,SeriesResolution resolution );
+
+    //! @brief record fields available in info, at info timestamp
+    IRESULT Record( const char *coin ,const ChainInfo &info );
+
+    IRESULT Query( const char *coin ,SeriesResolution resolution ,time_t from ,time_t to ,ListOf<SeriesRecord> &records );
+
+protected:
+    CoinSeries *getSeries( const char *coin ); //! @note under lock
+};
+
+inline CChainHistory &getChainHistory() {
+    return CChainHistory::getInstance();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//////////////////////////////////////////////////////////////////////////////
+#endif //SOLOMINER_HISTORY_H
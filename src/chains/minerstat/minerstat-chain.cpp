@@ -5,9 +5,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "minerstat-chain.h"
 
-#include <rapidjson/document.h>
-#include <rapidjson/reader.h>
-#include <rapidjson/stringbuffer.h>
+#include <common/http-json.h>
 
 #include <memory.h>
 
@@ -20,14 +18,77 @@ static IServiceSetupRef g_setup( new CChainSetupMinerstat() );
 static iresult_t g_hasMinerstat = getChainStore().registerServiceSupport( MINERSTAT_NAME ,g_setup );
 
 //////////////////////////////////////////////////////////////////////////////
-iresult_t CChainMinerstat::getInfo( const char *coin ,ChainInfo &info ,ChainInfoFlags flags ) {
+void CChainMinerstat::addCoin( const char *coin ) {
+    String ticker = coin;
+
+    toupper( ticker );
+
+    for( auto &it : m_coins ) {
+        if( it == ticker ) return;
+    }
+
+    m_coins.emplace_back( ticker );
+
+    m_snapshotTime = 0; //! @note not in snapshot yet
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! @brief decode minerstat coin list into chain info, coin per coin as it is received
+
+struct MinerstatCoinHandler : JsonObjectHandler_<MinerstatCoinHandler> {
+    MapOf<std::string,ChainInfo> &snapshot;
+    time_t now;
+
+    ChainInfo info;
+    double reward1Hps1h = 0.;
+
+    MinerstatCoinHandler( MapOf<std::string,ChainInfo> &a_snapshot ,time_t a_now ) :
+        snapshot(a_snapshot) ,now(a_now)
+    {
+        objectDepth = 2;
+    }
+
+    void onObject() {
+        info = ChainInfo();
+        reward1Hps1h = 0.;
+    }
+
+    void onField( const char *key ,const char *value ,size_t length ) {
+        std::string s( value ,length );
+
+        if( strcmp( key ,"coin" ) == 0 ) info.name = s;
+        else if( strcmp( key ,"difficulty" ) == 0 ) info.networkDiff = atof( s.c_str() );
+        else if( strcmp( key ,"network_hashrate" ) == 0 ) info.networkHPS = atof( s.c_str() );
+        else if( strcmp( key ,"reward_block" ) == 0 ) info.blockReward = atof( s.c_str() );
+        else if( strcmp( key ,"price" ) == 0 ) info.price = atof( s.c_str() );
+        else if( strcmp( key ,"reward" ) == 0 ) reward1Hps1h = atof( s.c_str() );
+    }
+
+    void onObjectEnd() {
+        if( info.name.empty() || snapshot.find(info.name) != snapshot.end() ) return; //! @note first entry per coin
+
+        info.blockHeight = 0;
+        info.blockPerHour = info.blockReward > 0 ? info.networkHPS * reward1Hps1h / info.blockReward : 0;
+
+        info.timestamp = now;
+        info.fields = currentDiff | networkHPS | blockReward | secondsPerBlock | currentPrice;
+
+        snapshot[info.name] = info;
+    }
+};
+
+IRESULT CChainMinerstat::Refresh() {
     // https://api.minerstat.com/v2/coins?list=BTC,BCH,BSV
 
-    if( coin[0]==0 || stricmp( coin ,"OWN" ) == 0 )
-        return false;
+    if( m_coins.empty() )
+        return INOTHING;
 
     std::stringstream ss;
-    ss << m_host << MINERSTAT_APIPATH << "/coins?list=" << coin;
+    ss << m_host << MINERSTAT_APIPATH << "/coins?list=";
+
+    int i=0; for( auto &it : m_coins ) {
+        ss << (i++ ? "," : "") << it;
+    }
 
     HttpMessage message;
 
@@ -36,58 +97,51 @@ iresult_t CChainMinerstat::getInfo( const char *coin ,ChainInfo &info ,ChainInfo
 
     message.accept_type = "application/json";
 
-    HttpResponse response;
-
-// return IERROR; //! TEST
     CHttpRequest request;
 
-    if( m_http.sendRequest( ss.str().c_str() ,HttpMethod::methodGET ,message ,request ,response ) != IOK || response.content.empty() )
-        return IERROR;
+    request.priority() = quotaRefresh;
 
-    double reward1Hps1h = 0;
-    String rewardCoin;
+    m_http.makeRequest( ss.str().c_str() ,HttpMethod::methodGET ,message ,request );
 
-    try {
-        rapidjson::Document jdoc;
+    MapOf<String,ChainInfo> snapshot;
 
-        jdoc.Parse( tocstr(response.content) );
+    time_t now = time(NullPtr);
 
-        if( jdoc.GetArray().Empty() )
-            return INODATA;
+    MinerstatCoinHandler handler( snapshot ,now );
 
-        auto &v = jdoc[0];
+    IRESULT ir = sendJsonRequest_( m_http ,request ,handler ); IF_IFAILED_RETURN(ir);
 
-        {
-            info.networkDiff = (double) v["difficulty"].GetDouble();
-            info.networkHPS = (double) v["network_hashrate"].GetDouble();
-            info.blockReward = (double) v["reward_block"].GetDouble();
-            info.price = (double) v["price"].GetDouble();
+    if( snapshot.empty() )
+        return IBADDATA;
 
-            reward1Hps1h = (double) v["reward"].GetDouble();
-            rewardCoin = v["reward_unit"].GetString();
-        }
-    } catch(...) {
-        return IERROR;
-    }
+    m_snapshot = snapshot;
+    m_snapshotTime = now;
 
-    info.blockPerHour = info.networkHPS * reward1Hps1h / info.blockReward;
+    return IOK;
+}
 
-    /* if( info.networkDiff < 1 && rewardCoin == coin ) {
-        //! TEST // not proper computation below //! TEST //
+iresult_t CChainMinerstat::getInfo( const char *coin ,ChainInfo &info ,ChainInfoFlags flags ) {
+    if( coin[0]==0 || stricmp( coin ,"OWN" ) == 0 )
+        return INODATA;
+
+    String ticker = coin;
 
-        info.networkDiff = (info.blockReward * 3600) / (reward1Hps1h * (2.*1024*1024*1024));
+    toupper( ticker );
 
-        double hostHps = 1;
+    addCoin( ticker.c_str() );
 
-        double blockPerHour = (hostHps*60*60) / (info.networkDiff * 2.*1024*1024*1024);
+    time_t now = time(NullPtr);
+
+    if( m_snapshotTime + MINERSTAT_REFRESH <= now && m_retryTime <= now ) {
+        if( ISUCCESS( Refresh() ) ) {} else m_retryTime = now + MINERSTAT_RETRY;
+    }
 
-        double rewardPerHour = info.blockReward * blockPerHour;
-        double _reward1Hph = info.blockReward * 3600 / (info.networkDiff * 4.*1024*1024*1024);
+    auto it = m_snapshot.find( ticker );
 
-        info.networkDiff = (info.blockReward * 3600) / (reward1Hps1h * (2.*1024*1024*1024));
-    } */
+    if( it == m_snapshot.end() )
+        return INODATA;
 
-    m_http.adviseRequestValid( request );
+    info = it->second;
 
     return IOK;
 }
@@ -12,6 +12,7 @@
 #include <common/http.h>
 
 #include <chains/chains.h>
+#include <coins/coins.h>
 
 //////////////////////////////////////////////////////////////////////////////
 namespace solominer {
@@ -21,7 +22,15 @@ namespace solominer {
 #define MINERSTAT_HOSTNAME      "https://api.minerstat.com"
 #define MINERSTAT_APIPATH       "/v2"
 
+#define MINERSTAT_REFRESH       60 //! s, snapshot validity
+#define MINERSTAT_RETRY         10 //! s, delay before retrying a failed refresh
+
 //////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief chain info from minerstat
+ * @note all coins are fetched in a single request, getInfo is served from the resulting snapshot
+ */
+
 class CChainMinerstat : public CChainService {
 protected:
     CHttpConnection m_http;
@@ -30,8 +39,16 @@ protected:
 
     String m_host;
 
+    ///-- snapshot
+    ListOf<String> m_coins; //! coins to fetch, registered coins and any coin queried since
+    MapOf<String,ChainInfo> m_snapshot; //! coin -> info, as of last refresh
+
+    time_t m_snapshotTime; //! time of last refresh, 0 to refresh on next query
+    time_t m_retryTime; //! no refresh attempt before, after a failure
+
 public:
     CChainMinerstat( IServiceSetupRef &setup ) : CChainService(setup)
+        ,m_snapshotTime(0) ,m_retryTime(0)
     {
         this->info().name = MINERSTAT_NAME;
 
@@ -40,8 +57,16 @@ public:
 
     ~CChainMinerstat() {
         m_http.cache().Save();
+        m_http.quota().Save();
     }
 
+public: ///-- CChainMinerstat
+    //! @note coin will be part of next refresh
+    void addCoin( const char *coin );
+
+    //! @brief fetch all coins, in a single request
+    IRESULT Refresh();
+
 public: ///-- IChain
     IAPI_IMPL getInfo( const char *coin ,ChainInfo &info ,ChainInfoFlags flags ) IOVERRIDE;
 
@@ -59,6 +84,13 @@ public: ///-- IService
         m_host = !m_config.host.empty() ? m_config.host : MINERSTAT_HOSTNAME;
 
         m_http.quota().setLimit( 10 ,60 );
+        m_http.quota().Load( "minerstat-quota.dat" ); //! @note after setLimit, restores tokens left from last run
+
+        ListOf<String> coins;
+
+        for( auto &it : getCoinList( coins ) ) {
+            addCoin( it.c_str() );
+        }
 
         return CChainService::Start( params );
     }
@@ -4,6 +4,7 @@
 
 //////////////////////////////////////////////////////////////////////////////
 #include <solominer.h>
+#include <common/logging.h>
 #include <coins/cores.h>
 #include <wallets/wallets.h>
 
@@ -33,23 +34,83 @@ namespace solominer {
 //////////////////////////////////////////////////////////////////////////////
 //! Daemon service
 
+BitcoinRPC *CCoreRpcPool::Acquire( const CoreConfig &config ,int &generation ) {
+    const String &username = config.credential.user;
+    const String &password = config.credential.password;
+
+    const String &url = config.connection.host;
+    int port = config.connection.port;
+
+    std::stringstream ss;
+
+    ss << username << ':' << password << '@' << url << ':' << port;
+
+    CriticalSection::Guard guard(m_cs);
+
+    //! @note connection changed, drop clients to previous endpoint
+    if( ss.str() != m_endpoint ) {
+        for( auto *client : m_idle ) delete client;
+
+        m_idle.clear(); ++m_generation;
+
+        m_endpoint = ss.str();
+    }
+
+    generation = m_generation;
+
+    if( !m_idle.empty() ) {
+        BitcoinRPC *client = m_idle.back();
+
+        m_idle.pop_back();
+
+        return client;
+    }
+
+    //! Constructor to connect daemon
+    return new BitcoinRPC( username ,password ,url ,port ,CORE_RPC_TIMEOUT );
+}
+
+void CCoreRpcPool::Release( BitcoinRPC *client ,int generation ,bool healthy ) {
+    if( !client ) return;
+
+    CriticalSection::Guard guard(m_cs);
+
+    if( !healthy ) {
+        //! @note daemon likely gone or restarted, other idle connections are stale too
+        for( auto *idle : m_idle ) delete idle;
+
+        m_idle.clear(); ++m_generation;
+    }
+
+    if( healthy && generation == m_generation && m_idle.size() < CORE_RPC_POOL_SIZE ) {
+        m_idle.emplace_back( client );
+    } else {
+        delete client;
+    }
+}
+
+void CCoreRpcPool::Reset() {
+    CriticalSection::Guard guard(m_cs);
+
+    for( auto *client : m_idle ) delete client;
+
+    m_idle.clear(); ++m_generation;
+}
+
+///--
 template <class TCore ,typename TLambda>
 iresult_t CallDaemon( TCore &core ,TLambda &&method ) {
-    const String &username = core.config().credential.user;
-    const String &password = core.config().credential.password;
-
-    const String &url = core.config().connection.host;
-    int port = core.config().connection.port;
+    CCoreRpcPool::Lease lease( core.rpc() ,core.config() );
 
     try {
-        //! Constructor to connect daemon
-        BitcoinRPC cored( username ,password ,url ,port ,1000 );
-
         //! bitcoin API method call
-        method( core ,cored );
+        method( core ,*lease.client );
     }
     catch( BitcoinRpcException &e ) {
         std::cerr << e.getMessage() << std::endl;
+
+        lease.healthy = e.getCode() != bitcoinrpc::ERROR_CLIENT_CONNECTOR;
+
         return IERROR;
     }
 
@@ -87,6 +148,10 @@ IAPI_DEF CWalletBitcoinBase::Start( const Params &params ) {
     if( m_core.state() != serviceStarted )
         return m_core.Start(params);
 
+    String coin; getCoin(coin);
+
+    getNotifyListener().Subscribe( coin.c_str() ,*this );
+
     return CWalletService::Start( params );
 }
 
@@ -98,6 +163,13 @@ IAPI_DEF CWalletBitcoinBase::Stop( const Params &params ) {
     if( m_core.state() == serviceConnected )
         return m_core.Stop(params);
 
+    String coin; getCoin(coin);
+
+    getNotifyListener().Revoke( coin.c_str() ,*this );
+    getWalletSyncer().Cancel( *this );
+
+    invalidateCache();
+
     return CWalletService::Stop( params );
 }
 
@@ -149,17 +221,6 @@ void setTransaction( const char *coin ,WalletTransaction &t ,const transactionin
     t.confirmations = tx.confirmations;
 }
 
-int getLastTransactionTime( std::vector<transactioninfo_t> &txs ) {
-    int last = 0;
-
-    for( auto &it : txs ) {
-        if( last < it.timereceived )
-            last = it.timereceived;
-    }
-
-    return last;
-}
-
 ///--
 IAPI_DEF CWalletBitcoinBase::listAddresses( const char *accountId ,ListOf<String> &addresses ) {
     IRESULT result = CallDaemon( core() ,[accountId,&addresses]( CCoreBitcoinBase &core ,BitcoinRPC &api ) {
@@ -186,50 +247,110 @@ IAPI_DEF CWalletBitcoinBase::getNewAddress( const char *accountId ,String &addre
 }
 
 IAPI_DEF CWalletBitcoinBase::getAddressBalance( const char *address ,AmountValue &balance ) {
-    double amount;
+    String coin; getCoin(coin);
 
-    auto lambda = [&amount]( CCoreBitcoinBase &core ,BitcoinRPC &api ){
-        amount = api.getbalance();
-    };
+    double amount;
 
-    if( CallDaemon( core() ,lambda ) != IOK )
-        return IERROR;
+    //! @note balance from last sync until invalidated by a wallet event or max age
+    //! @note then sync is requested, never made from caller thread, last known balance is served meanwhile
+    if( !m_balance.get( amount ,getCacheMaxAge() ) ) {
+        getWalletSyncer().Request( *this );
 
-    String coin; getCoin(coin);
+        if( !m_balance.known() )
+            return IPROGRESS;
+    }
 
     balance = { amount ,coin };
 
-///-- check for incoming transaction
+    return IOK;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///-- sync
+
+struct CWalletBitcoinBase::SyncResult {
     std::vector<transactioninfo_t> txs;
+    String lastBlock;
+    bool rescan = false;
+};
 
-    IRESULT result = CallDaemon( core() ,[&txs]( CCoreBitcoinBase &core ,BitcoinRPC &api ){
-        txs = api.listtransactions();
-    });
+IAPI_DEF CWalletBitcoinBase::Sync() {
+    String syncBlock;
 
-    IF_IFAILED_RETURN(result);
+    { CriticalSection::Guard guard(m_syncCs);
 
-    int lastTxTime = getLastTransactionTime( txs );
+        LoadSync();
 
-    if( m_initialTxTime == 0 ) { //! first balance check
-        m_initialTxTime = lastTxTime;
+        syncBlock = m_syncBlock;
+    }
 
-    } else if( lastTxTime > m_initialTxTime ) { //! new transaction detected
-         for( auto &it : txs ) {
-            if( it.timereceived <= m_initialTxTime ) continue;
+    double amount = 0.;
 
-            WalletTransaction t;
+    auto synced = std::make_shared<SyncResult>();
+
+    //! @note balance and transactions since last sync in a single round trip
+    auto lambda = [&syncBlock,&amount,&synced]( CCoreBitcoinBase &core ,BitcoinRPC &api ){
+        bitcoinrpc::BatchCall calls;
+        bitcoinrpc::BatchResponse responses;
+
+        Json::Value params;
+
+        params.append( syncBlock );
+        params.append( WALLET_SYNC_CONFIRMATIONS );
+
+        int balanceId = calls.addCall( "getbalance" ,Json::Value() );
+        int sinceId = calls.addCall( "listsinceblock" ,params );
+
+        api.sendbatch( calls ,responses );
+
+        amount = responses.getResult( balanceId ).asDouble();
+
+        //! @note cursor block unknown to daemon (deep reorg or new chain data), rescan from start
+        if( responses.getErrorCode( sinceId ) == -5 && !syncBlock.empty() ) {
+            synced->rescan = true;
 
-            setTransaction( tocstr(coin) ,t ,it );
+            txsinceblock_t since = api.listsinceblock( "" ,WALLET_SYNC_CONFIRMATIONS );
 
-            CWalletEventSource::PostTransaction( *this ,t );
+            synced->txs = since.transactions;
+            synced->lastBlock = since.lastblock;
+
+            return;
         }
 
-        m_initialTxTime = lastTxTime;
+        Json::Value since = responses.getResult( sinceId );
+
+        BitcoinRPC::parsetransactions( since["transactions"] ,synced->txs );
+        synced->lastBlock = since["lastblock"].asString();
+    };
+
+    if( CallDaemon( core() ,lambda ) != IOK )
+        return IERROR;
+
+    { CriticalSection::Guard guard(m_syncCs);
+
+        //! @note cursor only moves when published, a result not published yet is superseded
+        m_synced = synced;
     }
 
+    m_balance.set( amount );
+
     return IOK;
 }
 
+void CWalletBitcoinBase::adviseSynced() {
+    PtrOf<SyncResult> synced;
+
+    { CriticalSection::Guard guard(m_syncCs);
+
+        synced.swap( m_synced );
+    }
+
+    if( !synced ) return;
+
+///-- post incoming transactions
+    SyncTransactions( synced->txs ,synced->lastBlock ,synced->rescan );
+}
+
 IAPI_DEF CWalletBitcoinBase::listTransactions( const char *address ,ListOf<WalletTransaction> &transactions ,int from ,int count ) {
     std::vector<transactioninfo_t> txs;
 
@@ -259,8 +380,141 @@ IAPI_DEF CWalletBitcoinBase::listTransactions( const char *address ,ListOf<Walle
     return IOK;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+///-- notify
+
+void CWalletBitcoinBase::onNotify( const NotifyEvent &event ) {
+    //! @note new transaction or new block (confirmations, reorg), sync right away from sync thread
+    invalidateCache();
+
+    getWalletSyncer().Request( *this );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///-- cache
+
+time_t CWalletBitcoinBase::getCacheMaxAge() {
+    return core().isNotifying() ? WALLET_SYNC_MAXAGE : WALLET_SYNC_POLL;
+}
+
+void CWalletBitcoinBase::invalidateCache() {
+    m_balance.invalidate();
+
+    CriticalSection::Guard guard(m_cacheCs);
+
+    m_transactions.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///-- transaction sync
+
+String makeSyncKey( const transactioninfo_t &tx ) {
+    return tx.txid + ':' + tx.category + ':' + tx.address;
+}
+
+String CWalletBitcoinBase::getSyncFilename() {
+    String coin; getCoin(coin);
+
+    tolower(coin);
+
+    return coin + "-wallet-sync.dat";
+}
+
+void CWalletBitcoinBase::LoadSync() {
+    if( m_syncLoaded ) return;
+
+    m_syncLoaded = true;
+
+    std::ifstream fs( getSyncFilename() );
+
+    if( !fs.is_open() ) return;
+
+    String key; int confirmations;
+
+    if( !(fs >> m_syncBlock >> m_syncTime) ) {
+        m_syncBlock.clear(); m_syncTime = 0;
+        return;
+    }
+
+    while( fs >> key >> confirmations ) {
+        m_syncSeen[key] = confirmations;
+    }
+}
+
+void CWalletBitcoinBase::SaveSync() {
+    std::ofstream fs( getSyncFilename() );
+
+    if( !fs.is_open() ) return;
+
+    fs << m_syncBlock << ' ' << m_syncTime << '\n';
+
+    for( auto &it : m_syncSeen ) {
+        fs << it.first << ' ' << it.second << '\n';
+    }
+}
+
+void CWalletBitcoinBase::SyncTransactions( const std::vector<transactioninfo_t> &txs ,const String &lastBlock ,bool rescan ) {
+    bool baseline = m_syncBlock.empty() && m_syncTime == 0; //! first sync, history is not income
+
+    String coin; getCoin(coin);
+
+    MapOf<String,int> seen;
+
+    for( auto &it : txs ) {
+        String key = makeSyncKey( it );
+
+        auto jt = m_syncSeen.find( key );
+
+        bool isNew = jt == m_syncSeen.end();
+
+        //! @note reorg, transaction no longer in main chain
+        if( !isNew && it.confirmations < 0 && jt->second >= 0 ) {
+            LOG_WARNING << LogCategory::net << coin << " transaction " << it.txid << " was reverted (reorg or conflict)";
+        }
+
+        //! @note transaction may show again in next sync while within cursor depth
+        if( it.confirmations < WALLET_SYNC_CONFIRMATIONS ) {
+            seen[key] = it.confirmations;
+        }
+
+        if( !isNew || baseline || it.confirmations < 0 ) continue;
+
+        //! @note on rescan, only transactions more recent than last sync are new
+        if( rescan && it.timereceived < m_syncTime ) continue;
+
+        WalletTransaction t;
+
+        setTransaction( tocstr(coin) ,t ,it );
+
+        CWalletEventSource::PostTransaction( *this ,t );
+    }
+
+    CriticalSection::Guard guard(m_syncCs);
+
+    bool changed = baseline || seen != m_syncSeen || lastBlock != m_syncBlock;
+
+    m_syncSeen = seen;
+    m_syncBlock = lastBlock;
+    m_syncTime = time(NullPtr);
+
+    if( changed ) SaveSync();
+}
+
+//////////////////////////////////////////////////////////////////////////////
 IAPI_DEF CWalletBitcoinBase::getTransaction( const char *address ,const char *transactionId ,WalletTransaction &transaction ) {
     const String txid = transactionId;
+
+    //! @note confirmations only change with a new block
+    { CriticalSection::Guard guard(m_cacheCs);
+
+        auto cached = m_transactions.find( txid );
+
+        if( cached != m_transactions.end() && cached->second.time + getCacheMaxAge() > time(NullPtr) ) {
+            transaction = cached->second.transaction;
+            return IOK;
+        }
+    }
+
     gettransaction_t tx;
 
     iresult_t result = CallDaemon( core() ,[&txid,&tx]( CCoreBitcoinBase &core ,BitcoinRPC &api ){
@@ -281,6 +535,10 @@ IAPI_DEF CWalletBitcoinBase::getTransaction( const char *address ,const char *tr
         transaction.toAddress = it->address;
     }
 
+    CriticalSection::Guard guard(m_cacheCs);
+
+    m_transactions[txid] = { transaction ,time(NullPtr) };
+
     return IOK;
 }
 
@@ -324,11 +582,165 @@ IAPI_DEF CWalletBitcoinBase::sendToAddress( WalletTransaction &transaction ) {
 
     result = CallDaemon( core() ,lambda ); IF_IFAILED_RETURN(result);
 
+    invalidateCache(); //! @note balance changed
+
     transaction.txid = txid;
 
     return IOK;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//! CChainBitcoinBase
+
+CChainBitcoinBase::CChainBitcoinBase( CCoreBitcoinBase &core ,IServiceSetupRef &setup ) :
+    CChainService(setup) ,m_core(core) ,m_infoTime(0)
+{
+    m_info = { "" ,0 ,0. ,0. ,0. ,0. ,0. };
+}
+
+ref_t CChainBitcoinBase::AddRef() { return m_core.AddRef(); }
+ref_t CChainBitcoinBase::Release() { return m_core.Release(); }
+
+IAPI_DEF CChainBitcoinBase::getCoin( String &coin ) {
+    return m_core.getCoin(coin);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///-- IService
+
+IAPI_DEF CChainBitcoinBase::Start( const Params &params ) {
+    if( m_core.state() != serviceStarted )
+        return m_core.Start(params);
+
+    String coin; getCoin(coin);
+
+    getNotifyListener().Subscribe( coin.c_str() ,*this );
+
+    return CChainService::Start( params );
+}
+
+IAPI_DEF CChainBitcoinBase::Stop( const Params &params ) {
+    if( m_core.state() == serviceConnected )
+        return m_core.Stop(params);
+
+    String coin; getCoin(coin);
+
+    getNotifyListener().Revoke( coin.c_str() ,*this );
+
+    m_infoTime = 0;
+
+    return CChainService::Stop( params );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///-- IChain
+
+#define CHAIN_HASH_PER_DIFF     4294967296. //! 2^32, work of a difficulty 1 block
+
+IAPI_DEF CChainBitcoinBase::getInfo( const char *coin ,ChainInfo &info ,ChainInfoFlags flags ) {
+    String chainCoin; getCoin(chainCoin);
+
+    if( !coin || stricmp( coin ,chainCoin.c_str() ) != 0 )
+        return IBADARGS;
+
+    //! @note daemon pushes new blocks, info from last query is current
+    time_t now = time(NullPtr);
+
+    if( m_infoTime != 0 && (core().isNotifying() || m_infoTime + CHAIN_INFO_MAXAGE > now) ) {
+        info = m_info;
+        return IOK;
+    }
+
+    ChainInfo chainInfo = m_info;
+
+    bool syncing = false;
+
+    //! @note all statistics in a single round trip
+    auto lambda = [&chainInfo,&syncing]( CCoreBitcoinBase &core ,BitcoinRPC &api ){
+        bitcoinrpc::BatchCall calls;
+        bitcoinrpc::BatchResponse responses;
+
+        Json::Value templateParams ,templateRequest ,rules;
+
+        rules.append( "segwit" );
+        templateRequest["rules"] = rules;
+        templateParams.append( templateRequest );
+
+        int miningId = calls.addCall( "getmininginfo" ,Json::Value() );
+        int hashpsId = calls.addCall( "getnetworkhashps" ,Json::Value() );
+        int blockchainId = calls.addCall( "getblockchaininfo" ,Json::Value() );
+        int templateId = calls.addCall( "getblocktemplate" ,templateParams );
+
+        api.sendbatch( calls ,responses );
+
+        Json::Value mining = responses.getResult( miningId );
+        Json::Value blockchain = responses.getResult( blockchainId );
+
+        chainInfo.blockHeight = mining["blocks"].asInt64();
+        chainInfo.networkDiff = mining["difficulty"].asDouble();
+        chainInfo.networkHPS = responses.getResult( hashpsId ).asDouble();
+
+        syncing = blockchain["initialblockdownload"].asBool();
+
+        //! @note template unavailable while syncing or without peers, keeping previous reward
+        if( responses.getErrorCode( templateId ) != 0 )
+            return;
+
+        Json::Value gbt = responses.getResult( templateId );
+
+        //! @note miner share, as in the block template we mine (founder and smartnode payments excluded)
+        int64_t reward = gbt["coinbasevalue"].asInt64();
+
+        if( gbt.isMember("founder_payments_started") && gbt.isMember("founder") ) {
+            reward -= gbt["founder"]["amount"].asInt64();
+        }
+
+        if( gbt.isMember("smartnode_payments_started") && gbt.isMember("smartnode") ) {
+            for( auto &smartnode : gbt["smartnode"] ) {
+                reward -= smartnode["amount"].asInt64();
+            }
+        }
+
+        chainInfo.blockReward = (double) reward / 100000000.;
+    };
+
+    IRESULT result = CallDaemon( core() ,lambda ); IF_IFAILED_RETURN(result);
+
+    //! @note chain tip is not current while syncing, statistics would be misleading
+    if( syncing )
+        return INODATA;
+
+    chainInfo.name = chainCoin;
+
+    if( chainInfo.networkDiff > 0 ) {
+        chainInfo.blockPerHour = 3600. * chainInfo.networkHPS / (chainInfo.networkDiff * CHAIN_HASH_PER_DIFF);
+    }
+
+    chainInfo.price = 0;
+
+    chainInfo.timestamp = now;
+    chainInfo.fields = blockHeight | currentDiff | networkHPS | secondsPerBlock | (chainInfo.blockReward > 0 ? blockReward : 0);
+
+    m_info = chainInfo;
+    m_infoTime = now;
+
+    info = m_info;
+
+    return IOK;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///-- notify
+
+void CChainBitcoinBase::onNotify( const NotifyEvent &event ) {
+    if( event.type == notifyBlock ) {
+        m_infoTime = 0; //! @note refreshed on next query
+
+        getChainRefresher().Invalidate( *this );
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 //! Chain
@@ -365,7 +777,7 @@ String &makeDaemonArgSwitch( String &s ,const char *arg ,const char *value=NullP
     s = "-"; s += arg; if( value ) s = s + '=' + value; return s;
 }
 
-void makeDaemonArguments( const Params &params ,ListOf<String> &argv ) {
+void makeDaemonArguments( const Params &params ,const char *coin ,ListOf<String> &argv ) {
 
     //-- get fields
     String filename; getDaemonFilepath(params,filename);
@@ -384,6 +796,13 @@ void makeDaemonArguments( const Params &params ,ListOf<String> &argv ) {
     argv.emplace_back( makeDaemonArgSwitch(s,"rpcuser",rpcuser) );
     argv.emplace_back( makeDaemonArgSwitch(s,"rpcpassword",rpcpass) );
 
+    //-- notify hooks
+    String walletHook = getNotifyListener().makeHookCommand( notifyWallet ,coin );
+    String blockHook = getNotifyListener().makeHookCommand( notifyBlock ,coin );
+
+    if( !walletHook.empty() ) argv.emplace_back( makeDaemonArgSwitch(s,"walletnotify",walletHook.c_str()) );
+    if( !blockHook.empty() ) argv.emplace_back( makeDaemonArgSwitch(s,"blocknotify",blockHook.c_str()) );
+
     //-- make args
     StringStream ss(args);
 
@@ -429,7 +848,9 @@ IAPI_DEF CCoreBitcoinBase::StartDaemon( const char *name ,const Params &params )
 
     ListOf<String> args;
 
-    makeDaemonArguments( params ,args ); if( args.size() > MAX_ARGS ) return IBADARGS;
+    String coin; getCoin(coin);
+
+    makeDaemonArguments( params ,coin.c_str() ,args ); if( args.size() > MAX_ARGS ) return IBADARGS;
 
     //TODO proper check of args from file
     const char *argv[MAX_ARGS]; // = (const char**) malloc( args.size() * sizeof(char*) );
@@ -442,6 +863,8 @@ IAPI_DEF CCoreBitcoinBase::StartDaemon( const char *name ,const Params &params )
     if( OsProcessRun( &m_hprocess ,argv[0] ,argv ,NullPtr ) != ENOERROR )
         return IERROR;
 
+    m_notifying = getNotifyListener().isOpen();
+
     return IOK;
 }
 
@@ -459,11 +882,38 @@ IAPI_DEF CCoreBitcoinBase::StopDaemon( const Params &params ) {
 
     iresult_t result = CallDaemon( *this ,lambda ); IF_IFAILED_RETURN(result);
 
+    getCoreProbe().Cancel( *this );
+
+    m_rpc.Reset();
+
+    m_notifying = false;
+
     OsHandleDestroy( &m_hprocess ); //TODO, or get process info instead to decide if we need to kill
 
     return IOK;
 }
 
+IAPI_DEF CCoreBitcoinBase::ProbeDaemon() {
+    bool warmup = false;
+
+    auto lambda = [&warmup]( CCoreBitcoinBase &core ,BitcoinRPC &api ){
+        Json::Value params ,result;
+
+        try {
+            api.sendcommand( "getblockchaininfo" ,params ,result );
+        }
+        catch( BitcoinRpcException &e ) {
+            if( e.getCode() != CORE_RPC_IN_WARMUP ) throw;
+
+            warmup = true; //! @note daemon is up, still loading
+        }
+    };
+
+    IRESULT result = CallDaemon( *this ,lambda ); IF_IFAILED_RETURN(result);
+
+    return warmup ? IPROGRESS : IOK;
+}
+
 ///-- helpers
 IAPI_DEF CCoreBitcoinBase::ConnectAndStartDaemon( const char *name ,const Params &params ) {
     iresult_t result = ConnectDaemon( name ,params );
@@ -475,17 +925,23 @@ IAPI_DEF CCoreBitcoinBase::ConnectAndStartDaemon( const char *name ,const Params
         //! start daemon
         m_startTime = time(NULL);
 
-        ///? //! @note ignoring daemon start result, service is trying to connect either way
-        result = StartDaemon( name ,params ); IF_IFAILED_RETURN(result);
+        result = StartDaemon( name ,params );
+
+        if( result != IALREADY ) IF_IFAILED_RETURN(result);
+
+        //! @note daemon just launched, already running daemon is being probed since its launch
+        if( result == IOK ) getCoreProbe().Probe( *this );
 
         setState(serviceConnecting);
 
-        //! retry
-        result = ConnectDaemon( name ,params ); IF_IFAILED_RETURN(result);
+        //! @note not waiting for daemon, probe advises when it answers
+        return IPROGRESS;
     }
 
     setState(serviceConnected);
 
+    getCoreProbe().Advise( *this );
+
     return IOK;
 }
 
@@ -9,11 +9,17 @@
 
 //////////////////////////////////////////////////////////////////////////////
 #include <common/common.h>
+#include <common/notify.h>
 #include <coins/cores.h>
 
 #include <wallets/wallets.h>
 #include <chains/chains.h>
 
+//////////////////////////////////////////////////////////////////////////////
+class BitcoinRPC;
+
+struct transactioninfo_t;
+
 //////////////////////////////////////////////////////////////////////////////
 namespace solominer {
 
@@ -24,7 +30,11 @@ class CCoreBitcoinBase;
 //////////////////////////////////////////////////////////////////////////////
 //! Wallet
 
-class CWalletBitcoinBase : public CWalletService {
+#define WALLET_SYNC_CONFIRMATIONS   6 //! sync cursor depth, IE deepest reorg covered
+#define WALLET_SYNC_MAXAGE          60 //! s, max age of cached balance and transactions when daemon notifies
+#define WALLET_SYNC_POLL            10 //! s, same when daemon does not notify
+
+class CWalletBitcoinBase : public CWalletService ,public INotifyEvents {
 
     template <class TWallet ,class TChain>
     friend class CCoreBitcoinBase_;
@@ -32,11 +42,33 @@ class CWalletBitcoinBase : public CWalletService {
 protected:
     CCoreBitcoinBase &m_core; //! parent daemon core service
 
-    int m_initialTxTime; //! latest transaction time as first seen when running the wallet
+    ///-- transaction sync
+    CriticalSection m_syncCs;
+
+    String m_syncBlock; //! listsinceblock cursor, block at sync depth as of last sync
+    time_t m_syncTime; //! time of last sync
+
+    MapOf<String,int> m_syncSeen; //! transactions already posted and still within sync window -> confirmations
+    bool m_syncLoaded;
+
+    struct SyncResult; //! from sync thread, until published
+    PtrOf<SyncResult> m_synced;
+
+    ///-- cache
+    WalletBalanceCache m_balance; //! as of last sync
+
+    struct CachedTransaction {
+        WalletTransaction transaction;
+        time_t time;
+    };
+
+    CriticalSection m_cacheCs; //! @note transactions are queried from main and broker threads
+
+    MapOf<String,CachedTransaction> m_transactions; //! txid -> transaction as of last query
 
 public:
     CWalletBitcoinBase( CCoreBitcoinBase &core ,IServiceSetupRef &setup ) : CWalletService(setup)
-        ,m_core(core) ,m_initialTxTime(0)
+        ,m_core(core) ,m_syncTime(0) ,m_syncLoaded(false)
     {}
 
     API_IMPL(ref_t) AddRef() IOVERRIDE;
@@ -75,40 +107,75 @@ public: ///-- IWallet
     IAPI_IMPL getTransaction( const char *address ,const char *transactionId ,WalletTransaction &transaction ) IOVERRIDE;
     IAPI_IMPL sendToAddress( WalletTransaction &transaction ) IOVERRIDE;
 
+public: ///-- CWalletService
+    //! @note balance is cached right away, incoming transactions are posted when published
+    IAPI_IMPL Sync() IOVERRIDE;
+
+    API_IMPL(void) adviseSynced() IOVERRIDE;
+
 public: ///-- bitcoin api
 
+public: ///-- INotifyEvents
+    void onNotify( const NotifyEvent &event ) override;
+
+protected: ///-- cache
+    time_t getCacheMaxAge();
+
+    void invalidateCache();
+
+protected: ///-- transaction sync
+    String getSyncFilename();
+
+    void LoadSync();
+    void SaveSync();
+
+    //! @note post transactions not seen yet exactly once, then advance cursor to lastBlock
+    void SyncTransactions( const std::vector<transactioninfo_t> &txs ,const String &lastBlock ,bool rescan );
 };
 
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 //! Chain
 
-class CChainBitcoinBase : public CChainService {
+#define CHAIN_INFO_MAXAGE   30 //! s, max age of chain info when daemon does not notify blocks
+
+class CChainBitcoinBase : public CChainService ,public INotifyEvents {
 
     template <class TWallet ,class TChain>
     friend class CCoreBitcoinBase_;
 
 protected:
-    CCoreService &m_core;
+    CCoreBitcoinBase &m_core;
     // CoreConfig m_config;
 
+    ///-- chain info
+    ChainInfo m_info; //! as of last daemon query
+    std::atomic<time_t> m_infoTime; //! time of last query, 0 if none (or invalidated by a new block)
+
 public:
-    CChainBitcoinBase( CCoreService &core ,IServiceSetupRef &setup ) :
-        m_core(core) ,CChainService(setup)
-    {}
+    CChainBitcoinBase( CCoreBitcoinBase &core ,IServiceSetupRef &setup );
 
-    API_IMPL(ref_t) AddRef() IOVERRIDE { return m_core.AddRef(); }
-    API_IMPL(ref_t) Release() IOVERRIDE { return m_core.Release(); }
+    API_IMPL(ref_t) AddRef() IOVERRIDE;
+    API_IMPL(ref_t) Release() IOVERRIDE;
 
-    const CCoreService &core() const { return m_core; }
+    const CCoreBitcoinBase &core() const { return m_core; }
     // const CoreConfig &config() const { return m_config; }
 
-    CCoreService &core() { return m_core; }
+    CCoreBitcoinBase &core() { return m_core; }
 
 public: ///-- CChainBitcoinBase
-    IAPI_DECL getCoin( String &coin ) {
-        return m_core.getCoin(coin);
-    }
+    IAPI_DECL getCoin( String &coin );
+
+public: ///-- IService
+    IAPI_IMPL Start( const Params &params ) IOVERRIDE;
+    IAPI_IMPL Stop( const Params &params ) IOVERRIDE;
+
+public: ///-- IChain
+    //! @note mining statistics from daemon, price is not known to chain (left 0)
+    IAPI_IMPL getInfo( const char *coin ,ChainInfo &info ,ChainInfoFlags flags ) IOVERRIDE;
+
+public: ///-- INotifyEvents
+    void onNotify( const NotifyEvent &event ) override;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -117,6 +184,59 @@ public: ///-- CChainBitcoinBase
 
 #define CORE_TIMEOUT_DEFAULT    10000
 
+#define CORE_RPC_TIMEOUT        1000 //! ms, per rpc call
+#define CORE_RPC_POOL_SIZE      4 //! max idle clients kept connected per daemon
+
+#define CORE_RPC_IN_WARMUP      -28 //! daemon error while loading (block index, wallet ...)
+
+/**
+ * @brief pool of long lived rpc clients to a daemon
+ * @note each client keeps its http connection alive between calls
+ * @note a connection failure drops the whole pool, next call reconnects
+ */
+
+class CCoreRpcPool {
+protected:
+    CriticalSection m_cs;
+
+    ListOf<BitcoinRPC*> m_idle; //! connected clients ready for use
+
+    String m_endpoint; //! clients connection (user@host:port)
+    int m_generation; //! bumped on reset, clients from previous generation are not reused
+
+public:
+    CCoreRpcPool() : m_generation(0)
+    {}
+
+    ~CCoreRpcPool() {
+        Reset();
+    }
+
+    //! @note client is leased for the duration of a call
+    struct Lease {
+        CCoreRpcPool &pool;
+
+        BitcoinRPC *client;
+        int generation;
+
+        bool healthy = true;
+
+        Lease( CCoreRpcPool &a_pool ,const CoreConfig &config ) : pool(a_pool) {
+            client = pool.Acquire( config ,generation );
+        }
+
+        ~Lease() {
+            pool.Release( client ,generation ,healthy );
+        }
+    };
+
+    BitcoinRPC *Acquire( const CoreConfig &config ,int &generation );
+    void Release( BitcoinRPC *client ,int generation ,bool healthy );
+
+    void Reset();
+};
+
+///--
 class CCoreBitcoinBase : public CCoreService {
 protected:
     Params m_params;
@@ -126,6 +246,10 @@ protected:
 
     OsHandle m_hprocess = OS_INVALID_HANDLE;
 
+    CCoreRpcPool m_rpc;
+
+    bool m_notifying = false; //! daemon was started with notify hooks
+
 public:
     CCoreBitcoinBase( IServiceSetupRef &coreSetup ) :
         CCoreService(coreSetup)
@@ -133,6 +257,11 @@ public:
 
     const Params &params() const { return m_params; }
 
+    CCoreRpcPool &rpc() { return m_rpc; }
+
+    //! @note wallet and block changes are pushed, no need to poll
+    bool isNotifying() const { return m_notifying && getNotifyListener().isOpen(); }
+
 public: ///-- CCoreBitcoinBase
     IAPI_DECL ConnectDaemon( const char *name ,const Params &params );
 
@@ -140,6 +269,8 @@ public: ///-- CCoreBitcoinBase
 
     IAPI_DECL StopDaemon( const Params &params );
 
+    IAPI_IMPL ProbeDaemon() IOVERRIDE;
+
     //-- helper
     IAPI_DECL ConnectAndStartDaemon( const char *name ,const Params &params );
 };
@@ -50,6 +50,147 @@ IAPI_DEF CCoreService::getInterface( PUID id ,void **ppv ) {
     ;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//! CCoreProbe
+
+void CCoreProbe::Probe( CCoreService &core ) {
+    String name; core.getName( name );
+
+    CriticalSection::Guard guard(m_cs);
+
+    Target &target = m_targets[name];
+
+    if( target.probing ) {
+        target.cancelled = false; //! @note probe in flight, keeps on
+    } else {
+        target.core = core;
+        target.probeAt = OsTimerNow() + CORE_PROBE_BACKOFF_MIN;
+        target.backoff = CORE_PROBE_BACKOFF_MIN;
+        target.ready = target.cancelled = false;
+    }
+
+    if( !m_running ) {
+        m_quit = false;
+        m_running = Thread::Start() == ENOERROR;
+    }
+}
+
+void CCoreProbe::Cancel( CCoreService &core ) {
+    String name; core.getName( name );
+
+    CriticalSection::Guard guard(m_cs);
+
+    auto it = m_targets.find( name );
+
+    if( it != m_targets.end() ) it->second.cancelled = true;
+}
+
+void CCoreProbe::Advise( CCoreService &core ) {
+    String name; core.getName( name );
+
+    CriticalSection::Guard guard(m_cs);
+
+    Target &target = m_targets[name];
+
+    if( !target.probing ) target.core = core;
+
+    target.ready = true;
+    target.cancelled = false;
+}
+
+void CCoreProbe::Subscribe( ICoreEvents &listener ) {
+    for( auto *it : m_subscribers ) {
+        if( it == &listener ) return;
+    }
+
+    m_subscribers.emplace_back( &listener );
+}
+
+void CCoreProbe::Revoke( ICoreEvents &listener ) {
+    for( auto it = m_subscribers.begin(); it != m_subscribers.end(); ) {
+        if( *it == &listener ) it = m_subscribers.erase( it ); else ++it;
+    }
+}
+
+int CCoreProbe::Dispatch() {
+    ListOf<CCoreServiceRef> ready;
+
+    { CriticalSection::Guard guard(m_cs);
+
+        for( auto it = m_targets.begin(); it != m_targets.end(); ) {
+            Target &target = it->second;
+
+            if( target.probing || !(target.ready || target.cancelled) ) {
+                ++it; continue;
+            }
+
+            if( target.ready && !target.cancelled ) ready.emplace_back( target.core );
+
+            it = m_targets.erase( it );
+        }
+    }
+
+    for( auto &core : ready ) {
+        core->adviseDaemonReady();
+
+        for( auto *listener : m_subscribers ) {
+            listener->onCoreReady( core.get() );
+        }
+    }
+
+    return (int) ready.size();
+}
+
+void CCoreProbe::Shutdown() {
+    if( !m_running ) return;
+
+    m_quit = true;
+
+    WaitFor();
+
+    m_running = false;
+}
+
+OsError CCoreProbe::Main() {
+    while( !m_quit ) {
+        Target *target = NullPtr;
+
+        { CriticalSection::Guard guard(m_cs);
+
+            OsTimerTime now = OsTimerNow();
+
+            for( auto &it : m_targets ) {
+                Target &t = it.second;
+
+                if( t.ready || t.cancelled || t.probeAt > now ) continue;
+
+                t.probing = true; target = &t; break;
+            }
+        }
+
+        if( !target ) {
+            OsSleep( CORE_PROBE_TICK ); continue;
+        }
+
+        IRESULT result = target->core->ProbeDaemon();
+
+        CriticalSection::Guard guard(m_cs);
+
+        target->probing = false;
+
+        if( result == IOK ) {
+            target->ready = true;
+        } else if( result == INOEXEC ) {
+            target->cancelled = true; //! @note core can't be probed
+        } else {
+            target->probeAt = OsTimerNow() + target->backoff;
+            target->backoff = MIN( target->backoff*2 ,CORE_PROBE_BACKOFF_MAX );
+        }
+    }
+
+    return ENOERROR;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //! CCoreSetupBase
 
@@ -82,6 +82,17 @@ public:
 
     const CoreConfig &config() const { return m_config; }
 
+public: ///-- CCoreService
+    //! @brief check if daemon answers rpc
+    //! @return IOK if ready, IPROGRESS if still loading, error if not reachable
+    //! @note called from probe thread
+    IAPI_DECL ProbeDaemon() { return INOEXEC; }
+
+    //! @note daemon answered probe
+    void adviseDaemonReady() {
+        if( state()==serviceStarted || state()==serviceConnecting ) setState(serviceConnected);
+    }
+
 public: ///-- ICore
     IAPI_IMPL getWallet( IWalletRef &wallet ) IOVERRIDE {
         return ENOEXEC;
@@ -94,6 +105,79 @@ public: ///-- ICore
 
 typedef RefOf<CCoreService> CCoreServiceRef;
 
+//////////////////////////////////////////////////////////////////////////////
+//! Core Probe
+
+#define CORE_PROBE_BACKOFF_MIN  250 //! ms, first probe after daemon start
+#define CORE_PROBE_BACKOFF_MAX  5000 //! ms
+#define CORE_PROBE_TICK         50 //! ms, probe thread idle sleep
+
+struct ICoreEvents {
+    //! @note daemon answers rpc, called on main thread
+    virtual void onCoreReady( CCoreService &core ) = 0;
+};
+
+/**
+ * @brief probe starting core daemons until they answer rpc
+ * @note all daemons are probed from a single thread while they load in parallel, with backoff per daemon
+ * @note ready cores are advised and published from main loop (Dispatch)
+ */
+
+class CCoreProbe : public Singleton_<CCoreProbe> ,protected Thread {
+protected:
+    struct Target {
+        CCoreServiceRef core;
+
+        OsTimerTime probeAt; //! ms, next probe
+        int backoff; //! ms, delay before next probe if not ready
+
+        bool probing = false; //! @note probe in progress, target can't be removed
+        bool ready = false;
+        bool cancelled = false;
+    };
+
+    CriticalSection m_cs;
+
+    MapOf<String,Target> m_targets; //! core name -> target
+
+    ListOf<ICoreEvents*> m_subscribers;
+
+    volatile bool m_running;
+    volatile bool m_quit;
+
+public:
+    CCoreProbe() : m_running(false) ,m_quit(false)
+    {}
+
+    ~CCoreProbe() {
+        Shutdown();
+    }
+
+public:
+    //! @brief probe core until its daemon answers (again)
+    void Probe( CCoreService &core );
+    void Cancel( CCoreService &core );
+
+    //! @brief core found ready other than by probe, published on next dispatch
+    void Advise( CCoreService &core );
+
+    void Subscribe( ICoreEvents &listener );
+    void Revoke( ICoreEvents &listener );
+
+    //! @brief advise and publish cores found ready, from main thread
+    //! @return number of cores ready
+    int Dispatch();
+
+    void Shutdown();
+
+protected:
+    OsError Main() override;
+};
+
+inline CCoreProbe &getCoreProbe() {
+    return CCoreProbe::getInstance();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //! Core Setup
 
@@ -7,6 +7,8 @@
 
 #include "book.h"
 
+#include <chrono>
+
 //////////////////////////////////////////////////////////////////////////////
 namespace solominer {
 
@@ -41,15 +43,39 @@ struct BookHeader {
     uint32_t nEntry; //! entry count
 
     byte user[44]; //! user info (e.g. for totals)
+
+    uint32_t firstId; //! id of first entry, entries before are in archived volumes
+        //! @note in former struct padding, 0 for books from before volumes
 };
 
 //////////////////////////////////////////////////////////////////////////////
 //! BookPage
 
 //TODO in common
-// typedef int32_t checksum32_t;
+typedef uint32_t checksum32_t;
 // typedef int64_t checksum64_t;
 
+//! @brief crc32 (ieee), continued from crc of previous bytes
+static checksum32_t checksum32( const byte *data ,size_t size ,checksum32_t crc=0 ) {
+    static checksum32_t table[256] = { 0 };
+
+    if( table[1] == 0 ) {
+        for( uint32_t i=0; i<256; ++i ) {
+            uint32_t c = i;
+
+            for( int k=0; k<8; ++k ) c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : (c >> 1);
+
+            table[i] = c;
+        }
+    }
+
+    crc = ~crc;
+
+    for( size_t i=0; i<size; ++i ) crc = table[ (crc ^ data[i]) & 0xFF ] ^ (crc >> 8);
+
+    return ~crc;
+}
+
 struct BookPage {
     typedef uint32_t offset_t;
     typedef uint16_t page_t;
@@ -112,6 +138,9 @@ bool isPageFull( const BookHeader &book ,const BookPage::Header &page ) {
 
 #define ENTRY_PER_PAGE      32 //! default entry count
 
+#define BOOK_MAP_ALIGN      (64*1024) //! file growth granularity, multiple of os pages (and windows allocation granularity)
+#define BOOK_MAP_HEADROOM   4 //! pages reserved ahead when growing
+
 struct PageInfo {
     BookPage::Header header;
 
@@ -119,24 +148,241 @@ struct PageInfo {
     size_t offset;
 };
 
+//////////////////////////////////////////////////////////////////////////////
+//! BookWal
+
+    //! @brief write ahead log of book writes, <filepath>.wal
+    //! @note records are redo images of written bytes, a group ends with a commit record
+    //! @note a group is written and flushed to disk at once, then only applied to book,
+    //!     book data is only flushed at checkpoint
+
+#define BOOK_WAL_MAGIC      "SMBKWAL"
+#define BOOK_WAL_VERSION    1
+#define BOOK_WAL_CHECKPOINT (1024*1024) //! wal size past which it is applied back to book
+
+struct BookWalHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+struct BookWalRecord {
+    enum Type : uint32_t {
+        walData=1 ,walZero ,walCommit
+    } type;
+
+    uint32_t size; //! bytes written (data follows for walData)
+    uint64_t offset; //! in book file
+
+    checksum32_t crc; //! of record with crc 0, then data
+    uint32_t reserved;
+};
+
+#define SIZEOF_WALHEADER    sizeof(BookWalHeader)
+#define SIZEOF_WALRECORD    sizeof(BookWalRecord)
+
+static int64_t getTimeMs() {
+    using namespace std::chrono;
+
+    return duration_cast<milliseconds>( steady_clock::now().time_since_epoch() ).count();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //! CBookFile (private)
 
+/**
+ * @note pages are fixed size and contiguous after book header, page and entry offsets are computed
+ * @note file is memory mapped when possible, growing by BOOK_MAP_ALIGN steps ahead of last page,
+ *      file is trimmed back to its last page on close
+ * @note writes are logged to the book wal, replayed on open if book was not closed properly
+ * @note logged writes are held in their group until it is durable in the wal, reads see them,
+ *      book file never holds uncommitted bytes the wal could not redo
+ */
+
 template<>
 struct Private_<CBookFile> {
-    explicit Private_<CBookFile>( CBookFile &a_book ) : book(a_book)
+    explicit Private_<CBookFile>( CBookFile &a_book ) : book(a_book) ,map(NullPtr) ,mapSize(0)
+        ,walSize(0) ,walSince(0)
     {}
 
     CBookFile &book;
 
     File &file() { return book.m_file; }
 
+//-- layout
+    size_t pageSize() const {
+        return SIZEOF_PAGEHEADER + (size_t) bookHeader.entryPerPage * bookHeader.sizeOfEntry + SIZEOF_PAGEFOOTER;
+    }
+
+    size_t pageOffset( int pageId ) const {
+        return SIZEOF_BOOKHEADER + (size_t) pageId * pageSize();
+    }
+
+    size_t entryOffset( entryid_t local ) const { //! @note index in current volume
+        size_t n = (size_t) bookHeader.entryPerPage;
+
+        return pageOffset( (int) (local / n) ) + SIZEOF_PAGEHEADER + (local % n) * bookHeader.sizeOfEntry;
+    }
+
+    size_t dataSize() const { //! @note end of last page
+        return pageOffset( (int) bookHeader.nPage );
+    }
+
+//-- mapping
+    bool Map() {
+        uint64_t size = file().GetSize();
+
+        if( size < dataSize() ) return false; //! @note truncated book
+
+        void *memory = NullPtr;
+
+        if( file().Map( 0 ,(size_t) size ,OS_MAP_READ | OS_MAP_WRITE ,&memory ) != ENOERROR )
+            return false;
+
+        map = (byte*) memory; mapSize = (size_t) size;
+
+        return true;
+    }
+
+    void Unmap() {
+        if( !map ) return;
+
+        File::Unmap( map ,mapSize );
+
+        map = NullPtr; mapSize = 0;
+    }
+
+    //! @brief make room up to size, remapping if needed
+    bool Reserve( size_t size ) {
+        if( !map ) return true; //! @note file grows with writes
+
+        if( size <= mapSize ) return true;
+
+        size_t grow = size + BOOK_MAP_HEADROOM * pageSize();
+
+        grow = ((grow + BOOK_MAP_ALIGN - 1) / BOOK_MAP_ALIGN) * BOOK_MAP_ALIGN;
+
+        Unmap();
+
+        if( file().SetSize( grow ) != ENOERROR )
+            return false;
+
+        return Map();
+    }
+
+    bool Sync() {
+        if( map ) return File::Sync( map ,mapSize ) == ENOERROR;
+
+        return file().Flush() == ENOERROR;
+    }
+
+    void Close() {
+        if( map ) {
+            Unmap();
+
+            file().SetSize( dataSize() ); //! @note no headroom left on disk
+        }
+    }
+
+    //! @note NullPtr if range has pending writes, read it instead
+    const byte *peek( size_t offset ,size_t size ) const {
+        return map && offset + size <= mapSize && !isPending( offset ,size ) ? map + offset : NullPtr;
+    }
+
+//-- access
+    bool readAt( size_t offset ,byte *data ,size_t size ) {
+        bool read;
+
+        if( map ) {
+            read = offset + size <= mapSize;
+
+            if( read ) memcpy( data ,map + offset ,size );
+        }
+        else {
+            read = file().Seek( offset ,SEEK_SET ) == ENOERROR && file().Read( data ,size ) == ENOERROR;
+        }
+
+        if( !read ) {
+            if( !isPending( offset ,size ) ) return false;
+
+            memset( data ,0 ,size ); //! @note page added in pending group, not in file yet
+        }
+
+        readPending( offset ,data ,size );
+
+        return true;
+    }
+
+    bool writeAt( size_t offset ,const byte *data ,size_t size ) {
+        if( map && offset + size > mapSize ) return false;
+
+        if( !wal.isOpen() ) return applyAt( offset ,data ,size );
+
+        logWrite( BookWalRecord::walData ,offset ,data ,size );
+
+        return true;
+    }
+
+    //! @brief write to book file, data NullPtr for zeros
+    bool applyAt( size_t offset ,const byte *data ,size_t size ) {
+        if( map ) {
+            if( offset + size > mapSize ) return false;
+
+            if( data ) memcpy( map + offset ,data ,size ); else memset( map + offset ,0 ,size );
+
+            return true;
+        }
+
+        Bytes z( 0 ,data ? 0 : size );
+
+        return file().Seek( offset ,SEEK_SET ) == ENOERROR && file().Write( data ? data : z.ptr() ,size ) == ENOERROR;
+    }
+
+//-- pending
+    struct Pending {
+        size_t offset;
+        size_t size;
+        size_t at; //! data in wal group, npos for zeros
+    };
+
+    bool isPending( size_t offset ,size_t size ) const {
+        for( auto &it : pending ) {
+            if( it.offset < offset + size && offset < it.offset + it.size ) return true;
+        }
+
+        return false;
+    }
+
+    //! @brief overlay pending writes on data read from book, in write order
+    void readPending( size_t offset ,byte *data ,size_t size ) const {
+        for( auto &it : pending ) {
+            size_t a = MAX( offset ,it.offset ) ,b = MIN( offset + size ,it.offset + it.size );
+
+            if( a >= b ) continue;
+
+            if( it.at == String::npos ) memset( data + (a - offset) ,0 ,b - a );
+            else memcpy( data + (a - offset) ,walGroup.data() + it.at + (a - it.offset) ,b - a );
+        }
+    }
+
+    bool applyPending() {
+        bool result = true;
+
+        for( auto &it : pending ) {
+            result = applyAt( it.offset ,it.at == String::npos ? NullPtr : walGroup.data() + it.at ,it.size ) && result;
+        }
+
+        pending.clear();
+
+        return result;
+    }
+
 //--
     bool addPage( PageInfo &page ) {
         BookPage::Footer footer;
 
         page.pageId = (int) bookHeader.nPage;
-        page.offset = (size_t) file().GetSize();
+        page.offset = pageOffset( page.pageId );
 
         size_t bodySize = bookHeader.sizeOfEntry * bookHeader.entryPerPage;
         size_t bodyOffset = page.offset + SIZEOF_PAGEHEADER;
@@ -145,144 +391,263 @@ struct Private_<CBookFile> {
         page.header.footer = footerOffset;
         page.header.nEntry = 0;
 
-        footer.header = page.offset;
+        footer.header = (BookPage::offset_t) page.offset;
+
+        if( !Reserve( footerOffset + SIZEOF_PAGEFOOTER ) )
+            return false;
 
         ++ bookHeader.nPage;
 
         return
-            writePageHeader( page.pageId ,page.offset ,page.header )
+            writePageHeader( page.offset ,page.header )
             && writePageBody( bodyOffset ,bodySize )
             && writePageFooter( footerOffset ,footer )
             && writeBookHeader()
         ;
     }
 
-    bool findPage( int pageId ,PageInfo &page ) {
-        if( !findPageStart( pageId ,page ) ) return false;
+    bool getPage( int pageId ,PageInfo &page ) {
+        if( pageId < 0 || pageId >= (int) bookHeader.nPage ) return false;
 
-        int n = pageId - page.pageId;
+        page.pageId = pageId;
+        page.offset = pageOffset( pageId );
 
-        if( n > 0 ) {
-            while( page.pageId != pageId && flickPageForward( page ) ) {}
-        } else {
-            while( page.pageId != pageId && flickPageBackward( page ) ) {}
-        }
+        return readPageHeader( page.offset ,page.header );
+    }
 
-        return true;
+//-- book
+    bool readBookHeader() {
+        return readAt( 0 ,(byte*) &bookHeader ,SIZEOF_BOOKHEADER );
     }
 
-    bool findPageStart( int pageId ,PageInfo &page ) {
-        if( pageId == 0 ) return getFirstPage(page);
+    bool writeBookHeader() {
+        return writeAt( 0 ,(const byte*) &bookHeader ,SIZEOF_BOOKHEADER );
+    }
 
-        //-- closest in cache
-        page.pageId = -1;
+//-- page
+    bool readPageHeader( size_t atOffset ,BookPage::Header &header ) {
+        return readAt( atOffset ,(byte*) &header ,SIZEOF_PAGEHEADER );
+    }
 
-        pageHeaders.eachItem( [pageId,&page]( int id ,PageInfo &info ) -> bool {
-            if( abs(pageId-id) < abs(page.pageId-id) ) {
-                page = info;
-            }
+    bool writePageHeader( size_t atOffset ,const BookPage::Header &header ) {
+        return writeAt( atOffset ,(const byte*) &header ,SIZEOF_PAGEHEADER );
+    }
 
-            return page.pageId != pageId;
-        });
+    bool writePageFooter( size_t atOffset ,const BookPage::Footer &footer ) {
+        return writeAt( atOffset ,(const byte*) &footer ,SIZEOF_PAGEFOOTER );
+    }
 
-        if( page.pageId >= 0 )
-            return true;
+    bool writePageBody( size_t atOffset ,size_t size ) {
+        if( map && atOffset + size > mapSize ) return false;
+
+        if( !wal.isOpen() ) return applyAt( atOffset ,NullPtr ,size );
 
-        //-- first or last
-        int n = bookHeader.nPage;
+        logWrite( BookWalRecord::walZero ,atOffset ,NullPtr ,size );
 
-        return (pageId < (n - pageId) ) ? getFirstPage( page ) : getLastPage( page );
+        return true;
     }
 
-    bool getFirstPage( PageInfo &page ) {
-        page.pageId = 0;
-        page.offset = SIZEOF_BOOKHEADER;
+//-- wal
+    String walpath() const { return book.m_filepath + ".wal"; }
 
-        return readPageHeader( page.pageId ,page.offset ,page.header );
-    }
+    bool OpenWal() {
+        BookWalHeader header;
 
-    bool getLastPage( PageInfo &page ) {
-        page.pageId = (int) bookHeader.nPage;
-        page.offset = (size_t) file().GetSize();
+        memset( &header ,0 ,SIZEOF_WALHEADER );
+        memcpy( header.magic ,BOOK_WAL_MAGIC ,sizeof(BOOK_WAL_MAGIC) );
+        header.version = BOOK_WAL_VERSION;
 
-        return flickPageBackward( page );
-    }
+        if( wal.Open( walpath().c_str() ,OS_ACCESS_ALL ,OS_SHARE_READ ,OS_CREATE_ALWAYS ) != ENOERROR )
+            return false; //! @note book then flushes on each commit
 
-    bool flickPageForward( PageInfo &page ) {
-        if( page.header.nEntry < bookHeader.entryPerPage ) return false;
+        if( wal.Write( (const byte*) &header ,SIZEOF_WALHEADER ) != ENOERROR || wal.Flush() != ENOERROR ) {
+            CloseWal(); return false;
+        }
 
-        ++page.pageId;
+        walSize = SIZEOF_WALHEADER; walGroup.clear(); pending.clear(); walSince = 0;
 
-        return readPageHeader( page.pageId ,page.offset = page.header.footer + SIZEOF_PAGEFOOTER ,page.header );
+        return true;
     }
 
-    bool flickPageBackward( PageInfo &page ) {
-        if( page.pageId == 0 ) return false;
+    //! @note wal is only removed once its content is in book
+    void CloseWal() {
+        if( !wal.isOpen() ) return;
 
-        --page.pageId;
+        bool applied = walGroup.empty() && walSize == SIZEOF_WALHEADER;
 
-        BookPage::Footer footer;
+        wal.Close();
 
-        return
-            readPageFooter( page.offset - SIZEOF_PAGEFOOTER ,footer )
-            && readPageHeader( page.pageId ,page.offset = footer.header ,page.header )
-        ;
-    }
+        if( applied ) OsFileDelete( walpath().c_str() );
 
-//-- book
-    bool readBookHeader() {
-        return file().Seek( 0 ,SEEK_SET ) == ENOERROR && file().Read( (byte*) &bookHeader ,SIZEOF_BOOKHEADER ) == ENOERROR;
+        walSize = 0; walGroup.clear(); pending.clear();
     }
 
-    bool writeBookHeader() {
-        return file().Seek( 0 ,SEEK_SET ) == ENOERROR && file().Write( (byte*) &bookHeader ,SIZEOF_BOOKHEADER ) == ENOERROR;
+    void logWrite( BookWalRecord::Type type ,size_t offset ,const byte *data ,size_t size ) {
+        if( !wal.isOpen() ) return;
+
+        BookWalRecord record;
+
+        memset( &record ,0 ,SIZEOF_WALRECORD );
+        record.type = type;
+        record.size = (uint32_t) size;
+        record.offset = (uint64_t) offset;
+
+        record.crc = checksum32( (const byte*) &record ,SIZEOF_WALRECORD );
+
+        if( type == BookWalRecord::walData ) record.crc = checksum32( data ,size ,record.crc );
+
+        if( walGroup.empty() ) walSince = getTimeMs();
+
+        walGroup.insert( walGroup.end() ,(const byte*) &record ,(const byte*) &record + SIZEOF_WALRECORD );
+
+        if( type == BookWalRecord::walCommit ) return;
+
+        pending.emplace_back( Pending{ offset ,size ,type == BookWalRecord::walData ? walGroup.size() : String::npos } );
+
+        if( type == BookWalRecord::walData ) walGroup.insert( walGroup.end() ,data ,data + size );
     }
 
-//-- page
-    bool readPageHeader( int pageId ,size_t atOffset ,BookPage::Header &header ) {
-        if( file().Seek( atOffset ,SEEK_SET ) == ENOERROR && file().Read( (byte*) &header ,SIZEOF_PAGEHEADER ) == ENOERROR ) {} else {
+    //! @brief write pending group to wal, if commit window elapsed or forced
+    bool Commit( int window ,bool force ) {
+        if( !wal.isOpen() ) return Sync();
+
+        if( walGroup.empty() ) return true;
+
+        if( !force && window > 0 && getTimeMs() - walSince < window ) return true; //! @note grouped with next writes
+
+        logWrite( BookWalRecord::walCommit ,0 ,NullPtr ,0 );
+
+        if( wal.Seek( walSize ,SEEK_SET ) != ENOERROR
+            || wal.Write( walGroup.data() ,walGroup.size() ) != ENOERROR
+            || wal.Flush() != ENOERROR
+        ) {
+            walGroup.resize( walGroup.size() - SIZEOF_WALRECORD ); //! @note group kept, retried on next commit
+
             return false;
         }
 
-        pageHeaders[pageId] = PageInfo({ header ,pageId ,atOffset });
+        walSize += walGroup.size();
 
-        return true;
+        //! @note group is durable, book may now hold it
+        bool applied = applyPending();
+
+        walGroup.clear();
+
+        if( !applied ) return false; //! @note redone from wal on next open
+
+        return walSize < BOOK_WAL_CHECKPOINT || Checkpoint();
     }
 
-    bool writePageHeader( int pageId ,size_t atOffset ,BookPage::Header &header ) {
-        if( file().Seek( atOffset ,SEEK_SET ) == ENOERROR && file().Write( (byte*) &header ,SIZEOF_PAGEHEADER ) == ENOERROR ) {} else {
+    //! @brief flush book data, wal restarts empty
+    bool Checkpoint() {
+        if( !wal.isOpen() || !walGroup.empty() ) return false;
+
+        if( !Sync() || wal.SetSize( SIZEOF_WALHEADER ) != ENOERROR )
             return false;
+
+        walSize = SIZEOF_WALHEADER;
+
+        return wal.Flush() == ENOERROR;
+    }
+
+    //! @brief replay committed groups left in wal onto book, before reading it
+    //! @note replay stops at first incomplete or corrupted record, later groups were never acknowledged
+    bool Recover() {
+        File log;
+
+        if( log.Open( walpath().c_str() ,OS_ACCESS_READ ,OS_SHARE_READ ,OS_CREATE_DONT ) != ENOERROR )
+            return true; //! @note no wal, book was closed properly
+
+        uint64_t size = log.GetSize() ,at = SIZEOF_WALHEADER;
+
+        BookWalHeader header;
+
+        bool valid = size >= SIZEOF_WALHEADER
+            && log.Read( (byte*) &header ,SIZEOF_WALHEADER ) == ENOERROR
+            && memcmp( header.magic ,BOOK_WAL_MAGIC ,sizeof(BOOK_WAL_MAGIC) ) == 0
+            && header.version == BOOK_WAL_VERSION
+        ;
+
+        ListOf<byte> group ,data;
+
+        bool result = true;
+
+        while( valid && at + SIZEOF_WALRECORD <= size ) {
+            BookWalRecord record;
+
+            if( log.Read( (byte*) &record ,SIZEOF_WALRECORD ) != ENOERROR ) break;
+
+            size_t dataSize = record.type == BookWalRecord::walData ? record.size : 0;
+
+            if( at + SIZEOF_WALRECORD + dataSize > size ) break;
+
+            data.resize( dataSize );
+
+            if( dataSize && log.Read( data.data() ,dataSize ) != ENOERROR ) break;
+
+            checksum32_t crc = record.crc; record.crc = 0;
+
+            if( checksum32( data.data() ,dataSize ,checksum32( (const byte*) &record ,SIZEOF_WALRECORD ) ) != crc ) break;
+
+            at += SIZEOF_WALRECORD + dataSize;
+
+            if( record.type == BookWalRecord::walCommit ) {
+                result = Replay( group ) && result; group.clear(); continue;
+            }
+
+            record.crc = crc;
+
+            group.insert( group.end() ,(const byte*) &record ,(const byte*) &record + SIZEOF_WALRECORD );
+            group.insert( group.end() ,data.begin() ,data.end() );
         }
 
-        pageHeaders[pageId] = PageInfo({ header ,pageId ,atOffset });
+        log.Close();
+
+        if( !result || file().Flush() != ENOERROR ) return false; //! @note wal kept for next open
+
+        OsFileDelete( walpath().c_str() );
 
         return true;
     }
 
-    bool readPageFooter( size_t atOffset ,BookPage::Footer &footer ) {
-        return file().Seek( atOffset ,SEEK_SET ) == ENOERROR && file().Read( (byte*) &footer ,SIZEOF_PAGEFOOTER ) == ENOERROR;
-    }
+    bool Replay( const ListOf<byte> &group ) {
+        for( size_t i=0; i<group.size(); ) {
+            BookWalRecord record;
 
-    bool writePageFooter( size_t atOffset ,BookPage::Footer &footer ) {
-        return file().Seek( atOffset ,SEEK_SET ) == ENOERROR && file().Write( (byte*) &footer ,SIZEOF_PAGEFOOTER ) == ENOERROR;
-    }
+            memcpy( &record ,group.data() + i ,SIZEOF_WALRECORD ); i += SIZEOF_WALRECORD;
 
-    bool writePageBody( size_t atOffset ,size_t size ) {
-        if( file().Seek( atOffset ,SEEK_SET ) != ENOERROR )
-            return false;
+            bool isData = record.type == BookWalRecord::walData;
+
+            Bytes z( 0 ,(size_t) (isData ? 0 : record.size) );
+
+            const byte *data = isData ? group.data() + i : z.ptr();
+
+            if( record.size == 0 ) continue;
 
-        Bytes z( 0 ,size );
+            if( file().Seek( (size_t) record.offset ,SEEK_SET ) != ENOERROR || file().Write( data ,record.size ) != ENOERROR )
+                return false;
 
-        return file().Write( z.ptr() ,size ) == ENOERROR;
+            if( isData ) i += record.size;
+        }
+
+        return true;
     }
 
 ///-- members
     BookHeader bookHeader;
 
-    Map_<int,PageInfo> pageHeaders; //! page headers location cache { pageId => offset }
-        //MAYBE use cache from pattern
+    byte *map; //! file mapping, NullPtr if not mapped
+    size_t mapSize;
+
+    File wal; //! not open if book writes are not logged
+    size_t walSize; //! committed wal bytes
+    ListOf<byte> walGroup; //! records pending commit
+    ListOf<Pending> pending; //! writes of group, not yet in book
+    int64_t walSince; //! ms, first pending record
 
-    // Bytes buffer; //! entry read/write buffers
+    String aside; //! file being recreated aside, empty if none
+    BookMode asideMode; //! of book being replaced
+    int asideSize;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -290,12 +655,12 @@ struct Private_<CBookFile> {
 
 CBookFile::CBookFile() :
     WithPrivate_<CBookFile>( new Private_<CBookFile>(*this) )
-    ,m_uuid( 0 ) ,m_sizeofEntry( 0 ) ,m_mode( bookText )
+    ,m_uuid( 0 ) ,m_sizeofEntry( 0 ) ,m_mode( bookText ) ,m_commitWindow( BOOK_COMMIT_WINDOW )
 {}
 
 CBookFile::CBookFile( PUID uuid ,int sizeofEntry ,BookMode mode ) :
     WithPrivate_<CBookFile>( new Private_<CBookFile>(*this) )
-    ,m_uuid( uuid ) ,m_sizeofEntry( sizeofEntry ) ,m_mode( mode )
+    ,m_uuid( uuid ) ,m_sizeofEntry( sizeofEntry ) ,m_mode( mode ) ,m_commitWindow( BOOK_COMMIT_WINDOW )
 {}
 
 CBookFile::~CBookFile() {
@@ -309,7 +674,7 @@ byte *CBookFile::getUserData( size_t &size ) {
 }
 
 bool CBookFile::updateUserData() {
-    return priv().writeBookHeader() && m_file.Flush() == ENOERROR;
+    return priv().writeBookHeader() && Sync();
 }
 
 bool CBookFile::setUserData( byte *data ,size_t size ) {
@@ -340,8 +705,75 @@ IRESULT CBookFile::makeFilepath( const char *title ,const char *path ) {
 }
 
 //--
+IRESULT CBookFile::makeVolumeFilepath( const char *volume ,String &filepath ) const {
+    if( volume && *volume && strlen(volume) < 31 ) {} else return IBADARGS;
+
+    size_t n = m_filepath.size();
+
+    if( n < 5 || m_filepath.compare( n-5 ,5 ,".book" ) != 0 ) return IBADENV;
+
+    filepath = m_filepath.substr( 0 ,n-5 );
+    filepath += ".";
+    filepath += volume;
+    filepath += ".vol";
+
+    return IOK;
+}
+
 IRESULT CBookFile::Archive( const char *volume ,entryid_t untilId ) {
-    _TODO; return INOEXEC; //TODO
+    if( !m_file.isOpen() ) return IBADENV;
+
+    entryid_t first = getFirstEntryId() ,end = (entryid_t) getEntryCount();
+
+    untilId = MIN( untilId ,end );
+
+    if( untilId <= first ) return INODATA;
+
+    String filepath;
+
+    IRESULT result = makeVolumeFilepath( volume ,filepath ); IF_IFAILED_RETURN(result);
+
+    if( !Sync( true ) ) return IERROR;
+
+//-- archived entries
+    result = CBookVolume::Write( filepath.c_str() ,volume ,*this ,first ,untilId ); IF_IFAILED_RETURN(result);
+
+//-- entries left in current volume
+    size_t size = m_sizeofEntry;
+
+    ListOf<byte> entries( (size_t) (end - untilId) * size );
+
+    for( entryid_t id=untilId; id<end; ++id ) {
+        if( !readEntry( id ,entries.data() + (id - untilId) * size ,size ) ) {
+            OsFileDelete( filepath.c_str() ); return IBADDATA;
+        }
+    }
+
+    result = Recreate( m_mode ,m_sizeofEntry );
+
+    if( IFAILED(result) ) {
+        OsFileDelete( filepath.c_str() ); return result;
+    }
+
+    priv().bookHeader.firstId = untilId;
+
+    bool written = priv().writeBookHeader();
+
+    for( size_t i=0; written && i<entries.size(); i+=size ) {
+        written = addEntry( entries.data() + i ,size ) != INVALID_ENTRY_VALUE;
+    }
+
+    result = written ? Replace() : IERROR;
+
+    if( IFAILED(result) ) {
+        if( !written ) Discard(); //! @note previous book open again, with all its entries
+
+        OsFileDelete( filepath.c_str() ); return result;
+    }
+
+    OsFileDelete( (m_filepath + ".bak").c_str() ); //! @note all entries are in volume or current book
+
+    return IOK;
 }
 
 IRESULT CBookFile::Create( const char *title ,const char *path ,PUID uuid ,int sizeofEntry ,BookMode mode ) {
@@ -365,7 +797,13 @@ IRESULT CBookFile::Create( const char *title ,const char *path ) {
     if( error != ENOERROR )
         return IERROR;
 
-    return makeBookHeader( title ) && priv().writeBookHeader() ? IOK : IERROR;
+    if( makeBookHeader( title ) && priv().writeBookHeader() ) {} else
+        return IERROR;
+
+    priv().Map(); //! @note falls back to file access if mapping fails
+    priv().OpenWal();
+
+    return IOK;
 }
 
 IRESULT CBookFile::Open( const char *title ,const char *path ,bool createIfNotExit ) {
@@ -375,40 +813,283 @@ IRESULT CBookFile::Open( const char *title ,const char *path ,bool createIfNotEx
 
     OsError error = m_file.Open( m_filepath.c_str() ,OS_ACCESS_ALL ,OS_SHARE_READ ,OS_CREATE_DONT );
 
+    String aside = m_filepath + ".new" ,backup = m_filepath + ".bak";
+
+    uint64_t size;
+
+    //! @note interrupted while replaced (see Replace), book moved to backup but aside not moved in yet
+    if( error != ENOERROR && OsFileGetSizeByName( aside.c_str() ,&size ) == ENOERROR
+        && OsFileMove( backup.c_str() ,m_filepath.c_str() ) == ENOERROR
+    ) {
+        error = m_file.Open( m_filepath.c_str() ,OS_ACCESS_ALL ,OS_SHARE_READ ,OS_CREATE_DONT );
+    }
+
+    OsFileDelete( aside.c_str() ); //! @note left from an interrupted Recreate or Replace
+
     if( error != ENOERROR ) { //! doesn't exist
         return createIfNotExit ? Create( title ,path ) : IERROR;
     }
 
+    if( !priv().Recover() ) {
+        m_file.Close(); return IBADDATA;
+    }
+
     if( m_file.GetSize() == 0 ) { //! exist but is empty
-        return makeBookHeader( title ) && priv().writeBookHeader() ? IOK : IERROR;
+        if( makeBookHeader( title ) && priv().writeBookHeader() ) {} else
+            return IERROR;
+    }
+    else if( priv().readBookHeader() && matchBookHeader(title) ) {} else {
+        return IERROR;
     }
 
-    return priv().readBookHeader() && matchBookHeader(title) ? IOK : IERROR;
+    priv().Map();
+    priv().OpenWal();
+
+    return IOK;
 }
 
 void CBookFile::Close() {
+    if( !m_file.isOpen() ) return;
+
+    if( Sync( true ) ) priv().Checkpoint();
+
+    priv().CloseWal();
+
+    priv().Close();
+
     m_file.Close();
 }
 
-///-- pages
-size_t CBookFile::getPageCount() const {
-    return priv().bookHeader.nPage;
+bool CBookFile::Sync( bool force ) {
+    return priv().Commit( m_commitWindow ,force );
 }
 
-bool CBookFile::getPageIndices( int pageId ,entryid_t &a ,entryid_t &b ) const {
+IRESULT CBookFile::Recreate( BookMode mode ,int sizeofEntry ) {
+    if( !m_file.isOpen() || !priv().aside.empty() ) return IBADENV;
+
+    if( sizeofEntry <= 0 ) return IBADARGS;
+
+    BookHeader previous = priv().bookHeader;
+
+    priv().asideMode = m_mode;
+    priv().asideSize = m_sizeofEntry;
+
+    Close();
+
+//-- new book aside, same identity
+    String aside = m_filepath + ".new";
+
+    if( m_file.Open( aside.c_str() ,OS_ACCESS_ALL ,OS_SHARE_READ ,OS_CREATE_ALWAYS ) != ENOERROR ) {
+        Reopen(); return IERROR;
+    }
+
+    priv().aside = aside;
+
+    m_mode = mode;
+    m_sizeofEntry = sizeofEntry;
+
+    if( !makeBookHeader( previous.title ) ) {
+        Discard(); return IERROR;
+    }
+
+    BookHeader &header = priv().bookHeader;
+
+    memcpy( header.volume ,previous.volume ,sizeof(header.volume) );
+    memcpy( header.user ,previous.user ,sizeof(header.user) );
+    header.udbn = previous.udbn;
+    header.firstId = previous.firstId;
+
+    m_volume = header.volume;
+    m_udbn = header.udbn;
+
+    if( !priv().writeBookHeader() ) {
+        Discard(); return IERROR;
+    }
+
+    priv().Map(); //! @note no wal, made durable as a whole by Replace
+
+    return IOK;
+}
+
+IRESULT CBookFile::Replace() {
+    String aside = priv().aside;
+
+    if( !m_file.isOpen() || aside.empty() ) return IBADENV;
+
+    if( !priv().Sync() ) {
+        Discard(); return IERROR;
+    }
+
+    priv().Close();
+    m_file.Close();
+
+    priv().aside.clear();
+
+//-- swap, previous kept as .bak
+    String backup = m_filepath + ".bak";
+
+    OsFileDelete( backup.c_str() );
+
+    if( OsFileMove( m_filepath.c_str() ,backup.c_str() ) != ENOERROR ) {
+        OsFileDelete( aside.c_str() );
+
+        IRESULT result = restoreAside();
+
+        return IFAILED(result) ? result : IERROR;
+    }
+
+    if( OsFileMove( aside.c_str() ,m_filepath.c_str() ) != ENOERROR ) {
+        OsFileMove( backup.c_str() ,m_filepath.c_str() );
+        OsFileDelete( aside.c_str() );
+
+        IRESULT result = restoreAside();
+
+        return IFAILED(result) ? result : IERROR;
+    }
+
+    if( ISUCCESS(Reopen()) ) return IOK;
+
+//-- previous book back
+    OsFileDelete( m_filepath.c_str() );
+
+    if( OsFileMove( backup.c_str() ,m_filepath.c_str() ) != ENOERROR )
+        return IERROR;
+
+    IRESULT result = restoreAside();
+
+    return IFAILED(result) ? result : IERROR;
+}
+
+IRESULT CBookFile::Discard() {
+    String aside = priv().aside;
+
+    if( aside.empty() ) return IBADENV;
+
+    priv().Close();
+
+    if( m_file.isOpen() ) m_file.Close();
+
+    priv().aside.clear();
+
+    OsFileDelete( aside.c_str() );
+
+    return restoreAside();
+}
+
+IRESULT CBookFile::restoreAside() {
+    m_mode = priv().asideMode;
+    m_sizeofEntry = priv().asideSize;
+
+    return Reopen();
+}
+
+IRESULT CBookFile::Reopen() {
+    if( m_file.Open( m_filepath.c_str() ,OS_ACCESS_ALL ,OS_SHARE_READ ,OS_CREATE_DONT ) != ENOERROR )
+        return IERROR;
+
+    if( !priv().Recover() || !priv().readBookHeader() || !matchBookHeader( m_title.c_str() ) ) {
+        m_file.Close(); return IBADDATA;
+    }
+
+    priv().Map();
+    priv().OpenWal();
+
+    return IOK;
+}
+
+//--
+#define BOOK_INDEX_MAGIC    "SMBKIDX"
+#define BOOK_INDEX_VERSION  1
+
+struct BookIndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nEntry; //! entry count indexes were saved with
+    guid_t udbn;
+};
+
+bool CBookFile::loadIndexes( ListOf<byte> &data ) {
+    String filepath = m_filepath + ".idx";
+
+    File file;
+
+    if( file.Open( filepath.c_str() ,OS_ACCESS_READ ,OS_SHARE_READ ,OS_CREATE_DONT ) != ENOERROR )
+        return false;
+
+    BookIndexHeader header;
+
+    uint64_t size = file.GetSize();
+
+    bool result = size >= sizeof(header) && file.Read( (byte*) &header ,sizeof(header) ) == ENOERROR;
+
+    if( result ) {
+        data.resize( (size_t) (size - sizeof(header)) );
+
+        result = data.empty() || file.Read( data.data() ,data.size() ) == ENOERROR;
+    }
+
+    file.Close();
+
+    OsFileDelete( filepath.c_str() ); //! @note until saved again on close
+
+    return result
+        && memcmp( header.magic ,BOOK_INDEX_MAGIC ,sizeof(BOOK_INDEX_MAGIC) ) == 0
+        && header.version == BOOK_INDEX_VERSION
+        && header.nEntry == (uint32_t) getEntryCount()
+        && memcmp( header.udbn ,m_udbn.data ,sizeof(guid_t) ) == 0
+    ;
+}
+
+bool CBookFile::saveIndexes( const ListOf<byte> &data ) {
+    String filepath = m_filepath + ".idx";
+
+    BookIndexHeader header;
+
+    memset( &header ,0 ,sizeof(header) );
+    memcpy( header.magic ,BOOK_INDEX_MAGIC ,sizeof(BOOK_INDEX_MAGIC) );
+    header.version = BOOK_INDEX_VERSION;
+    header.nEntry = (uint32_t) getEntryCount();
+    memcpy( header.udbn ,m_udbn.data ,sizeof(guid_t) );
+
+    File file;
+
+    if( file.Open( filepath.c_str() ,OS_ACCESS_ALL ,OS_SHARE_READ ,OS_CREATE_ALWAYS ) != ENOERROR )
+        return false;
+
+    bool result = file.Write( (const byte*) &header ,sizeof(header) ) == ENOERROR
+        && (data.empty() || file.Write( data.data() ,data.size() ) == ENOERROR)
+    ;
+
+    file.Close();
+
+    if( !result ) OsFileDelete( filepath.c_str() );
+
+    return result;
+}
+
+///-- pages
+size_t CBookFile::getPageCount() const {
+    return priv().bookHeader.nPage;
+}
+
+bool CBookFile::getPageIndices( int pageId ,entryid_t &a ,entryid_t &b ) const {
     if( pageId >= getPageCount() ) return false;
 
     size_t n = priv().bookHeader.entryPerPage;
 
-    a = n * (pageId / n);
+    a = priv().bookHeader.firstId + n * pageId;
     b = a + n-1;
 
     return true;
 }
 
 ///-- entries
+entryid_t CBookFile::getFirstEntryId() const {
+    return priv().bookHeader.firstId;
+}
+
 size_t CBookFile::getEntryCount() const {
-    return priv().bookHeader.nEntry;
+    return (size_t) priv().bookHeader.firstId + priv().bookHeader.nEntry;
 }
 
 entryid_t CBookFile::addEntry( const byte *entry ,size_t size ) {
@@ -419,21 +1100,30 @@ entryid_t CBookFile::addEntry( const byte *entry ,size_t size ) {
         return INVALID_ENTRY_VALUE;
 
 //-- write line
-    //! devnote may want to 0 pad entry write
-    if( m_file.Seek( offset ,SEEK_SET ) == ENOERROR && m_file.Write( entry ,size ) == ENOERROR ) {} else
-        return INVALID_ENTRY_VALUE;
-
-    return id;
+    //! @note new entry space is 0 filled by page creation
+    return priv().writeAt( offset ,entry ,size ) ? id : INVALID_ENTRY_VALUE;
 }
 
 bool CBookFile::readEntry( entryid_t id ,byte *entry ,size_t size ) {
     size_t offset;
 
+    if( id < getFirstEntryId() )
+        return getBookShelf().readArchived( *this ,id ,entry ,size );
+
     if( size > m_sizeofEntry || !getEntryOffset( id ,offset ) )
         return false;
 
 //-- read line
-    return m_file.Seek( offset ,SEEK_SET ) == ENOERROR && m_file.Read( entry ,size ) == ENOERROR;
+    return priv().readAt( offset ,entry ,size );
+}
+
+const byte *CBookFile::peekEntry( entryid_t id ) {
+    size_t offset;
+
+    if( !getEntryOffset( id ,offset ) )
+        return NullPtr;
+
+    return priv().peek( offset ,m_sizeofEntry );
 }
 
 bool CBookFile::writeEntry( entryid_t id ,const byte *entry ,size_t size ) {
@@ -444,7 +1134,7 @@ bool CBookFile::writeEntry( entryid_t id ,const byte *entry ,size_t size ) {
 
 //-- write line
     //! devnote may want to 0 pad entry write
-    return m_file.Seek( offset ,SEEK_SET ) == ENOERROR && m_file.Write( entry ,size ) == ENOERROR;
+    return priv().writeAt( offset ,entry ,size );
 }
 
 ///-- protected
@@ -458,7 +1148,7 @@ bool CBookFile::makeBookHeader( const char *title ) {
 //--
     BookHeader &header = priv().bookHeader;
 
-    memset( (byte*) &header ,0 ,SIZEOF_BOOKHEADER );
+    header = BookHeader();
 
     strncpy( header.title ,title ,32 );
     // header.volume; //! @note intentionally blank, for archives
@@ -481,9 +1171,10 @@ bool CBookFile::makeBookHeader( const char *title ) {
 bool CBookFile::matchBookHeader( const char *title ) {
     BookHeader &header = priv().bookHeader;
 
+    //! @note binary entries are size prefixed, a smaller book is upgraded once open
     if( strncmp( header.title ,title ,31 ) == 0
         && header.uuid == m_uuid
-        && header.sizeOfEntry >= m_sizeofEntry
+        && (header.sizeOfEntry >= m_sizeofEntry || header.mode == bookBinary)
     ) {} else {
         return false;
     }
@@ -505,19 +1196,27 @@ bool CBookFile::matchBookHeader( const char *title ) {
 bool CBookFile::makeNewEntry( entryid_t &id ,size_t &offset ) {
     BookHeader &header = priv().bookHeader;
 
+    int n = (int) header.entryPerPage;
+
+    if( n == 0 ) return false;
+
     PageInfo page;
 
-    if( ( priv().getLastPage( page ) && !isPageFull( header ,page.header ) ) || priv().addPage( page ) ) {} else {
+    entryid_t local = header.nEntry; //! @note in current volume
+
+    id = header.firstId + local;
+
+    int pageId = (int) (local / n);
+
+    if( ( pageId < (int) header.nPage && priv().getPage( pageId ,page ) ) || priv().addPage( page ) ) {} else {
         return false;
     }
 
-    assert(page.header.nEntry <= header.entryPerPage);
-
-    id = page.pageId + page.header.nEntry;
+    assert( page.pageId == pageId && page.header.nEntry == (local % n) );
 
     ++ page.header.nEntry;
 
-    if( !priv().writePageHeader( page.pageId ,page.offset ,page.header ) )
+    if( !priv().writePageHeader( page.offset ,page.header ) )
         return false;
 
     ++ header.nEntry;
@@ -525,34 +1224,483 @@ bool CBookFile::makeNewEntry( entryid_t &id ,size_t &offset ) {
     if( !priv().writeBookHeader() )
         return false; //! Yikes, book would be in some invalid state here
 
-    offset = page.offset + SIZEOF_PAGEHEADER + (page.header.nEntry-1) * m_sizeofEntry;
+    offset = priv().entryOffset( local );
 
     return true;
 }
 
 bool CBookFile::getEntryOffset( entryid_t id ,size_t &offset ) {
-    PageInfo page;
+    const BookHeader &header = priv().bookHeader;
 
-    int n = (int) priv().bookHeader.entryPerPage; //! IE n = entry per page
+    if( header.entryPerPage == 0 || id < header.firstId || id - header.firstId >= header.nEntry )
+        return false; //! @note entries are added in sequence, pages before last are full
 
-    if( n == 0 ) return false;
+    offset = priv().entryOffset( id - header.firstId );
 
-    int pageId = (int) (id / n);
+    return true;
+}
 
-    if( !priv().findPage( pageId ,page ) )
-        return false;
+//////////////////////////////////////////////////////////////////////////////
+//! CBookVolume
+
+#define BOOK_VOLUME_MAGIC   "SMBKVOL"
+#define BOOK_VOLUME_VERSION 1
+
+struct BookVolumeHeader {
+    char magic[8];
+    uint32_t version;
+    BookMode mode;
+
+    char title[32];
+    char label[32];
+
+    Udbn udbn; //! of archived book
+    PUID uuid;
+
+    int sizeOfEntry;
+
+    uint32_t firstId;
+    uint32_t nEntry;
+
+    checksum32_t crc; //! of offsets and entries
+};
+
+#define SIZEOF_VOLUMEHEADER sizeof(BookVolumeHeader)
+
+IRESULT CBookVolume::Write( const char *filepath ,const char *label ,CBookFile &book ,entryid_t from ,entryid_t to ) {
+    if( !filepath || !label || strlen(label) > 31 || to <= from ) return IBADARGS;
+
+    size_t n = to - from ,size = book.sizeofEntry();
+
+//-- pack entries, without trailing padding
+    ListOf<uint32_t> offsets( n+1 ,0 );
+    ListOf<byte> entries ,entry( size );
+
+    for( size_t i=0; i<n; ++i ) {
+        if( !book.readEntry( from + (entryid_t) i ,entry.data() ,size ) )
+            return IBADDATA;
+
+        size_t used = size;
+
+        while( used > 0 && entry[used-1] == 0 ) --used;
+
+        entries.insert( entries.end() ,entry.begin() ,entry.begin() + used );
+
+        offsets[i+1] = (uint32_t) entries.size();
+    }
 
-    int firstId = pageId * n; //! IE first id in page
+//-- header
+    BookVolumeHeader header{};
 
-    int i = (int) (id - firstId);
+    memcpy( header.magic ,BOOK_VOLUME_MAGIC ,sizeof(BOOK_VOLUME_MAGIC) );
+    header.version = BOOK_VOLUME_VERSION;
+    header.mode = book.bookmode();
 
-    if( i >= page.header.nEntry ) return false; //! id above entries in page
+    strncpy( header.title ,book.title() ,31 );
+    strncpy( header.label ,label ,31 );
 
-    offset = page.offset + SIZEOF_PAGEHEADER + (i) * m_sizeofEntry;
+    header.udbn = book.udbn();
+    header.uuid = book.uuid();
+
+    header.sizeOfEntry = (int) size;
+    header.firstId = from;
+    header.nEntry = (uint32_t) n;
+
+    header.crc = checksum32( (const byte*) offsets.data() ,offsets.size() * sizeof(uint32_t) );
+    header.crc = checksum32( entries.data() ,entries.size() ,header.crc );
+
+//-- write
+    File file;
+
+    if( file.Open( filepath ,OS_ACCESS_ALL ,OS_SHARE_READ ,OS_CREATE_NOEXIST ) != ENOERROR )
+        return IALREADY;
+
+    bool result = file.Write( (const byte*) &header ,SIZEOF_VOLUMEHEADER ) == ENOERROR
+        && file.Write( (const byte*) offsets.data() ,offsets.size() * sizeof(uint32_t) ) == ENOERROR
+        && (entries.empty() || file.Write( entries.data() ,entries.size() ) == ENOERROR)
+        && file.Flush() == ENOERROR
+    ;
+
+    file.Close();
+
+    if( !result ) {
+        OsFileDelete( filepath ); return IERROR;
+    }
+
+    return IOK;
+}
+
+IRESULT CBookVolume::Open( const char *filepath ) {
+    if( isOpen() ) return IALREADY;
+
+    if( m_file.Open( filepath ,OS_ACCESS_READ ,OS_SHARE_READ ,OS_CREATE_DONT ) != ENOERROR )
+        return INODATA;
+
+    uint64_t size = m_file.GetSize();
+
+    BookVolumeHeader header;
+
+    if( size < SIZEOF_VOLUMEHEADER || m_file.Read( (byte*) &header ,SIZEOF_VOLUMEHEADER ) != ENOERROR
+        || memcmp( header.magic ,BOOK_VOLUME_MAGIC ,sizeof(BOOK_VOLUME_MAGIC) ) != 0
+        || header.version != BOOK_VOLUME_VERSION
+        || size < SIZEOF_VOLUMEHEADER + ((uint64_t) header.nEntry + 1) * sizeof(uint32_t)
+    ) {
+        Close(); return IBADDATA;
+    }
+
+//-- content, mapped if possible
+    void *memory = NullPtr;
+
+    if( m_file.Map( 0 ,(size_t) size ,OS_MAP_READ ,&memory ) == ENOERROR ) {
+        m_map = (byte*) memory; m_mapSize = (size_t) size;
+    }
+    else {
+        m_data.resize( (size_t) size );
+
+        if( m_file.Seek( 0 ,SEEK_SET ) != ENOERROR || m_file.Read( m_data.data() ,m_data.size() ) != ENOERROR ) {
+            Close(); return IERROR;
+        }
+    }
+
+    const byte *p = m_map ? m_map : m_data.data();
+
+    size_t tableSize = ((size_t) header.nEntry + 1) * sizeof(uint32_t);
+
+    m_offsets = (const uint32_t*) (p + SIZEOF_VOLUMEHEADER);
+    m_entries = p + SIZEOF_VOLUMEHEADER + tableSize;
+
+    size_t entriesSize = (size_t) size - SIZEOF_VOLUMEHEADER - tableSize;
+
+    checksum32_t crc = checksum32( (const byte*) m_offsets ,tableSize );
+
+    if( m_offsets[header.nEntry] != entriesSize || checksum32( m_entries ,entriesSize ,crc ) != header.crc ) {
+        Close(); return IBADDATA;
+    }
+
+//-- info
+    header.label[31] = 0;
+
+    m_label = header.label;
+    m_mode = header.mode;
+    m_udbn = header.udbn;
+
+    m_firstId = header.firstId;
+    m_nEntry = header.nEntry;
+
+    return IOK;
+}
+
+void CBookVolume::Close() {
+    if( m_map ) File::Unmap( m_map ,m_mapSize );
+
+    m_map = NullPtr; m_mapSize = 0;
+
+    m_data.clear();
+
+    m_offsets = NullPtr; m_entries = NullPtr;
+    m_nEntry = 0;
+
+    if( m_file.isOpen() ) m_file.Close();
+}
+
+bool CBookVolume::readEntry( entryid_t id ,byte *entry ,size_t size ) {
+    if( !m_offsets || id < m_firstId || id >= endId() ) return false;
+
+    size_t i = id - m_firstId;
+
+    size_t a = m_offsets[i] ,b = m_offsets[i+1];
+
+    if( b < a || b - a > size ) return false;
+
+    memcpy( entry ,m_entries + a ,b - a );
+    memset( entry + (b - a) ,0 ,size - (b - a) );
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! CBookShelf
+
+CBookFile *CBookShelf::getBookByTitle( const char *title ) {
+    CriticalSection::Guard guard(m_cs);
+
+    for( auto &it : _catalog.map() ) {
+        CBookFile *book = it.second.book;
+
+        if( book && title && strcmp( book->title() ,title ) == 0 ) return book;
+    }
+
+    return NullPtr;
+}
+
+CBookFile *CBookShelf::getBookByUdbn( const Guid &udbn ) {
+    CriticalSection::Guard guard(m_cs);
+
+    auto *shelf = _catalog.findItem( udbn );
+
+    return shelf ? shelf->book : NullPtr;
+}
+
+CBookFile *CBookShelf::findBook( const Bookmark &bookmark ) {
+    return getBookByUdbn( bookmark.udbn );
+}
+
+bool CBookShelf::readEntry( const Bookmark &bookmark ,byte *entry ,size_t size ) {
+    CBookFile *book = findBook( bookmark );
+
+    return book && book->readEntry( bookmark.sequence ,entry ,size );
+}
+
+///-- registry
+bool CBookShelf::registerBook( CBookFile &book ,const BookRotation &rotation ) {
+    if( !book.isOpen() ) return false;
+
+    CriticalSection::Guard guard(m_cs);
+
+    Shelf &shelf = getShelf( book );
+
+    shelf.book = &book;
+    shelf.rotation = rotation;
+
+    if( shelf.rotatedAt == 0 ) { //! @note rotation period starts with first registration
+        shelf.rotatedAt = Now();
+
+        saveCatalog( shelf );
+    }
+
+    return true;
+}
+
+bool CBookShelf::releaseBook( CBookFile &book ) {
+    CriticalSection::Guard guard(m_cs);
+
+    auto *shelf = _catalog.findItem( book.udbn() );
+
+    if( !shelf || shelf->book != &book ) return false;
+
+    _catalog.delItem( book.udbn() ); //! @note closing its volumes
 
     return true;
 }
 
+///-- volumes
+IRESULT CBookShelf::Update( CBookFile &book ,time_t now ) {
+    bool isDue = false;
+
+    {
+        CriticalSection::Guard guard(m_cs);
+
+        Shelf &shelf = getShelf( book );
+
+        const BookRotation &rotation = shelf.rotation;
+
+        size_t current = book.getEntryCount() - book.getFirstEntryId();
+
+        isDue = current > rotation.keepEntries && (
+            (rotation.maxEntries > 0 && current >= rotation.maxEntries)
+            || (rotation.period > 0 && now - shelf.rotatedAt >= rotation.period)
+        );
+    }
+
+    return isDue ? Rotate( book ,now ) : IOK;
+}
+
+IRESULT CBookShelf::Rotate( CBookFile &book ,time_t now ) {
+    if( !book.isOpen() ) return IBADENV;
+
+    BookRotation rotation;
+
+    {
+        CriticalSection::Guard guard(m_cs);
+
+        rotation = getShelf( book ).rotation;
+    }
+
+    size_t end = book.getEntryCount();
+
+    entryid_t untilId = (entryid_t) (end > rotation.keepEntries ? end - rotation.keepEntries : 0);
+
+    untilId = MIN( untilId ,book.getArchiveLimit() );
+
+//-- label from rotation time
+    String label ,filepath;
+
+    char date[32]; struct tm *t = localtime( &now );
+
+    strftime( date ,sizeof(date) ,"%Y-%m-%d" ,t ? t : gmtime( &now ) );
+
+    label = date;
+
+    uint64_t size;
+
+    for( int i=2; ISUCCESS(book.makeVolumeFilepath( label.c_str() ,filepath )) && OsFileGetSizeByName( filepath.c_str() ,&size ) == ENOERROR; ++i ) {
+        Format( label ,"%s-%d" ,31 ,date ,i );
+    }
+
+//-- volume cataloged before book is shortened, dropped if archive fails
+    entryid_t first = book.getFirstEntryId();
+
+    bool archiving = untilId > first;
+
+    if( archiving ) {
+        CriticalSection::Guard guard(m_cs);
+
+        Shelf &shelf = getShelf( book );
+
+        shelf.volumes.emplace_back( BookVolumeInfo{ label ,first ,untilId ,now } );
+
+        if( !saveCatalog( shelf ) ) {
+            shelf.volumes.pop_back(); return IERROR;
+        }
+    }
+
+//-- archive
+    IRESULT result = archiving ? book.Archive( label.c_str() ,untilId ) : INODATA;
+
+    CriticalSection::Guard guard(m_cs);
+
+    Shelf &shelf = getShelf( book );
+
+    if( result == INODATA || ISUCCESS(result) ) {
+        shelf.rotatedAt = now; //! @note nothing to archive also restarts period
+    }
+
+    if( archiving && IFAILED(result) ) {
+        dropVolumes( book ,shelf ,untilId );
+    }
+
+    saveCatalog( shelf );
+
+    return result == INODATA ? IOK : result;
+}
+
+bool CBookShelf::listVolumes( CBookFile &book ,ListOf<BookVolumeInfo> &volumes ) {
+    CriticalSection::Guard guard(m_cs);
+
+    Shelf &shelf = getShelf( book );
+
+    volumes.insert( volumes.end() ,shelf.volumes.begin() ,shelf.volumes.end() );
+
+    return !shelf.volumes.empty();
+}
+
+bool CBookShelf::readArchived( CBookFile &book ,entryid_t id ,byte *entry ,size_t size ) {
+    CriticalSection::Guard guard(m_cs);
+
+    Shelf &shelf = getShelf( book );
+
+    for( auto &info : shelf.volumes ) {
+        if( id < info.firstId || id >= info.endId ) continue;
+
+        auto &volume = shelf.opened[ info.label ];
+
+        if( !volume ) { //! @note cold volumes are opened on first read
+            String filepath;
+
+            volume.reset( new CBookVolume() );
+
+            if( IFAILED(book.makeVolumeFilepath( info.label.c_str() ,filepath )) || IFAILED(volume->Open( filepath.c_str() )) ) {
+                shelf.opened.erase( info.label ); return false;
+            }
+        }
+
+        return volume->bookmode() == book.bookmode() && volume->readEntry( id ,entry ,size );
+    }
+
+    return false;
+}
+
+///-- protected
+CBookShelf::Shelf &CBookShelf::getShelf( CBookFile &book ) {
+    auto *shelf = _catalog.findItem( book.udbn() );
+
+    if( shelf ) return *shelf;
+
+    Shelf &created = _catalog[ book.udbn() ];
+
+    String filepath = book.filepath();
+
+    size_t n = filepath.size();
+
+    if( n > 5 && filepath.compare( n-5 ,5 ,".book" ) == 0 ) filepath.resize( n-5 );
+
+    created.filepath = filepath + ".catalog";
+
+    loadCatalog( created );
+
+    //! @note volumes still in book were cataloged by an interrupted archive
+    if( book.isOpen() && dropVolumes( book ,created ,book.getFirstEntryId() + 1 ) > 0 ) {
+        saveCatalog( created );
+    }
+
+    return created;
+}
+
+size_t CBookShelf::dropVolumes( CBookFile &book ,Shelf &shelf ,entryid_t fromEndId ) {
+    size_t n = shelf.volumes.size();
+
+    for( auto it=shelf.volumes.begin(); it!=shelf.volumes.end(); ) {
+        if( it->endId < fromEndId ) { ++it; continue; }
+
+        String filepath;
+
+        shelf.opened.erase( it->label );
+
+        if( ISUCCESS(book.makeVolumeFilepath( it->label.c_str() ,filepath )) ) OsFileDelete( filepath.c_str() );
+
+        it = shelf.volumes.erase( it );
+    }
+
+    return n - shelf.volumes.size();
+}
+
+//! @note catalog lines, "rotated=<time>" and "volume=<label>:<firstId>:<endId>:<archivedAt>"
+bool CBookShelf::loadCatalog( Shelf &shelf ) {
+    FILE *file = fopen( shelf.filepath.c_str() ,"rt" );
+
+    if( !file ) return false;
+
+    char line[128] ,label[32]; long long t; unsigned a ,b;
+
+    while( fgets( line ,sizeof(line) ,file ) ) {
+        if( sscanf( line ,"rotated=%lld" ,&t ) == 1 ) {
+            shelf.rotatedAt = (time_t) t;
+        }
+        else if( sscanf( line ,"volume=%31[^:]:%u:%u:%lld" ,label ,&a ,&b ,&t ) == 4 && a < b ) {
+            shelf.volumes.emplace_back( BookVolumeInfo{ label ,a ,b ,(time_t) t } );
+        }
+    }
+
+    fclose( file );
+
+    return true;
+}
+
+bool CBookShelf::saveCatalog( const Shelf &shelf ) {
+    String filepath = shelf.filepath + ".tmp";
+
+    FILE *file = fopen( filepath.c_str() ,"wt" );
+
+    if( !file ) return false;
+
+    bool result = fprintf( file ,"rotated=%lld\n" ,(long long) shelf.rotatedAt ) > 0;
+
+    for( auto &it : shelf.volumes ) {
+        result = result && fprintf( file ,"volume=%s:%u:%u:%lld\n" ,it.label.c_str() ,it.firstId ,it.endId ,(long long) it.archivedAt ) > 0;
+    }
+
+    result = fclose( file ) == 0 && result;
+
+    if( !result ) return false;
+
+    //! @note catalog replaced once complete
+    if( OsFileMove( filepath.c_str() ,shelf.filepath.c_str() ) == ENOERROR ) return true;
+
+    OsFileDelete( shelf.filepath.c_str() ); //! @note move does not replace on every os
+
+    return OsFileMove( filepath.c_str() ,shelf.filepath.c_str() ) == ENOERROR;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 } //namespace solominer {
 
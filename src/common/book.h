@@ -11,6 +11,9 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "common.h"
 
+#include <set>
+#include <unordered_map>
+
 //////////////////////////////////////////////////////////////////////////////
 namespace solominer {
 
@@ -39,6 +42,34 @@ enum BookMode {
     bookText=0 ,bookBinary
 };
 
+#define BOOK_BINARY_VERSION     1 //! first byte of binary entries
+
+#define BOOK_COMMIT_WINDOW      200 //! ms, writes within are committed together
+
+//////////////////////////////////////////////////////////////////////////////
+//! BookVolume
+
+#define BOOK_ROTATION_PERIOD        (30*86400) //! s, default volume period
+#define BOOK_ROTATION_MAXENTRIES    4096 //! default current volume size
+#define BOOK_ROTATION_KEEPENTRIES   256 //! default entries kept after rotation
+
+//! @brief when current volume of a book is archived
+struct BookRotation {
+    time_t period = BOOK_ROTATION_PERIOD; //! s, since last rotation, 0 for none
+    size_t maxEntries = BOOK_ROTATION_MAXENTRIES; //! entries in current volume, 0 for none
+
+    size_t keepEntries = BOOK_ROTATION_KEEPENTRIES; //! latest entries staying in current volume
+};
+
+//! @brief archived volume, as listed in book catalog
+struct BookVolumeInfo {
+    String label;
+
+    BookEntry::Id firstId ,endId; //! entries with firstId <= id < endId
+
+    time_t archivedAt;
+};
+
 //////////////////////////////////////////////////////////////////////////////
 //! CBookFile
 
@@ -66,6 +97,8 @@ public:
 
     size_t sizeofEntry() const { return m_sizeofEntry; }
 
+    const char *filepath() const { return m_filepath.c_str(); }
+
     byte *getUserData( size_t &size );
     bool updateUserData();
     bool setUserData( byte *data ,size_t size );
@@ -78,19 +111,40 @@ public:
     IRESULT makeFilepath( const char *title ,const char *path );
 
 //-- file
-    IRESULT Archive( const char *volume ,entryid_t untilId );
+    //! @brief move entries before untilId to a read only volume, labeled volume
+    //! @note entry ids are kept, archived entries are read back through the book shelf
+    virtual IRESULT Archive( const char *volume ,entryid_t untilId );
+
+    //! @brief entries from this id may still be updated, and are not to be archived
+    virtual entryid_t getArchiveLimit() { return (entryid_t) getEntryCount(); }
+
+    IRESULT makeVolumeFilepath( const char *volume ,String &filepath ) const;
 
     IRESULT Create( const char *title ,const char *path ,PUID uuid ,int sizeofEntry ,BookMode mode=bookText );
     IRESULT Create( const char *title ,const char *path );
     IRESULT Open( const char *title ,const char *path="" ,bool createIfNotExit=true );
     void Close();
 
+    //! @brief commit written entries to disk
+    //! @note writes are grouped over the commit window, a later Sync (or close) commits them
+    //! @note written entries are read back at once but only reach book file once committed,
+    //!     a write is durable after the first Sync past its window, a forced Sync or close
+    bool Sync( bool force=false );
+
+    //! @brief ms, 0 to commit on each Sync
+    void setCommitWindow( int ms ) { m_commitWindow = MAX( ms ,0 ); }
+    int getCommitWindow() const { return m_commitWindow; }
+
 //-- pages
     size_t getPageCount() const;
 
     bool getPageIndices( int pageId ,entryid_t &firstId ,entryid_t &lastId ) const;
 
 //-- entries
+    //! @brief first entry of current volume, entries before are archived
+    entryid_t getFirstEntryId() const;
+
+    //! @note also next entry id, counting archived entries
     size_t getEntryCount() const;
 
     entryid_t addEntry( const byte *entry ,size_t size );
@@ -98,10 +152,32 @@ public:
     bool writeEntry( entryid_t id ,const byte *entry ,size_t size );
         //! @note size here because entry bytes may be shorter than sizeofEntry, if so written data is 0 padded
 
+    //! @brief entry bytes in place, valid until next add or close, NullPtr if book is not mapped
+    const byte *peekEntry( entryid_t id );
+
 protected:
     bool makeBookHeader( const char *title );
     bool matchBookHeader( const char *title );
 
+    //! @brief start an empty book file aside (<filepath>.new) with a new entry format, keeping identity and user data
+    //! @note entries are then added to it, book is swapped with Replace once complete or dropped with Discard
+    IRESULT Recreate( BookMode mode ,int sizeofEntry );
+
+    //! @brief swap in book recreated aside, previous file is kept as <filepath>.bak
+    //! @note on failure previous book is open again
+    IRESULT Replace();
+
+    //! @brief drop book recreated aside, previous book is open again
+    IRESULT Discard();
+
+    IRESULT restoreAside();
+    IRESULT Reopen();
+
+    //! @brief indexes saved at close, along book as <filepath>.idx
+    //! @note file is removed once loaded, a book not closed properly rebuilds its indexes
+    bool loadIndexes( ListOf<byte> &data );
+    bool saveIndexes( const ListOf<byte> &data );
+
     bool makeNewEntry( entryid_t &id ,size_t &offset );
     bool getEntryOffset( entryid_t id ,size_t &offset );
 
@@ -120,14 +196,83 @@ protected:
     PUID m_uuid; //! entry uuid
 
     int m_sizeofEntry; //! size in byte of an entry
+
+    int m_commitWindow; //! ms
 };
 
 typedef RefOf<CBookFile> CBookFileRef;
 
+//////////////////////////////////////////////////////////////////////////////
+//! CBookVolume
+
+/**
+ * @brief read only volume of archived book entries, <book>.<label>.vol
+ * @note entries are packed without their padding, behind a table of their offsets
+ */
+
+class CBookVolume {
+public:
+    typedef BookEntry::Id entryid_t;
+
+public:
+    CBookVolume() DEFAULT;
+
+    ~CBookVolume() {
+        Close();
+    }
+
+    const char *label() const { return m_label.c_str(); }
+    BookMode bookmode() const { return m_mode; }
+    const Guid &udbn() const { return m_udbn; }
+
+    entryid_t firstId() const { return m_firstId; }
+    entryid_t endId() const { return m_firstId + (entryid_t) m_nEntry; }
+
+public:
+    //! @brief pack entries from <= id < to of book into a new volume file
+    static IRESULT Write( const char *filepath ,const char *label ,CBookFile &book ,entryid_t from ,entryid_t to );
+
+    IRESULT Open( const char *filepath );
+    void Close();
+
+    bool isOpen() { return m_file.isOpen(); }
+
+    //! @note entry is 0 padded up to size
+    bool readEntry( entryid_t id ,byte *entry ,size_t size );
+
+protected:
+    File m_file;
+
+    byte *m_map = NullPtr;
+    size_t m_mapSize = 0;
+
+    ListOf<byte> m_data; //! @note if volume could not be mapped
+
+    const byte *m_entries = NullPtr;
+    const uint32_t *m_offsets = NullPtr;
+
+//-- header info
+    String m_label;
+    BookMode m_mode = bookText;
+    Guid m_udbn;
+
+    entryid_t m_firstId = 0;
+    size_t m_nEntry = 0;
+};
+
 //////////////////////////////////////////////////////////////////////////////
 //! BookShelf
 
-class CBookShelf : Singleton_<CBookShelf> {
+/**
+ * @brief registry of opened books and catalog of their archived volumes, <book>.catalog
+ * @note current volume of a book is archived once period or size of rotation is past,
+ *      entries still open to updates (see getArchiveLimit) stay in current volume
+ */
+
+class CBookShelf : public Singleton_<CBookShelf> {
+public:
+    typedef BookEntry::Id entryid_t;
+
 public:
     CBookShelf() DEFAULT;
 
@@ -136,32 +281,328 @@ public:
 
 //-- bookmark
     CBookFile *findBook( const Bookmark &bookmark );
-    byte *findEntry( const Bookmark &bookmark );
+    bool readEntry( const Bookmark &bookmark ,byte *entry ,size_t size );
 
 //-- registry
-    bool registerBook( CBookFile &book );
+    bool registerBook( CBookFile &book ,const BookRotation &rotation=BookRotation() );
     bool releaseBook( CBookFile &book );
 
+//-- volumes
+    //! @brief archive current volume of book if rotation is due
+    IRESULT Update( CBookFile &book ,time_t now );
+
+    //! @brief archive current volume of book now
+    IRESULT Rotate( CBookFile &book ,time_t now );
+
+    bool listVolumes( CBookFile &book ,ListOf<BookVolumeInfo> &volumes );
+
+    //! @brief entry of book from its archived volumes
+    bool readArchived( CBookFile &book ,entryid_t id ,byte *entry ,size_t size );
+
+protected:
+    struct Shelf {
+        CBookFile *book = NullPtr; //! @note not owned, NullPtr if not registered
+        BookRotation rotation;
+
+        String filepath; //! catalog file
+        time_t rotatedAt = 0;
+
+        ListOf<BookVolumeInfo> volumes;
+        MapOf<String,PtrOf<CBookVolume> > opened; //! label -> volume
+    };
+
+    Shelf &getShelf( CBookFile &book ); //! @note under lock, catalog loaded on first use
+
+    //! @brief remove volumes ending at or after fromEndId, with their file
+    static size_t dropVolumes( CBookFile &book ,Shelf &shelf ,entryid_t fromEndId );
+
+    static bool loadCatalog( Shelf &shelf );
+    static bool saveCatalog( const Shelf &shelf );
+
+    CriticalSection m_cs;
+
+    Map_<Guid,Shelf> _catalog; //! known books, by udbn
+};
+
+inline CBookShelf &getBookShelf() {
+    return CBookShelf::getInstance();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! BookIndex
+
+    //! @brief secondary index of a book, maintained on add/update, persisted with book
+
+template <class T>
+class BookIndex_ {
+public:
+    typedef BookEntry::Id entryid_t;
+
+    explicit BookIndex_( const char *name ) : m_name(name)
+    {}
+
+    virtual ~BookIndex_() DEFAULT;
+
+    const String &name() const { return m_name; }
+
+    virtual void Clear() = 0;
+
+    virtual void Add( entryid_t id ,const T &entry ) = 0;
+    virtual void Remove( entryid_t id ) = 0;
+
+    virtual void Write( BinaryWriter &w ) const = 0;
+    virtual bool Read( BinaryReader &r ) = 0;
+
+protected:
+    String m_name;
+};
+
+//! @brief key for index from binary id, empty (not indexed) if id is zero
+inline String toIndexKey( const guid_t &id ) {
+    guid_t zero; Zero( zero );
+
+    return Equals( id ,zero ) ? String() : String( (const char*) id ,sizeof(guid_t) );
+}
+
+///-- hash
+    //! @brief entries by key (e.g. txid, guid), a key may match several entries
+
+template <class T>
+class BookHashIndex_ : public BookIndex_<T> {
+public:
+    typedef BookEntry::Id entryid_t;
+
+    typedef String (*key_t)( const T &entry ); //! @note empty key is not indexed
+
+    BookHashIndex_( const char *name ,key_t key ) : BookIndex_<T>(name) ,m_key(key)
+    {}
+
+    //! @return last entry with key, INVALID_ENTRY_VALUE if none
+    entryid_t find( const String &key ) const {
+        entryid_t id = INVALID_ENTRY_VALUE;
+
+        auto range = m_entries.equal_range( key );
+
+        for( auto it = range.first; it != range.second; ++it ) {
+            if( id == INVALID_ENTRY_VALUE || it->second > id ) id = it->second;
+        }
+
+        return id;
+    }
+
+    //! @brief entries with key, ascending
+    bool list( const String &key ,ListOf<entryid_t> &ids ) const {
+        auto range = m_entries.equal_range( key );
+
+        for( auto it = range.first; it != range.second; ++it ) {
+            ids.emplace_back( it->second );
+        }
+
+        std::sort( ids.begin() ,ids.end() );
+
+        return !ids.empty();
+    }
+
+public:
+    void Clear() override {
+        m_entries.clear(); m_keys.clear();
+    }
+
+    void Add( entryid_t id ,const T &entry ) override {
+        String key = m_key( entry );
+
+        if( key.empty() ) return;
+
+        m_entries.emplace( key ,id );
+        m_keys[id] = key;
+    }
+
+    void Remove( entryid_t id ) override {
+        auto it = m_keys.find( id );
+
+        if( it == m_keys.end() ) return;
+
+        auto range = m_entries.equal_range( it->second );
+
+        for( auto e = range.first; e != range.second; ++e ) {
+            if( e->second == id ) {
+                m_entries.erase( e ); break;
+            }
+        }
+
+        m_keys.erase( it );
+    }
+
+    void Write( BinaryWriter &w ) const override {
+        w.WriteVarint( m_keys.size() );
+
+        for( const auto &it : m_keys ) {
+            toBinary( it.first ,w ); toBinary( it.second ,w );
+        }
+    }
+
+    bool Read( BinaryReader &r ) override {
+        uint64_t n; if( !r.ReadVarint( n ) ) return false;
+
+        entryid_t id; String key;
+
+        for( uint64_t i=0; i<n; ++i ) {
+            if( fromBinary( id ,r ) && fromBinary( key ,r ) ) {} else return false;
+
+            m_entries.emplace( key ,id );
+            m_keys[id] = key;
+        }
+
+        return true;
+    }
+
+protected:
+    key_t m_key;
+
+    std::unordered_multimap<String,entryid_t> m_entries;
+    std::unordered_map<entryid_t,String> m_keys; //! @note key of each entry, for update
+};
+
+///-- ordered
+    //! @brief entries ordered by a major (e.g. status) and a minor (e.g. time) key
+
+template <class T>
+class BookOrderedIndex_ : public BookIndex_<T> {
+public:
+    typedef BookEntry::Id entryid_t;
+
+    typedef bool (*key_t)( const T &entry ,int64_t &major ,int64_t &minor ); //! @return false if entry is not indexed
+
+    BookOrderedIndex_( const char *name ,key_t key ) : BookIndex_<T>(name) ,m_key(key)
+    {}
+
+    //! @brief entries with from <= major < to, in key order
+    bool list( int64_t from ,int64_t to ,ListOf<entryid_t> &ids ) const {
+        for( auto it = m_entries.lower_bound( Key{ from ,INT64_MIN ,0 } ); it != m_entries.end() && it->major < to; ++it ) {
+            ids.emplace_back( it->id );
+        }
+
+        return !ids.empty();
+    }
+
+public:
+    void Clear() override {
+        m_entries.clear(); m_keys.clear();
+    }
+
+    void Add( entryid_t id ,const T &entry ) override {
+        Key key = { 0 ,0 ,id };
+
+        if( !m_key( entry ,key.major ,key.minor ) ) return;
+
+        m_entries.insert( key );
+        m_keys[id] = key;
+    }
+
+    void Remove( entryid_t id ) override {
+        auto it = m_keys.find( id );
+
+        if( it == m_keys.end() ) return;
+
+        m_entries.erase( it->second );
+        m_keys.erase( it );
+    }
+
+    void Write( BinaryWriter &w ) const override {
+        w.WriteVarint( m_entries.size() );
+
+        for( const auto &it : m_entries ) {
+            toBinary( it.major ,w ); toBinary( it.minor ,w ); toBinary( it.id ,w );
+        }
+    }
+
+    bool Read( BinaryReader &r ) override {
+        uint64_t n; if( !r.ReadVarint( n ) ) return false;
+
+        Key key;
+
+        for( uint64_t i=0; i<n; ++i ) {
+            if( fromBinary( key.major ,r ) && fromBinary( key.minor ,r ) && fromBinary( key.id ,r ) ) {} else return false;
+
+            m_entries.insert( key );
+            m_keys[key.id] = key;
+        }
+
+        return true;
+    }
+
 protected:
-    Map_<Guid,String> _catalog; //! known book
-        //! save to catalog file
+    struct Key {
+        int64_t major ,minor;
+        entryid_t id;
+
+        bool operator <( const Key &other ) const {
+            return major != other.major ? major < other.major
+                : minor != other.minor ? minor < other.minor
+                : id < other.id
+            ;
+        }
+    };
+
+    key_t m_key;
 
-    Map_<Guid,CBookFileRef> _books; //! opened book
+    std::set<Key> m_entries;
+    std::unordered_map<entryid_t,Key> m_keys;
 };
 
 //////////////////////////////////////////////////////////////////////////////
 //! CBookFile_
 
 #define BOOK_CACHE_NONE ((size_t) 0)
-#define BOOK_CACHE_ALL  ((size_t) -1)
+#define BOOK_CACHE_ALL  CACHE_UNBOUNDED
 
 template <class T>
 class CBookFile_ : public CBookFile {
 public:
-    CBookFile_( int sizeofEntry=T::sizeofEntry() ,BookMode mode=bookText ,size_t cacheCount=32 ) :
+    CBookFile_( int sizeofEntry=T::sizeofEntry() ,BookMode mode=bookBinary ,size_t cacheCount=32 ) :
         CBookFile( T::classId() ,sizeofEntry ,mode )
+        ,m_cache(cacheCount)
+        ,m_createMode(mode) ,m_createSize(sizeofEntry)
     {}
 
+public:
+    IRESULT Open( const char *title ,const char *path="" ,bool createIfNotExit=true ) {
+        IRESULT result = CBookFile::Open( title ,path ,createIfNotExit ); IF_IFAILED_RETURN(result);
+
+        if( !m_indexes.empty() ) openIndexes();
+
+        return result;
+    }
+
+    //! @note indexes are only saved on an explicit close, next open rebuilds them otherwise
+    void Close() {
+        if( isOpen() && !m_indexes.empty() ) closeIndexes();
+
+        CBookFile::Close();
+    }
+
+//-- indexes
+    //! @brief index maintained by this book, to add before opening
+    void addIndex( BookIndex_<T> &index ) {
+        m_indexes.emplace_back( &index );
+    }
+
+    void rebuildIndexes() {
+        for( auto *index : m_indexes ) index->Clear();
+
+        auto n = (entryid_t) getEntryCount();
+
+        T entry;
+
+        for( entryid_t id=0; id<n; ++id ) {
+            Zero( entry );
+
+            if( !readEntry( id ,entry ) ) continue;
+
+            for( auto *index : m_indexes ) index->Add( id ,entry );
+        }
+    }
+
 public:
     template <typename THeader>
     THeader &getHeader() {
@@ -176,57 +617,154 @@ public:
         return updateUserData();
     }
 
+public: ///-- cache
+    typedef Cache_<entryid_t,T> cache_t;
+
+    const cache_t &cache() const { return m_cache; }
+
+    //! @brief count of entries kept in memory, BOOK_CACHE_ALL for all
+    void setCacheCount( size_t cacheCount ) {
+        m_cache.setCapacity( cacheCount );
+    }
+
+    //! @brief keep entry in memory, returned pointer stays valid until unpinned
+    T *pinEntry( entryid_t id ) {
+        T *p = getEntry( id );
+
+        if( p ) m_cache.Pin( id );
+
+        return p;
+    }
+
+    void unpinEntry( entryid_t id ) {
+        m_cache.Unpin( id );
+    }
+
 public:
-    //TODO properly use chache and commits
-    void Commit() {
-        for( auto &it : m_cache.map() ) if( it.second.touched ) {
-            writeEntry( it.first ,it.second.entry );
+    //! @brief write updated entries
+    //! @note entries failing to write are dropped, read back on next use (e.g. archived entries)
+    bool Commit() {
+        ListOf<entryid_t> failed;
+
+        m_cache.eachDirty( [this,&failed]( entryid_t id ,T &entry ) -> bool {
+            if( writeEntry( id ,entry ) ) m_cache.setDirty( id ,false ); else failed.emplace_back( id );
+
+            return true;
+        });
+
+        for( auto id : failed ) {
+            T entry;
 
-            it.second.touched = false;
+            Zero( entry );
+
+            if( readEntry( id ,entry ) ) updateIndexes( id ,entry ); else removeIndexes( id );
+
+            m_cache.delItem( id );
         }
 
-        m_file.Flush();
+        return Sync() && failed.empty();
     }
 
+    //! @brief drop updated entries, reading them back from file
     void Rollback() {
-        for( auto &it : m_cache.map() ) if( it.second.touched ) {
-            readEntry( it.first ,it.second.entry );
+        m_cache.eachDirty( [this]( entryid_t id ,T &entry ) -> bool {
+            readEntry( id ,entry );
+
+            updateIndexes( id ,entry );
+
+            m_cache.setDirty( id ,false );
+
+            return true;
+        });
+    }
+
+    //! @brief rewrite all entries of current volume with another mode and entry size
+    //! @note new book is built aside and only replaces current one once complete
+    //! @note archived volumes keep their mode, they are only read back by a book of same mode
+    IRESULT Convert( BookMode mode ,int sizeofEntry ) {
+        if( !isOpen() ) return IBADENV;
+
+        entryid_t first = getFirstEntryId();
+
+        if( first > 0 && mode != m_mode ) return IBADENV;
+
+        ListOf<T> entries( getEntryCount() - first );
 
-            it.second.touched = false;
+        for( size_t i=0; i<entries.size(); ++i ) {
+            Zero( entries[i] );
+
+            if( !readEntry( first + (entryid_t) i ,entries[i] ) )
+                return IBADDATA;
+        }
+
+        //! @note sized for its largest entry
+        Bytes bytes;
+
+        for( auto &it : entries ) {
+            bool encoded = mode == bookBinary ? writeBinaryEntry( it ,bytes ) : writeTextEntry( it ,bytes );
+
+            if( encoded ) sizeofEntry = (int) growEntrySize( (size_t) sizeofEntry ,bytes.count() );
+        }
+
+        //! @note cached entries stay valid, ids and content are unchanged
+        IRESULT result = Recreate( mode ,sizeofEntry ); IF_IFAILED_RETURN(result);
+
+        for( auto &it : entries ) {
+            if( !writeEntry( it.sequence ,it ,true ) ) {
+                Discard(); return IERROR;
+            }
         }
+
+        return Replace();
+    }
+
+    //! @brief one time conversion of a book opened with another mode or a smaller entry size than this book is made for
+    //! @note e.g. text books from before binary entries
+    IRESULT Upgrade() {
+        return m_mode == m_createMode && (int) sizeofEntry() >= m_createSize ? IOK : Convert( m_createMode ,m_createSize );
+    }
+
+    IRESULT Archive( const char *volume ,entryid_t untilId ) override {
+        Commit(); //! @note archived entries as last updated
+
+        return CBookFile::Archive( volume ,untilId );
     }
 
 public:
+    //! @note entry is written at once, commit also writes updated entries and syncs book
+    //! @note not durable on return even with commit, until the next Sync past the commit window
+    //!     (IE periodic Sync of the owner) or a forced Sync
     id_t addEntry( const T &entry ,bool commit=false ) {
         entryid_t id = getEntryCount();
 
-        auto &it = m_cache[id];
+        m_cache.setItem( id ,entry );
 
-        it = entry; //! @note forcing cache for commit
-        it.touched = false;
+        if( !writeEntry( id ,entry ,true ) ) {
+            m_cache.delItem( id ); return INVALID_ENTRY_VALUE;
+        }
 
-        if( !writeEntry( id ,entry ,true ) )
-            return INVALID_ENTRY_VALUE;
+        updateIndexes( id ,entry );
 
-        Commit();
+        if( commit ) Commit();
 
         return id;
     }
 
+    //! @note archived entries are read only
     bool updateEntry( entryid_t id ,const T &entry ,bool commit=true ) {
-        m_cache[id] = entry; //! @note forcing cache for commit
+        if( id < getFirstEntryId() || id >= (entryid_t) getEntryCount() ) return false;
 
-        if( commit ) Commit();
+        m_cache.setItem( id ,entry ,true ); //! @note kept until committed
 
-        return true;
+        updateIndexes( id ,entry );
+
+        return commit ? Commit() : true;
     }
 
     T *getEntry( entryid_t id ) {
         auto *p = m_cache.findItem( id );
 
-        if( p ) {
-            p->Hit(); return &(p->entry);
-        }
+        if( p ) return p;
 
         T entry;
 
@@ -235,11 +773,8 @@ public:
         if( !readEntry( id ,entry ) )
             return NullPtr;
 
-        auto &it = m_cache[id]; //! @note forcing cache for return pointer
-
-        it = entry; //! @note forcing cache for return pointer
-
-        return &(it.entry);
+        //! @note pointer valid until entry is evicted, see pinEntry
+        return &m_cache.setItem( id ,entry );
     }
 
     bool getEntry( entryid_t id ,T &entry ) {
@@ -259,9 +794,16 @@ public:
         for( entryid_t i=0; i<n; ++i ) {
             entryid_t id = backward ? (n-i-1) : i;
 
-            T *p = getEntry( id );
+            if( !filterEntry( id ,filter ) ) return;
+        }
+    }
 
-            if( p && filter( id ,*p ) ) {} else return;
+    //! @brief entries listed from an index, in list order
+    //! @note list is taken before filtering, filter may update entries
+    template <typename F>
+    void eachListed( const ListOf<entryid_t> &ids ,F &&filter ) {
+        for( auto id : ids ) {
+            if( !filterEntry( id ,filter ) ) return;
         }
     }
 
@@ -272,16 +814,15 @@ public:
         for( entryid_t i=0; i<n; ++i ) {
             entryid_t id = backward ? (n-i-1) : i;
 
-            T *p = getEntry( id );
-
-            if( p && filter( id ,*p ) ) return p;
+            if( filterEntry( id ,filter ) ) return getEntry( id );
         }
 
         return NullPtr;
     }
 
+    //! @note entries are copied, cached entries may be evicted while listing
     template <typename F>
-    bool listEntry( F &&filter ,ListOf<T*> &list ,bool backward=true ) {
+    bool listEntry( F &&filter ,ListOf<T> &list ,bool backward=true ) {
         auto n = (entryid_t) this->getEntryCount();
         bool found = false;
 
@@ -291,7 +832,7 @@ public:
             T *p = getEntry( id );
 
             if( p && filter( id ,*p ) ) {
-                list.emplace_back( p );
+                list.emplace_back( *p );
                 found = true;
             }
         }
@@ -303,18 +844,24 @@ protected:
     Bytes m_buffer;
 
     bool readEntry( entryid_t id ,T &entry ) {
-        m_buffer.Reserve( sizeofEntry() );
+        const byte *p = peekEntry( id ); //! @note parse in place when mapped
 
-        if( !CBookFile::readEntry( id ,m_buffer.ptr() ,sizeofEntry() ) )
-            return false;
+        if( !p ) {
+            m_buffer.Reserve( sizeofEntry() );
+
+            if( !CBookFile::readEntry( id ,m_buffer.ptr() ,sizeofEntry() ) )
+                return false;
+
+            p = m_buffer.ptr();
+        }
 
         entry.sequence = id;
 
         switch( m_mode ) {
             case bookText:
-                return readTextEntry( m_buffer.ptr() ,entry );
+                return readTextEntry( p ,entry );
             case bookBinary:
-                return readBinaryEntry( m_buffer.ptr() ,entry );
+                return readBinaryEntry( p ,entry );
 
             default:
                 return false;
@@ -333,19 +880,33 @@ protected:
                 return false;
         }
 
+        if( !result ) return false;
+
+        //! @note entry larger than book was sized for (either mode), book spills to a larger entry size
+        if( bytes.count() > sizeofEntry() && IFAILED( Convert( m_mode ,growEntrySize( sizeofEntry() ,bytes.count() ) ) ) )
+            return false;
+
         return add ?
             CBookFile::addEntry( bytes.ptr() ,bytes.count() ) != INVALID_ENTRY_VALUE
             : CBookFile::writeEntry( id ,bytes.ptr() ,bytes.count() )
         ;
     }
 
+    static size_t growEntrySize( size_t from ,size_t size ) {
+        size_t grow = MAX( from ,(size_t) 64 );
+
+        while( grow < size ) grow *= 2;
+
+        return grow;
+    }
+
 //-- mode text
     bool readTextEntry( const byte *p ,T &entry ) {
         assert( m_mode == bookText && p );
 
         const char *str = (const char*) p;
 
-        String s( str ,strlen(str) );
+        String s( str ,strnlen( str ,sizeofEntry() ) );
 
         fromString( entry ,s );
 
@@ -357,11 +918,6 @@ protected:
 
         toString( entry ,s );
 
-        if( s.size() > sizeofEntry() ) {
-            assert(false); //! should not happen
-            return false;
-        }
-
         bytes.copyFrom( (byte*) s.c_str() ,s.size()+1 );
 
         return true;
@@ -369,34 +925,113 @@ protected:
 
 //-- mode binary
     bool readBinaryEntry( const byte *p ,T &entry ) {
-        _TODO; return false;
+        assert( m_mode == bookBinary && p );
+
+        if( p[0] != BOOK_BINARY_VERSION ) return false;
+
+        BinaryReader reader( p+1 ,sizeofEntry()-1 );
+
+        return fromBinary( entry ,reader );
     }
 
     bool writeBinaryEntry( const T &entry ,Bytes &bytes ) {
-        _TODO; return false;
+        m_binary.clear(); m_binary.push_back( BOOK_BINARY_VERSION );
+
+        BinaryWriter writer( m_binary );
+
+        toBinary( entry ,writer );
+
+        bytes.copyFrom( m_binary.data() ,m_binary.size() );
+
+        return true;
     }
 
+    ListOf<byte> m_binary;
+
 //-- cache
     void setCache( entryid_t id ,const T &entry ) {
-        m_cache[id] = entry;
+        m_cache.setItem( id ,entry ,true );
     }
 
-    // bool getCache
+    //! @brief entry pinned while filtered, filter may get or update other entries
+    template <typename F>
+    bool filterEntry( entryid_t id ,F &&filter ) {
+        T *p = pinEntry( id );
+
+        if( !p ) return false;
 
-    struct Cache {
-        Cache &operator =( const T &other ) { entry = other; touched = true; return *this; }
+        bool result = filter( id ,*p );
 
-        void Hit() { ++hit; }
+        unpinEntry( id );
 
-        T entry;
+        return result;
+    }
 
-        bool touched = false;
-        int hit = 0;
-    };
+    cache_t m_cache; //! @note dirty entries are kept until committed
 
-    Map_<entryid_t,Cache> m_cache; //TODO use cache from pattern
+//-- format
+    BookMode m_createMode; //! mode new books are made with
+    int m_createSize; //! entry size new books are made with
+
+//-- indexes
+    void updateIndexes( entryid_t id ,const T &entry ) {
+        for( auto *index : m_indexes ) {
+            index->Remove( id ); index->Add( id ,entry );
+        }
+    }
+
+    void removeIndexes( entryid_t id ) {
+        for( auto *index : m_indexes ) index->Remove( id );
+    }
+
+    void openIndexes() {
+        ListOf<byte> data;
+
+        for( auto *index : m_indexes ) index->Clear();
+
+        if( loadIndexes( data ) && readIndexes( data ) ) return;
+
+        rebuildIndexes();
+    }
+
+    void closeIndexes() {
+        ListOf<byte> data;
+
+        BinaryWriter writer( data );
+
+        for( int i=0; i<(int) m_indexes.size(); ++i ) {
+            size_t at = writer.beginField( i );
+
+            toBinary( m_indexes[i]->name() ,writer );
+            m_indexes[i]->Write( writer );
+
+            writer.endField( at );
+        }
+
+        writer.WriteVarint( 0 );
+
+        saveIndexes( data );
+    }
+
+    bool readIndexes( const ListOf<byte> &data ) {
+        BinaryReader reader( data.data() ,data.size() ) ,field;
+
+        size_t found = 0; int i; String name;
+
+        while( reader.nextField( i ,field ) ) {
+            if( i < (int) m_indexes.size() && fromBinary( name ,field ) && name == m_indexes[i]->name() ) {} else
+                return false;
+
+            if( !m_indexes[i]->Read( field ) )
+                return false;
+
+            ++found;
+        }
+
+        return reader.ok && found == m_indexes.size();
+    }
 
-    size_t m_cacheCount; //! count of cache entries 0=none ,BOOK_CACHE_ALL=all
+    ListOf<BookIndex_<T>*> m_indexes; //! @note not owned
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,103 @@
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+//////////////////////////////////////////////////////////////////////////////
+#include "estimator.h"
+
+#include <cmath>
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Estimator
+
+void EwmaEstimator::Reset() {
+    mean = variance = 0.;
+    weight = weight2 = 0.;
+
+    time = 0; n = 0; rejected = 0;
+}
+
+bool EwmaEstimator::Add( double x ,time_t now ) {
+    //! @note an estimate gone cold (restored, miner paused) does not judge new samples
+    bool isCold = n > 0 && halfLife > 0 && (double) (now - time) > halfLife * 4;
+
+    if( n >= ESTIMATOR_WARMUP && !isCold ) {
+        double deviation = MAX( getDeviation() ,fabs(mean) * ESTIMATOR_MINDEVIATION );
+
+        if( fabs( x - mean ) > ESTIMATOR_OUTLIER_SIGMA * deviation ) {
+            if( ++rejected <= ESTIMATOR_MAXREJECT ) return false;
+
+            Reset(); //! @note persistent change (hardware, tuning...), restart from here
+        }
+    }
+
+    rejected = 0;
+
+    //! @note samples within the same second still decay a little, not to weigh as one
+    double dt = n > 0 ? (double) MAX( now - time ,(time_t) 1 ) : 0.;
+    double decay = n > 0 && halfLife > 0 ? pow( .5 ,dt / halfLife ) : 0.;
+
+    weight = decay * weight + 1.;
+    weight2 = decay * decay * weight2 + 1.;
+
+    double alpha = 1. / weight;
+    double delta = x - mean;
+
+    mean += alpha * delta;
+    variance = (1 - alpha) * (variance + alpha * delta * delta);
+
+    time = now; ++n;
+
+    return true;
+}
+
+double EwmaEstimator::getDeviation() const {
+    return sqrt( MAX( variance ,0. ) );
+}
+
+double EwmaEstimator::getLower() const {
+    double count = getSampleCount();
+
+    return count > 0 ? mean - ESTIMATOR_CONFIDENCE_Z * getDeviation() / sqrt(count) : mean;
+}
+
+double EwmaEstimator::getUpper() const {
+    double count = getSampleCount();
+
+    return count > 0 ? mean + ESTIMATOR_CONFIDENCE_Z * getDeviation() / sqrt(count) : mean;
+}
+
+//--
+bool fromString( EwmaEstimator &p ,const char *s ) {
+    double mean ,variance ,weight ,weight2; long long t;
+
+    if( !s || sscanf( s ,"%lf:%lf:%lf:%lf:%lld" ,&mean ,&variance ,&weight ,&weight2 ,&t ) != 5 )
+        return false;
+
+    if( mean < 0 || variance < 0 || weight < 1 || weight2 < 1 ) return false;
+
+    p.Reset();
+
+    p.mean = mean; p.variance = variance;
+    p.weight = weight; p.weight2 = weight2;
+    p.time = (time_t) t;
+
+    //! @note restored estimate counts as warmed up, it decays on the next sample
+    p.n = ESTIMATOR_WARMUP;
+
+    return true;
+}
+
+String &toString( const EwmaEstimator &p ,String &s ) {
+    Format( s ,"%.2f:%.6g:%.6g:%.6g:%lld" ,128 ,p.mean ,p.variance ,p.weight ,p.weight2 ,(long long) p.time );
+
+    return s;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//EOF
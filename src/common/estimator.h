@@ -0,0 +1,74 @@
+#pragma once
+
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SOLOMINER_ESTIMATOR_H
+#define SOLOMINER_ESTIMATOR_H
+
+//////////////////////////////////////////////////////////////////////////////
+#include "common.h"
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Estimator
+
+#define ESTIMATOR_HALFLIFE_DEFAULT  600 //! s
+#define ESTIMATOR_WARMUP            5 //! samples before rejecting outliers
+#define ESTIMATOR_OUTLIER_SIGMA     4.
+#define ESTIMATOR_MAXREJECT         3 //! consecutive outliers taken as a new regime
+#define ESTIMATOR_MINDEVIATION      .01 //! relative to mean, deviation floor for outliers
+#define ESTIMATOR_CONFIDENCE_Z      1.96 //! 95% bounds
+
+/**
+ * @brief exponentially weighted mean and variance of a sampled rate
+ * @note decay is on sample time, a sample weight halves every halfLife seconds
+ * @note weights are normalized (bias corrected), first sample sets the mean
+ * @note after warmup, samples beyond OUTLIER_SIGMA deviations are rejected,
+ *      unless MAXREJECT of them follow, the estimator then restarts from them
+ */
+
+struct EwmaEstimator {
+    double halfLife = ESTIMATOR_HALFLIFE_DEFAULT; //! s
+
+    double mean = 0.;
+    double variance = 0.;
+
+    double weight = 0.; //! sum of decayed weights
+    double weight2 = 0.; //! sum of squared decayed weights
+
+    time_t time = 0; //! last accepted sample
+
+    int n = 0; //! accepted samples
+    int rejected = 0; //! consecutive rejected samples
+
+    bool hasData() const { return n > 0; }
+
+    void Reset();
+
+    //! @return false if sample was rejected as an outlier
+    bool Add( double x ,time_t now );
+
+    double getMean() const { return mean; }
+    double getDeviation() const;
+
+    //! @brief number of samples the estimate is worth
+    double getSampleCount() const { return weight2 > 0 ? weight * weight / weight2 : 0.; }
+
+    //! @brief confidence bounds of the mean
+    double getLower() const;
+    double getUpper() const;
+};
+
+//-- persistence, "mean:variance:weight:weight2:time"
+bool fromString( EwmaEstimator &p ,const char *s );
+String &toString( const EwmaEstimator &p ,String &s );
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//////////////////////////////////////////////////////////////////////////////
+#endif //SOLOMINER_ESTIMATOR_H
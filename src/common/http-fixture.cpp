@@ -0,0 +1,207 @@
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+//////////////////////////////////////////////////////////////////////////////
+#include "http-fixture.h"
+
+#include <fstream>
+#include <cstdlib>
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Config
+
+template <>
+HttpFixtureConfig &fromManifest( HttpFixtureConfig &p ,const Params &s ) {
+    fromString( p.latency ,getMember(s,"latency","0") );
+    fromString( p.jitter ,getMember(s,"jitter","0") );
+    fromString( p.errorRate ,getMember(s,"errors","0") );
+    fromString( p.timeoutRate ,getMember(s,"timeouts","0") );
+    fromString( p.rateLimit ,getMember(s,"limit","0") );
+    fromString( p.rateInterval ,getMember(s,"interval","60") );
+
+    return p;
+}
+
+template <>
+Params &toManifest( const HttpFixtureConfig &p ,Params &s ) {
+    toString( p.latency ,s["latency"] );
+    toString( p.jitter ,s["jitter"] );
+    toString( p.errorRate ,s["errors"] );
+    toString( p.timeoutRate ,s["timeouts"] );
+    toString( p.rateLimit ,s["limit"] );
+    toString( p.rateInterval ,s["interval"] );
+
+    return s;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! CHttpFixture
+
+static const char *g_methodNames[] = {
+    "GET" ,"HEAD" ,"POST" ,"PUT" ,"PATCH" ,"DELETE" ,"CONNECT" ,"OPTIONS" ,"TRACE"
+};
+
+IRESULT CHttpFixture::Record( const char *filename ) {
+    CriticalSection::Guard guard(m_cs);
+
+    m_filename = filename;
+    m_exchanges.clear();
+
+    //! @note new recording session, truncate
+    std::ofstream fs( m_filename ,std::ios::trunc );
+
+    if( !fs.is_open() )
+        return IBADENV;
+
+    m_mode = fixtureRecord;
+
+    return IOK;
+}
+
+IRESULT CHttpFixture::Replay( const char *filename ,const HttpFixtureConfig &config ) {
+    CriticalSection::Guard guard(m_cs);
+
+    m_filename = filename;
+    m_config = config;
+
+    m_rate.setLimit( m_config.rateLimit ,m_config.rateInterval );
+
+    IRESULT ir = LoadFile(); IF_IFAILED_RETURN(ir);
+
+    m_mode = fixtureReplay;
+
+    return IOK;
+}
+
+void CHttpFixture::Close() {
+    CriticalSection::Guard guard(m_cs);
+
+    m_mode = fixtureNone;
+    m_exchanges.clear();
+}
+
+///--
+String CHttpFixture::makeKey( const CHttpRequest &request ) {
+    String key = g_methodNames[ CLAMP( (int) request.method() ,0 ,(int) HttpMethod::methodTRACE ) ];
+
+    key += ' '; key += request.url();
+
+    if( !request.body().empty() ) {
+        key += ' '; key += request.body();
+    }
+
+    return key;
+}
+
+void CHttpFixture::Put( const String &key ,const HttpResponse &response ) {
+    CriticalSection::Guard guard(m_cs);
+
+    if( m_mode != fixtureRecord ) return;
+
+    std::ofstream fs( m_filename ,std::ios::app );
+
+    if( fs.is_open() ) {
+        fs << key << '\x0' << (int) response.status << ':' << response.content << '\x0';
+    }
+}
+
+IRESULT CHttpFixture::Get( const String &key ,HttpResponse &response ) {
+    Entry entry;
+
+    HttpFixtureConfig config;
+
+    bool limited;
+
+    { CriticalSection::Guard guard(m_cs);
+
+        config = m_config;
+
+        auto it = m_exchanges.find( key );
+
+        if( it == m_exchanges.end() || it->second.responses.empty() ) {
+            response.status = HttpStatus::NotFound;
+            response.content = "fixture -> no recorded response for " + key;
+
+            return IERROR; //! @note as if server could not be reached
+        }
+
+        Exchange &exchange = it->second;
+
+        entry = exchange.responses[ exchange.next ];
+        exchange.next = (exchange.next + 1) % exchange.responses.size();
+
+        limited = !m_rate.tryRequest( quotaTrading ); //! @note top class, server side has no reserve
+    }
+
+///-- latency
+    int delay = config.latency + (config.jitter > 0 ? rand() % (config.jitter+1) : 0);
+
+    if( delay > 0 ) OsSleep( delay );
+
+///-- injected failures
+    int roll = rand() % 100;
+
+    if( roll < config.timeoutRate ) {
+        response.status = HttpStatus::RequestTimeout;
+        response.content = "fixture -> Operation timed out";
+
+        return IERROR;
+    }
+
+    if( roll < config.timeoutRate + config.errorRate ) {
+        response.status = HttpStatus::InternalServerError;
+        response.content = "{\"error\":\"fixture injected error\"}";
+
+        return IOK;
+    }
+
+    if( limited ) {
+        response.status = HttpStatus::TooManyRequests;
+        response.content = "{\"error\":\"fixture rate limited\"}";
+
+        return IOK;
+    }
+
+///-- recorded
+    response.status = entry.status;
+    response.content = entry.content;
+
+    return IOK;
+}
+
+///-- protected
+IRESULT CHttpFixture::LoadFile() {
+    std::ifstream fs( m_filename );
+
+    if( !fs.is_open() )
+        return IBADENV;
+
+    m_exchanges.clear();
+
+    String key; Entry entry; int status; char cspace;
+
+    while( !fs.eof() ) {
+        bool r =
+            get_cache_field( fs ,key )
+            && fs >> status && fs >> cspace
+            && get_cache_field( fs ,entry.content )
+        ;
+
+        if( !r ) break;
+
+        entry.status = (HttpStatus::Code) status;
+
+        m_exchanges[key].responses.emplace_back( entry );
+    }
+
+    return IOK;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//EOF
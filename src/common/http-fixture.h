@@ -0,0 +1,106 @@
+#pragma once
+
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SOLOMINER_HTTP_FIXTURE_H
+#define SOLOMINER_HTTP_FIXTURE_H
+
+//////////////////////////////////////////////////////////////////////////////
+#include "http.h"
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Config
+
+struct HttpFixtureConfig {
+    int latency = 0; //! ms added to each replayed response
+    int jitter = 0; //! ms, random spread added to latency
+    int errorRate = 0; //! % of requests answered with a server error
+    int timeoutRate = 0; //! % of requests failing as timed out
+    int rateLimit = 0; //! requests per rateInterval before answering 'too many requests', 0 = no limit
+    time_t rateInterval = 60;
+};
+
+template <> HttpFixtureConfig &fromManifest( HttpFixtureConfig &p ,const Params &s );
+template <> Params &toManifest( const HttpFixtureConfig &p ,Params &s );
+
+//////////////////////////////////////////////////////////////////////////////
+//! Fixture
+
+/**
+ * @brief record http exchanges to a fixture file, or replay them in place of the network
+ * @note requests are matched on method, url and body (headers are ignored as they may carry nonce)
+ * @note several recordings of the same request are replayed in turn
+ */
+
+class CHttpFixture : public Singleton_<CHttpFixture> {
+public:
+    enum Mode {
+        fixtureNone=0 ,fixtureRecord ,fixtureReplay
+    };
+
+protected:
+    struct Entry {
+        HttpStatus::Code status;
+        String content;
+    };
+
+    struct Exchange {
+        ListOf<Entry> responses;
+        size_t next = 0;
+    };
+
+    Mode m_mode;
+    String m_filename;
+
+    HttpFixtureConfig m_config;
+
+    MapOf<String,Exchange> m_exchanges; //! request key -> recorded responses
+
+    CServiceQuota m_rate; //! simulated server side rate limit
+
+    CriticalSection m_cs;
+
+public:
+    CHttpFixture() : m_mode(fixtureNone)
+    {}
+
+    Mode mode() const { return m_mode; }
+
+    bool isRecording() const { return m_mode == fixtureRecord; }
+    bool isReplaying() const { return m_mode == fixtureReplay; }
+
+    const HttpFixtureConfig &config() const { return m_config; }
+
+public:
+    IRESULT Record( const char *filename );
+    IRESULT Replay( const char *filename ,const HttpFixtureConfig &config );
+
+    void Close();
+
+public:
+    static String makeKey( const CHttpRequest &request );
+
+    //! @note record mode, append exchange to fixture file
+    void Put( const String &key ,const HttpResponse &response );
+
+    //! @note replay mode, answer as the recorded server would (latency, errors, rate limit)
+    IRESULT Get( const String &key ,HttpResponse &response );
+
+protected:
+    IRESULT LoadFile();
+};
+
+inline CHttpFixture &getHttpFixture() {
+    return CHttpFixture::getInstance();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//////////////////////////////////////////////////////////////////////////////
+#endif //SOLOMINER_HTTP_FIXTURE_H
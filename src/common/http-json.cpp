@@ -0,0 +1,167 @@
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+//////////////////////////////////////////////////////////////////////////////
+#include "http-json.h"
+
+#include <rapidjson/document.h>
+
+#include <fstream>
+#include <sstream>
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Benchmark
+
+namespace {
+
+#define HTTPJSON_BENCH_CHUNK    16384 //! as curl default write size
+
+typedef MapOf<std::string,std::string> JsonBenchItem;
+
+//! @brief payload delivered chunk per chunk, copied as the transfer callback would
+struct JsonChunkStream {
+    typedef char Ch;
+
+    const String &payload;
+
+    String chunk;
+    size_t pos = 0;
+    size_t base = 0;
+
+    JsonChunkStream( const String &a_payload ) : payload(a_payload) {}
+
+    bool Pump() {
+        base += chunk.size(); pos = 0;
+
+        size_t n = MIN( (size_t) HTTPJSON_BENCH_CHUNK ,payload.size() - base );
+
+        chunk.assign( payload.c_str() + base ,n );
+
+        return n > 0;
+    }
+
+    Ch Peek() { return (pos < chunk.size() || Pump()) ? chunk[pos] : '\0'; }
+    Ch Take() { Ch c = Peek(); if( c ) ++pos; return c; }
+    size_t Tell() const { return base + pos; }
+
+    Ch *PutBegin() { assert(false); return NullPtr; }
+    void Put( Ch ) { assert(false); }
+    void Flush() { assert(false); }
+    size_t PutEnd( Ch * ) { assert(false); return 0; }
+};
+
+struct JsonBenchHandler : JsonObjectHandler_<JsonBenchHandler> {
+    ListOf<JsonBenchItem> &list;
+
+    JsonBenchHandler( ListOf<JsonBenchItem> &a_list ) : list(a_list) {
+        objectDepth = 2;
+    }
+
+    void onObject() {
+        list.emplace_back();
+    }
+
+    void onField( const char *key ,const char *value ,size_t length ) {
+        list.back()[key].assign( value ,length );
+    }
+};
+
+//! @brief former path, response accumulated then parsed to a document
+size_t decodeDom( const String &payload ,ListOf<JsonBenchItem> &list ) {
+    String response;
+
+    for( size_t i=0; i<payload.size(); i+=HTTPJSON_BENCH_CHUNK ) {
+        response.append( payload ,i ,HTTPJSON_BENCH_CHUNK );
+    }
+
+    rapidjson::Document doc;
+
+    doc.Parse( response.c_str() );
+
+    if( doc.HasParseError() || !doc.IsArray() )
+        return 0;
+
+    for( auto &v : doc.GetArray() ) {
+        if( !v.IsObject() ) continue;
+
+        list.emplace_back();
+
+        for( auto &m : v.GetObject() ) {
+            std::string &field = list.back()[m.name.GetString()];
+
+            if( m.value.IsString() ) field = m.value.GetString();
+            else if( m.value.IsBool() ) field = m.value.GetBool() ? "true" : "false";
+            else if( m.value.IsNumber() ) field = std::to_string( m.value.GetDouble() );
+        }
+    }
+
+    return response.capacity() + doc.GetAllocator().Capacity();
+}
+
+size_t decodeStream( const String &payload ,ListOf<JsonBenchItem> &list ) {
+    JsonChunkStream stream( payload );
+    JsonBenchHandler handler( list );
+
+    if( IFAILED( parseJsonStream_( stream ,handler ) ) )
+        return 0;
+
+    return stream.chunk.capacity() + handler.key.capacity();
+}
+
+template <class TDecode>
+double timeDecode( const String &payload ,int iterations ,TDecode decode ,size_t &items ,size_t &held ) {
+    OsTimerCycle from = OsTimerGetTimeNow();
+
+    for( int i=0; i<iterations; ++i ) {
+        ListOf<JsonBenchItem> list;
+
+        held = decode( payload ,list );
+        items = list.size();
+    }
+
+    OsTimerCycle elapsed = OsTimerGetElapsed( from ,OsTimerGetTimeNow() );
+
+    return (double) OsTimerConvertToNanosec( elapsed ) / 1e6 / MAX( iterations ,1 );
+}
+
+}
+
+//////////////////////////////////////////////////////////////////////////////
+IRESULT benchJsonDecode( const String &payload ,int iterations ,JsonBenchResult &result ) {
+    result = JsonBenchResult();
+
+    result.size = payload.size();
+
+    size_t domItems = 0 ,streamItems = 0;
+
+    result.domMs = timeDecode( payload ,iterations ,decodeDom ,domItems ,result.domHeld );
+    result.streamMs = timeDecode( payload ,iterations ,decodeStream ,streamItems ,result.streamHeld );
+
+    if( domItems != streamItems || result.domHeld == 0 || result.streamHeld == 0 )
+        return IBADDATA;
+
+    result.items = streamItems;
+
+    return IOK;
+}
+
+IRESULT benchJsonDecodeFile( const char *filename ,int iterations ,JsonBenchResult &result ) {
+    std::ifstream fs( filename ,std::ios::binary );
+
+    if( !fs.is_open() )
+        return INODATA;
+
+    std::stringstream ss; ss << fs.rdbuf();
+
+    return benchJsonDecode( ss.str() ,iterations ,result );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//////////////////////////////////////////////////////////////////////////////
+//EOF
@@ -0,0 +1,185 @@
+#pragma once
+
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SOLOMINER_HTTP_JSON_H
+#define SOLOMINER_HTTP_JSON_H
+
+//////////////////////////////////////////////////////////////////////////////
+#include "http.h"
+
+#include <rapidjson/reader.h>
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Field
+
+//! @brief set a struct member from a json scalar (numbers are passed raw, as string)
+//! @note default uses the struct schema, specialize for types without one
+template <class T>
+void setJsonField_( T &s ,const char *key ,const char *value ,size_t length ) {
+    int m = getMemberId( key ,Schema_<T>::schema );
+
+    if( m < 0 ) return;
+
+    setMember( s ,m ,String( value ,length ) );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! Handlers
+
+/**
+ * @brief SAX handler base for flat json objects
+ * @note scalars at object depth are routed to onField, deeper values are skipped
+ */
+
+template <class THandler>
+struct JsonObjectHandler_ : rapidjson::BaseReaderHandler<rapidjson::UTF8<> ,THandler> {
+    int depth = 0; //! nesting level of current value
+    int objectDepth = 1; //! nesting level of the objects to decode
+
+    std::string key;
+
+    bool Key( const char *str ,rapidjson::SizeType length ,bool ) {
+        if( depth == objectDepth ) key.assign( str ,length );
+
+        return true;
+    }
+
+    bool String( const char *str ,rapidjson::SizeType length ,bool ) {
+        if( depth == objectDepth ) static_cast<THandler*>(this)->onField( key.c_str() ,str ,length );
+
+        return true;
+    }
+
+    bool Bool( bool b ) {
+        return b ? String( "true" ,4 ,false ) : String( "false" ,5 ,false );
+    }
+
+    bool Null() {
+        return String( "" ,0 ,false );
+    }
+
+    bool StartObject() {
+        if( ++depth == objectDepth ) static_cast<THandler*>(this)->onObject();
+
+        return true;
+    }
+
+    bool EndObject( rapidjson::SizeType ) {
+        if( depth-- == objectDepth ) static_cast<THandler*>(this)->onObjectEnd();
+
+        return true;
+    }
+
+    bool StartArray() { ++depth; return true; }
+    bool EndArray( rapidjson::SizeType ) { --depth; return true; }
+
+    //! @note overridden by handler
+    void onObject() {}
+    void onObjectEnd() {}
+    void onField( const char *key ,const char *value ,size_t length ) {}
+};
+
+//! @brief decode a single json object into a struct
+template <class T>
+struct JsonStructHandler_ : JsonObjectHandler_<JsonStructHandler_<T> > {
+    T &s;
+
+    JsonStructHandler_( T &a_s ) : s(a_s) {}
+
+    void onField( const char *key ,const char *value ,size_t length ) {
+        setJsonField_( s ,key ,value ,length );
+    }
+};
+
+//! @brief decode a json array of objects into a list, item per item as they are received
+template <class T>
+struct JsonListHandler_ : JsonObjectHandler_<JsonListHandler_<T> > {
+    ListOf<T> &list;
+
+    JsonListHandler_( ListOf<T> &a_list ) : list(a_list) {
+        this->objectDepth = 2;
+    }
+
+    void onObject() {
+        list.emplace_back();
+    }
+
+    void onField( const char *key ,const char *value ,size_t length ) {
+        setJsonField_( list.back() ,key ,value ,length );
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+//! Parse
+
+#define HTTPJSON_PARSE_FLAGS    (rapidjson::kParseNumbersAsStringsFlag | rapidjson::kParseStopWhenDoneFlag)
+
+//! @brief SAX parse a json document from a stream (or any rapidjson input stream)
+template <class TStream ,class THandler>
+IRESULT parseJsonStream_( TStream &stream ,THandler &handler ) {
+    rapidjson::Reader reader;
+
+    rapidjson::ParseResult ok = reader.Parse<HTTPJSON_PARSE_FLAGS>( stream ,handler );
+
+    return ok ? IOK : IBADDATA;
+}
+
+//! @brief send request and decode the json response while it is being received
+//! @note nothing but the current transfer chunk is kept, no response string nor document is built
+template <class THandler>
+IRESULT sendJsonRequest_( CHttpConnection &http ,CHttpRequest &request ,THandler &handler ) {
+    CHttpStream stream;
+
+    request.headers()["accept"] = "application/json";
+
+    IRESULT ir = http.Stream( request ,stream ); IF_IFAILED_RETURN(ir);
+
+    if( HttpStatus::isError( stream.status() ) )
+        return IERROR;
+
+    ir = parseJsonStream_( stream ,handler );
+
+    iresult_t transfer = stream.Close();
+
+    IF_IFAILED_RETURN(ir);
+
+    return transfer == IPARTIAL ? IOK : transfer; //! @note stopped when done, trailing data ignored
+}
+
+template <class T>
+IRESULT sendJsonRequest_( CHttpConnection &http ,CHttpRequest &request ,ListOf<T> &list ) {
+    JsonListHandler_<T> handler( list );
+
+    return sendJsonRequest_( http ,request ,handler );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! Benchmark
+
+struct JsonBenchResult {
+    size_t size = 0; //! payload bytes
+    size_t items = 0; //! objects decoded
+
+    double domMs = 0.; //! per decode, response string then document
+    double streamMs = 0.; //! per decode, SAX from chunks
+
+    size_t domHeld = 0; //! bytes held besides decoded items
+    size_t streamHeld = 0;
+};
+
+//! @brief decode a json array of objects through both paths
+//! @note payload is fed in transfer sized chunks, IE a recorded market list or transaction list
+IRESULT benchJsonDecode( const String &payload ,int iterations ,JsonBenchResult &result );
+IRESULT benchJsonDecodeFile( const char *filename ,int iterations ,JsonBenchResult &result );
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//////////////////////////////////////////////////////////////////////////////
+#endif //SOLOMINER_HTTP_JSON_H
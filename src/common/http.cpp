@@ -21,6 +21,7 @@
 #include <string>
 
 #include "http.h"
+#include "http-fixture.h"
 
 //////////////////////////////////////////////////////////////////////////////
 //! HttpStatus
@@ -141,13 +142,10 @@ static size_t writeFunction( void *ptr ,size_t size ,size_t nmemb ,struct string
     return size * nmemb;
 }
 
-static iresult_t HttpPerform( const char *url ,HttpMethod method ,const MapOf<std::string,std::string> &headers ,const char *userpass ,const char *body ,HttpResponse &response ,long timeoutMs=10000 ) {
-//-- init
-    CURL * curl = curl_easy_init();
-
+//! @note set request options common to buffered and streamed transfers, return headers list to free after transfer
+static curl_slist *HttpSetup( CURL *curl ,const char *url ,HttpMethod method ,const MapOf<std::string,std::string> &headers ,const char *userpass ,const char *body ,long timeoutMs ) {
     curl_easy_setopt( curl ,CURLOPT_NOSIGNAL ,1 );
     curl_easy_setopt( curl ,CURLOPT_URL ,url );
-    curl_easy_setopt( curl ,CURLOPT_WRITEFUNCTION ,writeFunction );
 
 //-- headers
     struct curl_slist *curl_headers = nullptr;
@@ -173,9 +171,6 @@ static iresult_t HttpPerform( const char *url ,HttpMethod method ,const MapOf<st
     }
 
 //-- method & option
-    struct string s;
-    init( &s );
-
     switch( method ) {
         case HttpMethod::methodGET:
             curl_easy_setopt( curl ,CURLOPT_HTTPGET ,1 );
@@ -192,13 +187,34 @@ static iresult_t HttpPerform( const char *url ,HttpMethod method ,const MapOf<st
             break;
 
         default:
-            return INOEXEC;
+            curl_slist_free_all( curl_headers );
+            return nullptr;
     }
 
-    curl_easy_setopt( curl ,CURLOPT_WRITEDATA ,&s );
     curl_easy_setopt( curl ,CURLOPT_HTTPHEADER ,curl_headers );
     curl_easy_setopt( curl ,CURLOPT_TIMEOUT_MS ,timeoutMs );
 
+    return curl_headers;
+}
+
+static iresult_t HttpPerform( const char *url ,HttpMethod method ,const MapOf<std::string,std::string> &headers ,const char *userpass ,const char *body ,HttpResponse &response ,long timeoutMs=10000 ) {
+//-- init
+    CURL * curl = curl_easy_init();
+
+    struct curl_slist *curl_headers = HttpSetup( curl ,url ,method ,headers ,userpass ,body ,timeoutMs );
+
+    if( !curl_headers ) {
+        curl_easy_cleanup( curl );
+        return INOEXEC;
+    }
+
+    curl_easy_setopt( curl ,CURLOPT_WRITEFUNCTION ,writeFunction );
+
+    struct string s;
+    init( &s );
+
+    curl_easy_setopt( curl ,CURLOPT_WRITEDATA ,&s );
+
 //-- perform
     CURLcode result = curl_easy_perform( curl );
 
@@ -239,6 +255,13 @@ static iresult_t HttpPerform( const char *url ,HttpMethod method ,const MapOf<st
     return IOK;
 }
 
+///-- stream
+static size_t streamFunction( void *ptr ,size_t size ,size_t nmemb ,CHttpStream *stream ) {
+    stream->Append( (const char*) ptr ,size * nmemb );
+
+    return size * nmemb;
+}
+
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -257,10 +280,18 @@ void CHttpRequest::updateCacheControl() {
 
 ///-- synch
 iresult_t CHttpRequest::Send( HttpResponse &response ) {
-    iresult_t result = curl::HttpPerform( m_url.c_str() ,m_method ,m_headers ,m_userpass.c_str() ,m_body.c_str() ,response );
+    CHttpFixture &fixture = getHttpFixture();
+
+    iresult_t result = fixture.isReplaying()
+        ? fixture.Get( CHttpFixture::makeKey(*this) ,response )
+        : curl::HttpPerform( m_url.c_str() ,m_method ,m_headers ,m_userpass.c_str() ,m_body.c_str() ,response );
 
     IF_IFAILED_RETURN(result);
 
+    if( fixture.isRecording() ) {
+        fixture.Put( CHttpFixture::makeKey(*this) ,response );
+    }
+
     m_status = response.status;
     m_response = response.content;
 
@@ -314,6 +345,158 @@ iresult_t CHttpRequest::adviseResponseValid() {
     return IOK;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//! CHttpStream
+
+#define HTTPSTREAM_POLL_MS  100
+
+iresult_t CHttpStream::Open( const CHttpRequest &request ,CHttpCache *cache ,long timeoutMs ) {
+    Close();
+
+    CHttpFixture &fixture = getHttpFixture();
+
+///-- replay
+    if( fixture.isReplaying() ) {
+        HttpResponse response;
+
+        iresult_t ir = fixture.Get( CHttpFixture::makeKey(request) ,response ); IF_IFAILED_RETURN(ir);
+
+        return Open( response.content ,response.status );
+    }
+
+    if( fixture.isRecording() ) {
+        m_recordKey = CHttpFixture::makeKey(request);
+    }
+
+    if( cache ) {
+        m_cache = cache; m_cacheKey = request.url();
+    }
+
+    CURL *curl = curl_easy_init();
+
+    curl_slist *curl_headers = curl::HttpSetup( curl ,request.url().c_str() ,request.method() ,request.headers() ,request.userpass().c_str() ,request.body().c_str() ,timeoutMs );
+
+    if( !curl_headers ) {
+        curl_easy_cleanup( curl );
+        return INOEXEC;
+    }
+
+    curl_easy_setopt( curl ,CURLOPT_WRITEFUNCTION ,curl::streamFunction );
+    curl_easy_setopt( curl ,CURLOPT_WRITEDATA ,this );
+
+    CURLM *multi = curl_multi_init();
+
+    curl_multi_add_handle( multi ,curl );
+
+    m_curl = curl; m_multi = multi; m_headers = curl_headers;
+    m_done = false; m_result = IPROGRESS;
+
+    //! @note receive up to first chunk, status is then known
+    Pump();
+
+    return m_done ? m_result : IOK;
+}
+
+iresult_t CHttpStream::Open( const String &content ,HttpStatus::Code status ) {
+    Close();
+
+    m_status = status;
+    m_chunk = content;
+    m_result = IOK;
+
+    return IOK;
+}
+
+iresult_t CHttpStream::Close() {
+    //! @note a cached response must be complete, receive what the consumer left (IE trailing spaces)
+    if( m_cache && !m_done ) {
+        while( Peek() ) m_pos = m_chunk.size();
+    }
+
+    if( m_multi ) {
+        curl_multi_remove_handle( (CURLM*) m_multi ,(CURL*) m_curl );
+        curl_multi_cleanup( (CURLM*) m_multi );
+    }
+
+    if( m_curl ) curl_easy_cleanup( (CURL*) m_curl );
+    if( m_headers ) curl_slist_free_all( (curl_slist*) m_headers );
+
+    m_curl = m_multi = m_headers = NullPtr;
+
+    m_chunk.clear(); m_base = m_pos = 0;
+
+    m_status = HttpStatus::NotFound;
+    m_recordKey.clear(); m_recorded.clear();
+
+    m_cache = NullPtr; m_cacheKey.clear();
+
+    iresult_t result = m_done ? m_result : IPARTIAL; //! @note closed before end of transfer
+
+    m_done = true; m_result = INOEXEC;
+
+    return result;
+}
+
+HttpStatus::Code CHttpStream::status() const {
+    long http_code = 0;
+
+    if( !m_curl ) return m_status;
+
+    curl_easy_getinfo( (CURL*) m_curl ,CURLINFO_RESPONSE_CODE ,&http_code );
+
+    return (HttpStatus::Code) http_code;
+}
+
+void CHttpStream::Append( const char *data ,size_t size ) {
+    m_chunk.append( data ,size );
+
+    if( !m_recordKey.empty() || m_cache ) m_recorded.append( data ,size );
+}
+
+bool CHttpStream::Pump() {
+    //! @note chunk fully consumed, release it
+    m_base += m_pos; m_pos = 0;
+    m_chunk.clear();
+
+    CURLM *multi = (CURLM*) m_multi;
+
+    while( !m_done ) {
+        int running = 0;
+
+        if( curl_multi_perform( multi ,&running ) != CURLM_OK ) {
+            m_done = true; m_result = IERROR;
+            break;
+        }
+
+        if( running == 0 ) {
+            int nmsg = 0; CURLMsg *msg = curl_multi_info_read( multi ,&nmsg );
+
+            m_done = true;
+            m_result = (msg && msg->msg == CURLMSG_DONE && msg->data.result == CURLE_OK) ? IOK : IERROR;
+
+            if( m_result == IOK && !m_recordKey.empty() ) {
+                HttpResponse response = { status() ,m_recorded };
+
+                getHttpFixture().Put( m_recordKey ,response );
+            }
+
+            if( m_result == IOK && m_cache && !HttpStatus::isError( status() ) ) {
+                m_cache->putCached( m_cacheKey ,m_recorded );
+
+                if( m_cache->cacheDirty() ) m_cache->Save();
+            }
+        }
+
+        if( !m_chunk.empty() )
+            return true;
+
+        if( !m_done )
+            curl_multi_poll( multi ,NullPtr ,0 ,HTTPSTREAM_POLL_MS ,NullPtr );
+    }
+
+    return !m_chunk.empty();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //! CHttpConnection
 
@@ -345,7 +528,7 @@ iresult_t CHttpConnection::makeRequest( const char *url ,HttpMethod method ,cons
 }
 
 iresult_t CHttpConnection::Send( CHttpRequest &request ,HttpResponse &response ) {
-    bool canRequest = quota().canRequest();
+    bool canRequest = quota().canRequest( request.priority() );
 
     iresult_t ir;
 
@@ -361,16 +544,45 @@ iresult_t CHttpConnection::Send( CHttpRequest &request ,HttpResponse &response )
     }
 
 ///-- quota
-    if( !canRequest )
-        return IREFUSED;
+    //! @note queue behind higher priority requests until a token is available
+    ir = quota().Acquire( request.priority() ); IF_IFAILED_RETURN(ir);
 
 ///-- send
     request.m_connection = this;
 
     ir = request.Send( response ); IF_IFAILED_RETURN(ir);
 
-///-- handle response
-    quota().accountRequest();
+    return IOK;
+}
+
+iresult_t CHttpConnection::Stream( CHttpRequest &request ,CHttpStream &stream ) {
+    bool canRequest = quota().canRequest( request.priority() );
+
+    request.updateCacheControl();
+
+    bool cacheable = request.method() == HttpMethod::methodGET && request.cacheControl().empty();
+
+///-- cached
+    if( cacheable ) {
+        String content;
+
+        if( cache().getCached( request.url() ,content ,!canRequest ) ) {
+            request.m_cached = true;
+            request.m_status = HttpStatus::OK;
+
+            return stream.Open( content );
+        }
+    }
+
+///-- quota
+    iresult_t ir = quota().Acquire( request.priority() ); IF_IFAILED_RETURN(ir);
+
+///-- stream
+    request.m_connection = this;
+
+    ir = stream.Open( request ,cacheable ? &m_cache : NullPtr ); IF_IFAILED_RETURN(ir);
+
+    request.m_status = stream.status();
 
     return IOK;
 }
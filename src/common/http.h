@@ -193,6 +193,8 @@ protected:
 
     iresult_t m_result;
 
+    QuotaPriority m_priority; //! scheduling class against connection quota
+
 ///-- response
     HttpStatus::Code m_status;
     String m_response;
@@ -208,18 +210,20 @@ public:
     CHttpRequest( CHttpConnection *connection=NullPtr ) :
         m_connection(connection) ,m_listener(NullPtr)
         ,m_method(HttpMethod::methodGET)
-        ,m_result(INOEXEC)
+        ,m_result(INOEXEC) ,m_priority(quotaDefault)
         ,m_status(HttpStatus::NotFound)
         ,m_cacheValidity(60) ,m_cached(false)
     {}
 
     const String &url() const { return m_url; }
+    const String &userpass() const { return m_userpass; }
     const MapOf<String,String> &headers() const { return m_headers; }
 
     const HttpMethod &method() const { return m_method; }
     const String &body() const { return m_body; }
 
     iresult_t result() const { return m_result; }
+    QuotaPriority priority() const { return m_priority; }
 
     HttpStatus::Code status() const { return m_status; }
     const String &response() const { return m_response; }
@@ -235,6 +239,8 @@ public:
     HttpMethod &method() { return m_method; }
     String &body() { return m_body; }
 
+    QuotaPriority &priority() { return m_priority; }
+
     HttpStatus::Code &result() { return m_status; }
     String &response() { return m_response; }
 
@@ -281,6 +287,88 @@ public: ///-- CHttpConnection
     IAPI_DECL adviseResponseValid();
 };
 
+//////////////////////////////////////////////////////////////////////////////
+//! Stream
+
+/**
+ * @brief pull stream over a running transfer (rapidjson input stream concept)
+ * @note the transfer is pumped as the consumer reads, only the current received chunk is held in memory
+ */
+
+class CHttpStream {
+public:
+    typedef char Ch;
+
+protected:
+    void *m_curl;
+    void *m_multi;
+    void *m_headers;
+
+    String m_chunk; //! last chunk received
+    size_t m_pos; //! read position in chunk
+    size_t m_base; //! bytes consumed before chunk
+
+    bool m_done;
+    iresult_t m_result; //! transfer result when done
+
+    HttpStatus::Code m_status; //! status when not from transfer (replay, cache)
+
+    String m_recordKey; //! fixture recording
+    String m_recorded;
+
+    CHttpCache *m_cache; //! response cache, set when response is cacheable
+    String m_cacheKey;
+
+public:
+    CHttpStream() :
+        m_curl(NullPtr) ,m_multi(NullPtr) ,m_headers(NullPtr)
+        ,m_pos(0) ,m_base(0)
+        ,m_done(true) ,m_result(INOEXEC)
+        ,m_status(HttpStatus::NotFound)
+        ,m_cache(NullPtr)
+    {}
+
+    ~CHttpStream() {
+        Close();
+    }
+
+    //! @note response is put in cache, if provided, once fully received
+    IAPI_DECL Open( const CHttpRequest &request ,CHttpCache *cache=NullPtr ,long timeoutMs=10000 );
+    IAPI_DECL Open( const String &content ,HttpStatus::Code status=HttpStatus::OK );
+    IAPI_DECL Close();
+
+    HttpStatus::Code status() const;
+
+    bool isEnd() {
+        return Peek() == '\0';
+    }
+
+public: ///-- rapidjson stream
+    Ch Peek() {
+        return (m_pos < m_chunk.size() || Pump()) ? m_chunk[m_pos] : '\0';
+    }
+
+    Ch Take() {
+        Ch c = Peek(); if( c ) ++m_pos;
+
+        return c;
+    }
+
+    size_t Tell() const { return m_base + m_pos; }
+
+    //! @note read only
+    Ch *PutBegin() { assert(false); return NullPtr; }
+    void Put( Ch ) { assert(false); }
+    void Flush() { assert(false); }
+    size_t PutEnd( Ch * ) { assert(false); return 0; }
+
+public: ///-- transfer callback
+    void Append( const char *data ,size_t size );
+
+protected:
+    bool Pump();
+};
+
 //////////////////////////////////////////////////////////////////////////////
 //! Connection
 
@@ -309,6 +397,10 @@ public: ///-- request
     //! Poll
     IAPI_DECL Send( CHttpRequest &request );
 
+    //! Stream
+    //! @note consumer reads the body from stream as it is received, cached responses are streamed from memory
+    IAPI_DECL Stream( CHttpRequest &request ,CHttpStream &stream );
+
 public:
 ///-- callback
     IAPI_DECL adviseRequestValid( const CHttpRequest &request );
@@ -0,0 +1,222 @@
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+//////////////////////////////////////////////////////////////////////////////
+#include "notify.h"
+
+//////////////////////////////////////////////////////////////////////////////
+#ifndef PLATFORM_WINDOWS
+ #include <unistd.h>
+ #include <fcntl.h>
+ #include <sys/socket.h>
+ #include <sys/un.h>
+ #include <limits.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Event
+
+static const char *g_notifyTypeNames[] = {
+    "wallet" ,"block"
+};
+
+bool fromNotifyMessage( NotifyEvent &event ,const char *message ) {
+    std::istringstream ss( message ); //! @note plain word extraction, not common.h StringStream >> operator
+
+    String type;
+
+    if( !(ss >> type >> event.coin >> event.id) )
+        return false;
+
+    if( type == g_notifyTypeNames[notifyWallet] )
+        event.type = notifyWallet;
+    else if( type == g_notifyTypeNames[notifyBlock] )
+        event.type = notifyBlock;
+    else
+        return false;
+
+    return true;
+}
+
+String &toNotifyMessage( const NotifyEvent &event ,String &message ) {
+    message = g_notifyTypeNames[ event.type ];
+
+    message += ' '; message += event.coin;
+    message += ' '; message += event.id;
+
+    return message;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! CNotifyListener
+
+#ifndef PLATFORM_WINDOWS
+
+static bool makeSocketAddress( struct sockaddr_un &addr ,const char *path ) {
+    memset( &addr ,0 ,sizeof(addr) );
+
+    addr.sun_family = AF_UNIX;
+
+    if( strlen(path) >= sizeof(addr.sun_path) )
+        return false;
+
+    strcpy( addr.sun_path ,path );
+
+    return true;
+}
+
+IRESULT CNotifyListener::Open( const char *path ) {
+    if( isOpen() ) return IALREADY;
+
+    //! @note hooks are run from daemon directory, path must be absolute
+    if( path[0] != '/' ) {
+        char cwd[PATH_MAX];
+
+        if( getcwd( cwd ,sizeof(cwd) ) == NullPtr )
+            return IBADENV;
+
+        m_path = cwd; m_path += '/'; m_path += path;
+    } else {
+        m_path = path;
+    }
+
+    struct sockaddr_un addr;
+
+    if( !makeSocketAddress( addr ,m_path.c_str() ) )
+        return IBADARGS;
+
+    int fd = socket( AF_UNIX ,SOCK_DGRAM ,0 );
+
+    if( fd < 0 ) return IBADENV;
+
+    unlink( m_path.c_str() ); //! @note stale socket from a previous run
+
+    if( bind( fd ,(struct sockaddr*) &addr ,sizeof(addr) ) != 0 ) {
+        close( fd );
+        return IERROR;
+    }
+
+    fcntl( fd ,F_SETFL ,fcntl( fd ,F_GETFL ,0 ) | O_NONBLOCK );
+
+    m_socket = fd;
+
+    return IOK;
+}
+
+void CNotifyListener::Close() {
+    if( !isOpen() ) return;
+
+    close( m_socket ); m_socket = -1;
+
+    unlink( m_path.c_str() );
+}
+
+int CNotifyListener::Dispatch() {
+    if( !isOpen() ) return 0;
+
+    char message[NOTIFY_MESSAGE_MAX+1];
+
+    int n = 0;
+
+    for( ;; ) {
+        ssize_t size = recv( m_socket ,message ,NOTIFY_MESSAGE_MAX ,0 );
+
+        if( size <= 0 ) break; //! @note EAGAIN, nothing pending
+
+        message[size] = 0;
+
+        NotifyEvent event;
+
+        if( !fromNotifyMessage( event ,message ) ) continue;
+
+        auto it = m_subscribers.find( event.coin );
+
+        if( it == m_subscribers.end() ) continue;
+
+        //! @note copy, listener may revoke from its handler
+        ListOf<INotifyEvents*> listeners = it->second;
+
+        for( auto *listener : listeners ) {
+            listener->onNotify( event );
+        }
+
+        ++n;
+    }
+
+    return n;
+}
+
+IRESULT CNotifyListener::Send( const char *path ,const char *message ) {
+    struct sockaddr_un addr;
+
+    if( !makeSocketAddress( addr ,path ) )
+        return IBADARGS;
+
+    int fd = socket( AF_UNIX ,SOCK_DGRAM ,0 );
+
+    if( fd < 0 ) return IBADENV;
+
+    ssize_t size = sendto( fd ,message ,strlen(message) ,0 ,(struct sockaddr*) &addr ,sizeof(addr) );
+
+    close( fd );
+
+    return size >= 0 ? IOK : IERROR;
+}
+
+String CNotifyListener::makeHookCommand( NotifyType type ,const char *coin ) {
+    char exe[PATH_MAX];
+
+    ssize_t size = readlink( "/proc/self/exe" ,exe ,sizeof(exe)-1 );
+
+    if( !isOpen() || size <= 0 ) return "";
+
+    exe[size] = 0;
+
+    StringStream ss;
+
+    ss << '\'' << exe << "' --notify '" << m_path << "' " << g_notifyTypeNames[type] << ' ' << coin << " %s";
+
+    return ss.str();
+}
+
+#else //! PLATFORM_WINDOWS
+
+IRESULT CNotifyListener::Open( const char *path ) { return INOEXEC; }
+
+void CNotifyListener::Close() {}
+
+int CNotifyListener::Dispatch() { return 0; }
+
+IRESULT CNotifyListener::Send( const char *path ,const char *message ) { return INOEXEC; }
+
+String CNotifyListener::makeHookCommand( NotifyType type ,const char *coin ) { return ""; }
+
+#endif
+
+///--
+void CNotifyListener::Subscribe( const char *coin ,INotifyEvents &listener ) {
+    auto &listeners = m_subscribers[coin];
+
+    for( auto *it : listeners ) {
+        if( it == &listener ) return;
+    }
+
+    listeners.emplace_back( &listener );
+}
+
+void CNotifyListener::Revoke( const char *coin ,INotifyEvents &listener ) {
+    auto &listeners = m_subscribers[coin];
+
+    for( auto it = listeners.begin(); it != listeners.end(); ) {
+        if( *it == &listener ) it = listeners.erase( it ); else ++it;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//EOF
@@ -0,0 +1,97 @@
+#pragma once
+
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SOLOMINER_NOTIFY_H
+#define SOLOMINER_NOTIFY_H
+
+//////////////////////////////////////////////////////////////////////////////
+#include "common.h"
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! Event
+
+#define NOTIFY_SOCKET_DEFAULT   "solominer-notify.sock"
+#define NOTIFY_MESSAGE_MAX      512
+
+enum NotifyType {
+    notifyWallet=0 //! -walletnotify, id is a transaction id
+    ,notifyBlock //! -blocknotify, id is a block hash
+};
+
+struct NotifyEvent {
+    NotifyType type;
+
+    String coin;
+    String id;
+};
+
+//! @note message format is "<wallet|block> <COIN> <id>"
+bool fromNotifyMessage( NotifyEvent &event ,const char *message );
+String &toNotifyMessage( const NotifyEvent &event ,String &message );
+
+//////////////////////////////////////////////////////////////////////////////
+//! Listener
+
+struct INotifyEvents {
+    virtual void onNotify( const NotifyEvent &event ) = 0;
+};
+
+/**
+ * @brief receive core daemons walletnotify/blocknotify events on a local socket
+ * @note daemons are started with hooks running 'solominer --notify <socket> <message>'
+ * @note events are dispatched from main loop, subscribers are called on main thread
+ */
+
+class CNotifyListener : public Singleton_<CNotifyListener> {
+protected:
+    int m_socket; //! bound datagram socket, -1 if not open
+    String m_path; //! socket path, absolute
+
+    MapOf<String,ListOf<INotifyEvents*> > m_subscribers; //! coin -> listeners
+
+public:
+    CNotifyListener() : m_socket(-1)
+    {}
+
+    ~CNotifyListener() {
+        Close();
+    }
+
+    bool isOpen() const { return m_socket >= 0; }
+
+    const String &path() const { return m_path; }
+
+public:
+    IRESULT Open( const char *path );
+    void Close();
+
+    void Subscribe( const char *coin ,INotifyEvents &listener );
+    void Revoke( const char *coin ,INotifyEvents &listener );
+
+    //! @brief dispatch all pending events, non blocking
+    //! @return number of events dispatched
+    int Dispatch();
+
+public:
+    //! @brief send a message to a listener socket (notifier side)
+    static IRESULT Send( const char *path ,const char *message );
+
+    //! @brief command line for a daemon hook, '%s' is left for the daemon to replace
+    String makeHookCommand( NotifyType type ,const char *coin );
+};
+
+inline CNotifyListener &getNotifyListener() {
+    return CNotifyListener::getInstance();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//////////////////////////////////////////////////////////////////////////////
+#endif //SOLOMINER_NOTIFY_H
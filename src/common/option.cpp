@@ -38,5 +38,41 @@ const std::string &getOptConfigFile() {
     return g_optConfigFile;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+std::string g_optHttpRecord;
+std::string g_optHttpReplay;
+std::string g_optHttpFixture;
+
+const std::string &getOptHttpRecord() {
+    return g_optHttpRecord;
+}
+
+const std::string &getOptHttpReplay() {
+    return g_optHttpReplay;
+}
+
+const std::string &getOptHttpFixture() {
+    return g_optHttpFixture;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+std::string g_optBenchJson;
+int g_optBenchIterations = 100;
+
+const std::string &getOptBenchJson() {
+    return g_optBenchJson;
+}
+
+int getOptBenchIterations() {
+    return g_optBenchIterations;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool g_optSelfTest = false;
+
+bool getOptSelfTest() {
+    return g_optSelfTest;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //EOF
\ No newline at end of file
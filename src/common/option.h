@@ -40,5 +40,38 @@ extern std::string g_optConfigFile;
 void setOptConfigFile( const char *filename );
 const std::string &getOptConfigFile();
 
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief http fixture, record http exchanges to file or replay them offline
+ */
+
+extern std::string g_optHttpRecord;
+extern std::string g_optHttpReplay;
+extern std::string g_optHttpFixture; //! replay behavior, IE "latency=200; jitter=100; errors=5; timeouts=1; limit=10; interval=60;"
+
+const std::string &getOptHttpRecord();
+const std::string &getOptHttpReplay();
+const std::string &getOptHttpFixture();
+
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief json decode benchmark, payload file and number of decodes
+ */
+
+extern std::string g_optBenchJson;
+extern int g_optBenchIterations;
+
+const std::string &getOptBenchJson();
+int getOptBenchIterations();
+
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief run checks instead of the miner
+ */
+
+extern bool g_optSelfTest;
+
+bool getOptSelfTest();
+
 //////////////////////////////////////////////////////////////////////////////
 #endif //SOLOMINER_OPTION_H
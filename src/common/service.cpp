@@ -12,27 +12,153 @@ namespace solominer {
 //////////////////////////////////////////////////////////////////////////////
 //! CServiceQuota
 
-void CServiceQuota::Tidy() {
-    time_t now = Now();
+#define QUOTA_WAIT_SLICE    100 //! ms, max sleep between two admission checks
 
-    for( auto it = m_times.begin(); it != m_times.end(); )
-    {
-        if( *it + m_interval < now ) {
-            it = m_times.erase(it); --m_requests;
+static const double g_quotaReserve[QUOTA_PRIORITY_COUNT] = {
+    0. ,.10 ,.25 ,.50 //! fraction of bucket a priority class leaves to higher classes
+};
+
+///-- persistence
+void CServiceQuota::Load( const char *persistfile ) {
+    if( persistfile[0] ) m_persist = persistfile;
+    if( m_persist.empty() ) return;
+
+    std::ifstream fs( m_persist );
+
+    double tokens; long long savedAt; char cspace;
+
+    if( fs.is_open() && fs >> tokens && fs >> cspace && fs >> savedAt ) {
+        CriticalSection::Guard guard(m_cs);
+
+        //! @note saved with wall clock time, timer time does not span runs
+        TimeMilli now = OsTimerNow();
+        TimeMilli elapsed = (TimeMilli) CLAMP( (long long) time(NullPtr) - savedAt ,0LL ,(long long) m_interval ) * 1000;
+
+        m_tokens = CLAMP( tokens ,0. ,(double) m_limit );
+        m_refillTime = now > elapsed ? now - elapsed : 0;
+    }
+}
+
+void CServiceQuota::Save() {
+    if( m_persist.empty() ) return;
+
+    std::ofstream fs( m_persist );
+
+    CriticalSection::Guard guard(m_cs);
+
+    Refill();
+
+    if( fs.is_open() ) {
+        fs << m_tokens << ':' << (long long) time(NullPtr);
+    }
+}
+
+///-- admission
+bool CServiceQuota::canRequest( QuotaPriority priority ) {
+    if( !isLimited() ) return true;
+
+    CriticalSection::Guard guard(m_cs);
+
+    Refill();
+
+    return canTake( priority );
+}
+
+bool CServiceQuota::tryRequest( QuotaPriority priority ) {
+    if( !isLimited() ) return true;
+
+    CriticalSection::Guard guard(m_cs);
+
+    Refill();
+
+    if( !canTake( priority ) )
+        return false;
+
+    m_tokens -= 1.;
+
+    return true;
+}
+
+IRESULT CServiceQuota::Acquire( QuotaPriority priority ,uint32_t maxWaitMs ) {
+    if( !isLimited() ) return IOK;
+
+    TimeMilli deadline = OsTimerNow() + maxWaitMs;
+
+    int p = (int) CLAMP( priority ,0 ,QUOTA_PRIORITY_COUNT-1 );
+
+    m_cs.Enter(); ++m_waiting[p];
+
+    for(;;) {
+        Refill();
+
+        if( canTake( priority ) ) {
+            m_tokens -= 1.; --m_waiting[p];
+            m_cs.Leave();
+
+            return IOK;
         }
-        else {
-            ++it;
+
+        //! time until enough tokens for this class (NB prior waiters may take them first)
+        double rate = (double) m_limit / (m_interval * 1000.); //! tokens per ms
+        double missing = 1. + getReserve( priority ) - m_tokens;
+
+        TimeMilli waitMs = (TimeMilli) MAX( missing / rate ,1. );
+        TimeMilli now = m_refillTime;
+
+        if( now >= deadline ) {
+            --m_waiting[p];
+            m_cs.Leave();
+
+            return IREFUSED;
         }
+
+        waitMs = MIN( MIN( waitMs ,(TimeMilli) QUOTA_WAIT_SLICE ) ,deadline - now );
+
+        m_cs.Leave();
+        OsSleep( (uint32_t) waitMs );
+        m_cs.Enter();
     }
 }
 
 void CServiceQuota::accountRequest() {
-    time_t now = Now();
+    if( !isLimited() ) return;
+
+    CriticalSection::Guard guard(m_cs);
+
+    Refill();
 
-    m_times.emplace_back( now );
-    ++m_requests;
+    m_tokens = MAX( m_tokens - 1. ,0. );
+}
+
+///-- protected
+void CServiceQuota::Refill() {
+    TimeMilli now = OsTimerNow();
+
+    if( now <= m_refillTime ) return;
+
+    double rate = (double) m_limit / (m_interval * 1000.); //! tokens per ms
+
+    m_tokens = MIN( m_tokens + (now - m_refillTime) * rate ,(double) m_limit );
+    m_refillTime = now;
+}
+
+double CServiceQuota::getReserve( QuotaPriority priority ) const {
+    int p = (int) CLAMP( priority ,0 ,QUOTA_PRIORITY_COUNT-1 );
+
+    //! @note a class always has one token of the bucket to take
+    return MIN( g_quotaReserve[p] * m_limit ,(double) MAX( m_limit-1 ,0 ) );
+}
+
+bool CServiceQuota::hasPriorWaiting( QuotaPriority priority ) const {
+    for( int i=0; i<(int) priority && i<QUOTA_PRIORITY_COUNT; ++i ) {
+        if( m_waiting[i] > 0 ) return true;
+    }
+
+    return false;
+}
 
-    Tidy();
+bool CServiceQuota::canTake( QuotaPriority priority ) const {
+    return !hasPriorWaiting( priority ) && m_tokens >= 1. + getReserve( priority );
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -143,47 +143,83 @@ public:
 };
 
 //////////////////////////////////////////////////////////////////////////////
+//! Quota
+
+enum QuotaPriority {
+    quotaTrading=0  //! orders and withdrawals
+    ,quotaAccount   //! balances, deposits, order status
+    ,quotaDefault
+    ,quotaRefresh   //! dashboard and periodic info refresh
+};
+
+#define QUOTA_PRIORITY_COUNT    4
+#define QUOTA_WAIT_DEFAULT      10000 //! max time (ms) a request is queued before being refused
+
+/**
+ * @brief token bucket request scheduler
+ * @note bucket holds up to 'limit' tokens and refills at limit/interval tokens per second
+ * @note lower priority classes leave a reserve of tokens to higher ones and yield to their queued requests
+ */
+
 class CServiceQuota {
 protected:
-    int m_limit; //! request limit per interval
-    time_t m_interval;
+    int m_limit; //! bucket capacity, IE request limit per interval
+    time_t m_interval; //! seconds to refill an empty bucket
 
-    ListOf<time_t> m_times;
+    double m_tokens; //! tokens currently available
+    TimeMilli m_refillTime; //! last refill (ms)
 
-    time_t m_synth; //! last synth time
-    int m_requests; //! last synth request
+    int m_waiting[QUOTA_PRIORITY_COUNT]; //! queued requests per priority class
 
-    //TODO ... delay between calls ... here or in http ??
+    CriticalSection m_cs;
 
 protected:
-    String m_persist; //TODO
+    String m_persist;
 
 public:
     CServiceQuota( int limit=0 ,time_t interval=0 ) :
         m_limit(limit) ,m_interval(interval)
+        ,m_tokens(limit) ,m_refillTime(OsTimerNow())
     {
-        time( &m_synth );
-        m_synth = time(NullPtr);
-        m_requests = 0;
-
-        //TODO persist
+        memset( m_waiting ,0 ,sizeof(m_waiting) );
     }
 
     int &limit() { return m_limit; }
     time_t &interval() { return m_interval; }
 
     void setLimit( int limit ,time_t interval ) {
+        CriticalSection::Guard guard(m_cs);
+
+        m_tokens = isLimited() ? MIN( m_tokens ,(double) limit ) : limit;
         m_limit = limit; m_interval = interval;
     }
 
-public:
-    bool canRequest() const {
-        return (m_interval == 0 || m_requests < m_limit);
+    bool isLimited() const {
+        return m_limit > 0 && m_interval > 0;
     }
 
-    void Tidy();
+public:
+    //! @note "tokens:time", tokens left and wall clock time they were counted at
+    void Load( const char *persistfile="" );
+    void Save();
+
+public:
+    //! @note non blocking, check only (canRequest) or check and take (tryRequest)
+    bool canRequest( QuotaPriority priority=quotaDefault );
+    bool tryRequest( QuotaPriority priority=quotaDefault );
+
+    //! @note queue until a token is available for this priority, refuse after maxWaitMs
+    IRESULT Acquire( QuotaPriority priority=quotaDefault ,uint32_t maxWaitMs=QUOTA_WAIT_DEFAULT );
 
+    //! @note account a request made outside of the scheduler
     void accountRequest();
+
+protected:
+    void Refill();
+
+    double getReserve( QuotaPriority priority ) const;
+    bool hasPriorWaiting( QuotaPriority priority ) const;
+    bool canTake( QuotaPriority priority ) const;
 };
 
 //////////////////////////////////////////////////////////////////////////////
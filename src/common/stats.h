@@ -12,6 +12,9 @@
 #include <tiny.h>
 
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
 #include <vector>
 
 //////////////////////////////////////////////////////////////////////////////
@@ -38,12 +41,33 @@ struct StatValue_ {
 typedef StatValue_<double>  StatValue;
 
 //////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief ring of stat values, one per time unit, current time last
+ * @note window aggregates are kept as values are recorded and evicted,
+ *      bounds are only walked again when an extreme leaves the window
+ */
+
 class Stats {
 public:
     enum TimeUnit {
         MilliSecond ,Second ,Minute ,Hour ,Day ,Week ,Month ,year
     };
 
+    //! @brief seconds per time unit, 0 below a second
+    static time_t getTimeUnitPeriod( TimeUnit unit ) {
+        switch( unit ) {
+            default:
+            case MilliSecond: return 0;
+            case Second: return 1;
+            case Minute: return 60;
+            case Hour: return 3600;
+            case Day: return 86400;
+            case Week: return 7 * 86400;
+            case Month: return 30 * 86400;
+            case year: return 365 * 86400;
+        }
+    }
+
 protected:
     StatValue *m_values;
     int m_nValues; //! number of stat value in chart
@@ -52,6 +76,16 @@ protected:
 
     int m_currentTime;
 
+    //-- window aggregates
+    double m_sum; //! sum of values
+    int m_filled; //! values with a positive sum
+    int m_samples; //! samples recorded in window
+
+    StatValue m_bounds; //! mini/maxi of value sums
+    StatValue m_limits; //! mini/maxi of value samples
+
+    bool m_hasBounds ,m_hasLimits; //! false when an extreme was evicted
+
 public:
     Stats( int n=0 ,TimeUnit timeUnit=TimeUnit::Second ) :
         m_values(nullptr) ,m_nValues(0) ,m_timeUnit(timeUnit) ,m_currentTime(0)
@@ -67,16 +101,25 @@ public:
         return m_nValues;
     }
 
-    StatValue &getStat( int t ) {
-        int i = (m_nValues + t) % m_nValues;
+    const StatValue &getStat( int t ) {
+        int i = ((t % m_nValues) + m_nValues) % m_nValues;
 
-        return m_values[ CLAMP( i ,0 ,m_nValues ) ];
+        return m_values[ CLAMP( i ,0 ,m_nValues-1 ) ];
     }
 
     int getCurrentTime() {
         return m_currentTime;
     }
 
+    //! @brief true if time is within the window
+    bool hasStat( int t ) {
+        return t <= m_currentTime && t > m_currentTime - m_nValues;
+    }
+
+    TimeUnit getTimeUnit() const {
+        return m_timeUnit;
+    }
+
 public: ///-- recording
     void Start( int t ) {
         m_currentTime = t;
@@ -85,35 +128,56 @@ public: ///-- recording
     void Record( double v ,int t ) {
         if( m_values && m_nValues ) {} else return;
 
+        if( t <= m_currentTime - m_nValues ) return; //! @note out of window
+
         int t0 = MIN( t ,getCurrentTime() );
         int n = (t - t0) + 1;
 
+        //! @note past a whole ring, only last values remain
+        t0 = MAX( t0 ,t - m_nValues + 1 );
+
         //! spreading mean of value from t0 to t
         for( int i=t0; i<=t; ++i ) {
-            StatValue &value = getStat(i);
+            StatValue &value = m_values[ ((i % m_nValues) + m_nValues) % m_nValues ];
+            StatValue previous = value;
 
             if( i > m_currentTime ) {
                 value.Zero();
             }
 
             value.Add( v/n );
+
+            updateValue( previous ,value );
         }
 
-        m_currentTime = t;
+        m_currentTime = MAX( t ,m_currentTime );
     }
 
-    double getAvg() {
-        if( m_values && m_nValues ) {} else return 0.;
+    //! @brief move current time to t, values in between are emptied
+    void Advance( int t ) {
+        if( m_values && m_nValues ) {} else return;
+
+        for( int i=MAX( m_currentTime+1 ,t - m_nValues + 1 ); i<=t; ++i ) {
+            StatValue &value = m_values[ ((i % m_nValues) + m_nValues) % m_nValues ];
+            StatValue previous = value;
 
-        double sum = 0.; int n=0;
+            value.Zero();
 
-        for( int i=0; i<m_nValues; ++i ) if( m_values[i].sum > 0 ) {
-            sum += m_values[i].sum; ++n;
+            updateValue( previous ,value );
         }
 
-        return n ? sum / n : 0.;
+        m_currentTime = MAX( t ,m_currentTime );
+    }
+
+    //! @brief average sum of values with a positive sum
+    double getAvg() {
+        return m_filled > 0 ? m_sum / m_filled : 0.;
     }
 
+    double getSum() const { return m_sum; }
+
+    int getSampleCount() const { return m_samples; }
+
 public:
     void Reset( int n ) {
         if( m_values ) {
@@ -127,41 +191,241 @@ public:
                 m_values[i].Zero();
             }
         }
+
+        Rebuild();
     }
 
-    /* void Record( double v ,int t ) {
-        if( m_values && m_nValues ) {} else return;
+    void Reset( int n ,TimeUnit timeUnit ) {
+        m_timeUnit = timeUnit; Reset( n );
+    }
 
-        StatValue &value = getStat(t);
+    //! @brief recompute window aggregates from values (after a load)
+    void Rebuild() {
+        m_sum = 0.; m_filled = 0; m_samples = 0;
 
-        if( t != m_currentTime ) {
-            value.Zero(); m_currentTime = t;
-        }
+        m_bounds.Zero(); m_limits.Zero();
 
-        value.Add( v );
-    } */
+        m_hasBounds = m_hasLimits = true;
 
-    void findBounds( double &mini ,double &maxi ) {
         for( int i=0; i<m_nValues; ++i ) {
-            double avg = m_values[i].sum; // getAvg(); // => both MODE //TODO sort that out
+            addValue( m_values[i] );
+        }
+    }
 
-            mini = (i==0 || mini > avg) ? avg : mini;
-            maxi = (i==0 || maxi < avg) ? avg : maxi;
+    void findBounds( double &mini ,double &maxi ) {
+        if( !m_hasBounds ) {
+            m_bounds.Zero();
+
+            for( int i=0; i<m_nValues; ++i ) m_bounds.Add( m_values[i].sum );
+
+            m_hasBounds = true;
         }
+
+        mini = m_bounds.mini; maxi = m_bounds.maxi;
     }
 
     void findLimits( double &mini ,double &maxi ) {
-        for( int i=0; i<m_nValues; ++i ) {
-            StatValue &v = m_values[i];
+        if( !m_hasLimits ) {
+            m_limits.Zero();
+
+            for( int i=0; i<m_nValues; ++i ) {
+                m_limits.Add( m_values[i].mini ); m_limits.Add( m_values[i].maxi );
+            }
+
+            m_hasLimits = true;
+        }
+
+        mini = m_limits.mini; maxi = m_limits.maxi;
+    }
+
+public: ///-- persistence
+    //! @note raw values, same build only
+    bool Write( FILE *file ) {
+        int32_t header[2] = { m_nValues ,m_currentTime };
+
+        return fwrite( header ,sizeof(header) ,1 ,file ) == 1
+            && (m_nValues == 0 || fwrite( m_values ,sizeof(StatValue) * m_nValues ,1 ,file ) == 1)
+        ;
+    }
+
+    bool Read( FILE *file ) {
+        int32_t header[2];
+
+        if( fread( header ,sizeof(header) ,1 ,file ) != 1 || header[0] != m_nValues ) return false;
+
+        std::vector<StatValue> values( m_nValues );
+
+        if( m_nValues > 0 && fread( values.data() ,sizeof(StatValue) * m_nValues ,1 ,file ) != 1 )
+            return false;
+
+        memcpy( m_values ,values.data() ,sizeof(StatValue) * m_nValues );
+
+        m_currentTime = header[1];
+
+        Rebuild();
+
+        return true;
+    }
+
+protected:
+    void addValue( const StatValue &value ) {
+        if( value.sum > 0 ) {
+            m_sum += value.sum; ++m_filled;
+        }
+
+        m_samples += value.n;
+
+        if( m_hasBounds ) m_bounds.Add( value.sum );
+
+        if( m_hasLimits ) {
+            m_limits.Add( value.mini ); m_limits.Add( value.maxi );
+        }
+    }
 
-            mini = (i==0 || mini > v.mini) ? v.mini : mini;
-            maxi = (i==0 || maxi < v.maxi) ? v.maxi : maxi;
+    void updateValue( const StatValue &previous ,const StatValue &value ) {
+        if( previous.sum > 0 ) {
+            m_sum -= previous.sum; --m_filled;
         }
+
+        m_samples -= previous.n;
+
+        //! @note bounds only need a walk when an extreme moves inward
+        if( (previous.sum == m_bounds.mini && value.sum > previous.sum) || (previous.sum == m_bounds.maxi && value.sum < previous.sum) )
+            m_hasBounds = false;
+
+        if( (previous.mini == m_limits.mini && value.mini > previous.mini) || (previous.maxi == m_limits.maxi && value.maxi < previous.maxi) )
+            m_hasLimits = false;
+
+        addValue( value );
     }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief round robin stats at second, minute, hour and day resolution
+ * @note each sample is rolled up into all tiers as it is recorded,
+ *      long range charts read a coarse tier instead of walking a fine one
+ */
+
+#define STATARCHIVE_MAGIC       "SMSTATS"
+#define STATARCHIVE_VERSION     1
 
+class StatArchive {
 public:
-    // ... void convertTimeUnit( Stats &stats ) {}
+    enum Tier {
+        tierSecond=0 ,tierMinute ,tierHour ,tierDay
+        ,tierCount
+    };
+
+    static Stats::TimeUnit getTierUnit( Tier tier ) {
+        return (Stats::TimeUnit) (Stats::Second + CLAMP( (int) tier ,0 ,(int) tierCount-1 ));
+    }
+
+    static time_t getTierPeriod( Tier tier ) {
+        return Stats::getTimeUnitPeriod( getTierUnit(tier) );
+    }
+
+protected:
+    Stats m_tiers[tierCount];
+
+public:
+    StatArchive( int seconds=60 ,int minutes=60 ,int hours=48 ,int days=30 ) {
+        const int counts[tierCount] = { seconds ,minutes ,hours ,days };
+
+        for( int i=0; i<tierCount; ++i ) {
+            m_tiers[i].Reset( counts[i] ,getTierUnit( (Tier) i ) );
+        }
+    }
+
+    Stats &tier( Tier tier ) {
+        return m_tiers[ CLAMP( (int) tier ,0 ,(int) tierCount-1 ) ];
+    }
+
+public: ///-- recording
+    void Start( time_t now ) {
+        for( int i=0; i<tierCount; ++i ) {
+            m_tiers[i].Start( (int) (now / getTierPeriod( (Tier) i )) );
+        }
+    }
+
+    void Reset() {
+        for( int i=0; i<tierCount; ++i ) {
+            m_tiers[i].Reset( m_tiers[i].getStatCount() );
+        }
+    }
+
+    //! @note value is spread over periods elapsed since last record, IE a counter delta
+    void Record( double v ,time_t now ) {
+        for( int i=0; i<tierCount; ++i ) {
+            m_tiers[i].Record( v ,(int) (now / getTierPeriod( (Tier) i )) );
+        }
+    }
+
+    //! @note value is counted at now only, IE an event
+    void Count( double v ,time_t now ) {
+        for( int i=0; i<tierCount; ++i ) {
+            int t = (int) (now / getTierPeriod( (Tier) i ));
+
+            m_tiers[i].Advance( t );
+            m_tiers[i].Record( v ,t );
+        }
+    }
+
+    //! @brief average per period of tier, over its window
+    double getAvg( Tier t ) {
+        return tier(t).getAvg();
+    }
+
+public: ///-- persistence
+    bool Save( const char *filepath ) {
+        FILE *file = filepath ? fopen( filepath ,"wb" ) : nullptr;
+
+        if( !file ) return false;
+
+        bool result = writeHeader( file );
+
+        for( int i=0; result && i<tierCount; ++i ) {
+            result = m_tiers[i].Write( file );
+        }
+
+        return fclose( file ) == 0 && result;
+    }
+
+    //! @note tiers are read in order, a tier that does not match the file keeps its values
+    bool Load( const char *filepath ) {
+        FILE *file = filepath ? fopen( filepath ,"rb" ) : nullptr;
+
+        if( !file ) return false;
+
+        bool result = readHeader( file );
+
+        for( int i=0; result && i<tierCount; ++i ) {
+            result = m_tiers[i].Read( file );
+        }
+
+        fclose( file );
+
+        return result;
+    }
+
+protected:
+    bool writeHeader( FILE *file ) {
+        char magic[8] = {}; int32_t version[2] = { STATARCHIVE_VERSION ,(int32_t) sizeof(StatValue) };
+
+        memcpy( magic ,STATARCHIVE_MAGIC ,sizeof(STATARCHIVE_MAGIC) );
+
+        return fwrite( magic ,sizeof(magic) ,1 ,file ) == 1 && fwrite( version ,sizeof(version) ,1 ,file ) == 1;
+    }
+
+    bool readHeader( FILE *file ) {
+        char magic[8]; int32_t version[2];
+
+        return fread( magic ,sizeof(magic) ,1 ,file ) == 1 && memcmp( magic ,STATARCHIVE_MAGIC ,sizeof(STATARCHIVE_MAGIC) ) == 0
+            && fread( version ,sizeof(version) ,1 ,file ) == 1
+            && version[0] == STATARCHIVE_VERSION && version[1] == (int32_t) sizeof(StatValue)
+        ;
+    }
 };
 
 //////////////////////////////////////////////////////////////////////////////
-#endif //SOLOMINER_STATS_H
\ No newline at end of file
+#endif //SOLOMINER_STATS_H
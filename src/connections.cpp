@@ -6,6 +6,7 @@
 #include "connections.h"
 
 #include <markets/trader.h>
+#include <chains/forecast.h>
 #include <common/logging.h>
 
 //////////////////////////////////////////////////////////////////////////////
@@ -141,6 +142,15 @@ ConnectionInfo &Init( ConnectionInfo &p ) {
     return p;
 }
 
+PowAlgorithm getMiningAlgorithm( const ConnectionInfo &info ) {
+    CCoinRef coin;
+
+    if( info.pow.algorithm == PowAlgorithm::algoAuto && CCoinStore::getInstance().findCoinByTicker( info.mineCoin.coin.c_str() ,coin ) && coin )
+        return coin->getAlgorithm();
+
+    return info.pow.algorithm;
+}
+
 ///-- string
 template <>
 ConnectionInfo::Status &fromString( ConnectionInfo::Status &p ,const String &s ,size_t &size ) {
@@ -443,6 +453,28 @@ String &Earning::getMember( int m ,String &s ) const {
     }
 }
 
+void Earning::setMember( int m ,BinaryReader &r ) {
+    switch( m ) {
+        case 0: fromBinary( timestamp ,r ); return;
+        case 1: enumFromBinary( type ,r ); return;
+        case 2: fromBinary( transaction ,r ); return;
+        case 3: fromBinary( tradeAmount ,r ); return;
+        case 4: fromBinary( tradePlacedAt ,r ); return;
+        default: break;
+    }
+}
+
+void Earning::getMember( int m ,BinaryWriter &w ) const {
+    switch( m ) {
+        case 0: toBinary( timestamp ,w ); return;
+        case 1: enumToBinary( type ,w ); return;
+        case 2: toBinary( transaction ,w ); return;
+        case 3: toBinary( tradeAmount ,w ); return;
+        case 4: toBinary( tradePlacedAt ,w ); return;
+        default: break;
+    }
+}
+
 template <>
 Earning &Zero( Earning &p ) {
     p.timestamp = 0;
@@ -508,6 +540,7 @@ IAPI_DEF CConnection::loadSettings( Params &settings ) {
 
 //-- get relatives
     getChain( "minerstat" ,m_chain );
+    getChain( tocstr(info().mineCoin.wallet) ,m_coreChain ); //! @note only wallets from a core have a chain
     getMarket( tocstr(info().market) ,m_market );
 
     getWallet( tocstr(info().mineCoin.wallet) ,m_coinWallet );
@@ -542,7 +575,7 @@ IAPI_DEF CConnection::Benchmark() {
 }
 
 IAPI_DEF CConnection::Start() {
-    if( info().status.isStarted ) return IALREADY;
+    if( isMining() ) return IALREADY;
 
     m_miner = makeMiner( *this ,m_minerListener );
 
@@ -612,6 +645,16 @@ void CConnection::startWalletService() {
     }
 }
 
+void CConnection::resumeMining() {
+    if( !info().status.isStarted || isMining() ) return;
+
+    if( coinWallet().isNull() || coinWallet()->state() != serviceConnected ) return;
+
+    if( info().mineCoin.address.empty() ) return;
+
+    Start();
+}
+
 void CConnection::stopWalletService() {
     if( coinWallet().isNull() ) return;
 
@@ -652,25 +695,18 @@ IAPI_DEF CConnection::onTransaction( IWallet &wallet ,const WalletTransaction &t
 
 //-- add transaction to earning book
 
-    //! checking if transaction is already in book (should not happen, making sure)
-    auto txid = transaction.txid;
+    //! checking if transaction is already in book (wallet sync posts once, making sure across restarts)
+    if( book.findTransaction( transaction.txid ) != NullPtr )
+        return IALREADY;
 
-    auto *pTransaction = book.findEntry( [txid]( auto id ,auto &p ) -> bool {
-        return p.transaction.txid == txid;
-    } );
-
-    if( pTransaction == NullPtr ) {
-        book.addEntry( earning ,true );
-    } else {
-        assert( false ); //! should not happen
-    }
+    book.addEntry( earning ,true );
 
 //-- add income to total
     ChainInfo chainInfo;
 
     const char *coin = info().mineCoin.coin.c_str();
 
-    m_chain->getInfo( coin ,chainInfo ,ChainInfoFlags::noFlags );
+    getChainInfo( coin ,chainInfo );
 
     double exchangeValue = getCoinValue( chainInfo ,coin ,"usd" );
 
@@ -690,6 +726,41 @@ IAPI_DEF CConnection::onTransaction( IWallet &wallet ,const WalletTransaction &t
 }
 
 //--
+IRESULT getChainSnapshot( CChainService *coreChain ,CChainService *chain ,const char *coin ,ChainInfo &chainInfo ) {
+    IRESULT result = IERROR;
+
+    //! @note snapshots from the chain refresher, never waiting on daemon or network here
+    auto &refresher = getChainRefresher();
+
+    //! @note mining statistics from local core when available, consistent with the templates we mine
+    if( coreChain ) {
+        result = refresher.getInfo( *coreChain ,coin ,chainInfo );
+    }
+
+    if( !chain )
+        return result;
+
+    if( ISUCCESS(result) ) {
+        //! @note only price from chain service
+        ChainInfo priceInfo = {};
+
+        if( ISUCCESS( refresher.getInfo( *chain ,coin ,priceInfo ) ) ) {
+            chainInfo.price = priceInfo.price;
+            chainInfo.fields |= ChainInfoFlags::currentPrice;
+        }
+
+        return result;
+    }
+
+    return refresher.getInfo( *chain ,coin ,chainInfo );
+}
+
+IRESULT CConnection::getChainInfo( const char *coin ,ChainInfo &chainInfo ) {
+    bool isMineCoin = stricmp( coin ,info().mineCoin.coin.c_str() ) == 0;
+
+    return getChainSnapshot( isMineCoin ? m_coreChain.ptr() : NullPtr ,m_chain.ptr() ,coin ,chainInfo );
+}
+
 double priceToDouble( const String &s ) {
     if( s.empty() ) return 1;
 
@@ -768,10 +839,9 @@ double CConnection::estimateEarnings( double hostHps ,const ValueOfReference &va
     const char *mineCoin = info().mineCoin.coin.c_str();
     const char *currency = value.currency.c_str();
 
-    //TODO if wallet is core we can get info there (networkHps ,difficulty ...
-    if( m_chain.isNull() ) return 0.;
+    if( m_chain.isNull() && m_coreChain.isNull() ) return 0.;
 
-    m_chain->getInfo( mineCoin ,chainInfo ,ChainInfoFlags::noFlags );
+    getChainInfo( mineCoin ,chainInfo );
 
 ///-- reward
     double blockReward = (value.type == ValueOfReference::Type::Block) ? 1 : getMiningReward( mineCoin ,chainInfo );
@@ -850,9 +920,37 @@ IAPI_DEF CConnectionList::loadConfig( Config &config ) {
     IRESULT result = m_earnings.Open( "earning" );
     IF_IFAILED_RETURN(result);
 
+    result = m_earnings.Upgrade(); //! @note text book from previous versions
+    IF_IFAILED_RETURN(result);
+
+    getBookShelf().registerBook( m_earnings );
+
     ///-- connections
     m_config = &config;
 
+    //! @note [global] schedule = { period = 60; hedge = 10; }, period 0 to disable
+    Params schedule;
+
+    fromString( schedule ,config.getSection("global").params["schedule"] );
+
+    time_t schedulePeriod = 0; double scheduleHedge = SCHEDULE_HEDGE_DEFAULT;
+
+    fromString( schedulePeriod ,getMember( schedule ,"period" ,"0" ) );
+    fromString( scheduleHedge ,getMember( schedule ,"hedge" ,"10" ) );
+
+    m_scheduler.Configure( schedulePeriod ,scheduleHedge );
+
+    //! @note [global] hashrate = { halflife = 600; }, seconds for a hashrate sample weight to halve
+    Params hashrate;
+
+    fromString( hashrate ,config.getSection("global").params["hashrate"] );
+
+    double halfLife = ESTIMATOR_HALFLIFE_DEFAULT;
+
+    fromString( halfLife ,getMember( hashrate ,"halflife" ,"600" ) );
+
+    setHpsHalfLife( halfLife );
+
     Config::Section &section = config.getSection("connections");
 
     for( const auto &it : section.params ) { //! for each setup
@@ -873,11 +971,21 @@ IAPI_DEF CConnectionList::loadConfig( Config &config ) {
         fromString( settings ,it.second );
 
         connection->loadSettings( settings );
+        connection->resumeMining();
     }
 
+    //! @note cores connecting in background, mining resumes as each one is ready
+    getCoreProbe().Subscribe( *this );
+
     return IOK;
 }
 
+void CConnectionList::Close() {
+    getBookShelf().releaseBook( m_earnings );
+
+    m_earnings.Close();
+}
+
 IAPI_DEF CConnectionList::saveConfig() {
     if( !m_config ) return IBADENV;
 
@@ -975,7 +1083,25 @@ IAPI_DEF CConnectionList::Halt() {
     return INOEXEC;
 }
 
+///-- ICoreEvents
+void CConnectionList::onCoreReady( CCoreService &core ) {
+    String name; core.getName( name );
+
+    for( auto &it : connections().map() ) if( it.second ) {
+        auto &connection = it.second.get();
+
+        if( stricmp( connection.info().mineCoin.wallet.c_str() ,name.c_str() ) != 0 ) continue;
+
+        connection.resumeMining();
+    }
+}
+
 ///--
+//! @note oracle "hps" is a list of Algorithm=estimate, "v=2" first
+//!     v1 (no version) estimate is a plain average
+
+#define HPS_ORACLE_VERSION      2
+
 void CConnectionList::loadHps() {
     StringList list;
 
@@ -983,18 +1109,36 @@ void CConnectionList::loadHps() {
 
     fromString( list ,s );
 
+    int version = 1;
+
     for( auto &it : list ) {
         KeyValue kv;
 
         fromString( kv ,it );
 
+        if( kv.key == "v" ) {
+            fromString( version ,kv.value ); continue;
+        }
+
         PowAlgorithm pow;
-        double hps;
 
         fromString( pow ,kv.key );
-        fromString( hps ,kv.value );
 
-        registerHps( pow ,hps );
+        if( version >= 2 ) {
+            EwmaEstimator estimator;
+
+            if( !fromString( estimator ,kv.value.c_str() ) ) continue;
+
+            estimator.halfLife = m_hpsHalfLife;
+
+            m_hostHps[pow] = estimator;
+        } else {
+            double hps = 0.;
+
+            fromString( hps ,kv.value );
+
+            if( hps > 0 ) registerHps( pow ,hps );
+        }
     }
 }
 
@@ -1003,35 +1147,159 @@ void CConnectionList::saveHps() {
 
     String s;
 
-    for( auto &it : m_hostHps.map() ) if( it.second.n > 0 ) {
-            KeyValue kv;
+    Format( s ,"v=%d;" ,16 ,(int) HPS_ORACLE_VERSION );
 
-            toString( it.first ,kv.key );
-            toString( (uint32_t) (it.second.sum / it.second.n) ,kv.value );
+    list.emplace_back( s );
 
-            toString( kv ,s );
+    CriticalSection::Guard guard(m_hpsCs);
 
-            list.emplace_back( s );
-        }
+    for( auto &it : m_hostHps.map() ) if( it.second.hasData() ) {
+        KeyValue kv;
+
+        toString( it.first ,kv.key );
+        toString( it.second ,kv.value );
+
+        toString( kv ,s );
+
+        list.emplace_back( s );
+    }
 
     toString( list ,s );
 
     ::setOracle( "hps" ,s.c_str() );
 }
 
-void CConnectionList::registerHps( PowAlgorithm algorithm ,double hps ) {
-    auto &avg = m_hostHps[ algorithm ];
+void CConnectionList::registerHps( PowAlgorithm algorithm ,double hps ,int connection ) {
+    CriticalSection::Guard guard(m_hpsCs);
+
+    time_t now = Now();
+
+    //! @note no hashes is no measure of what the host can do (stopped, switching)
+    if( hps > 0 ) {
+        auto &estimator = m_hostHps[ algorithm ];
+
+        estimator.halfLife = m_hpsHalfLife;
+        estimator.Add( hps ,now );
+
+        if( connection >= 0 ) {
+            auto &connectionEstimator = m_connectionHps[ connection ];
 
-    avg.sum += hps;
-    avg.n++;
+            connectionEstimator.halfLife = m_hpsHalfLife;
+            connectionEstimator.Add( hps ,now );
+        }
+    }
+
+    //! @note first hashes after a switch, measuring its downtime
+    if( m_switchAt != 0 && hps > 0 ) {
+        double cost = (double) (now - m_switchAt);
+
+        m_switchCost = (m_switchCost + cost) / 2;
+        m_switchAt = 0;
+    }
 }
 
 double CConnectionList::getHostHps( PowAlgorithm algorithm ) {
-    const auto *avg = m_hostHps.findItem( algorithm );
+    CriticalSection::Guard guard(m_hpsCs);
+
+    const auto *estimator = m_hostHps.findItem( algorithm );
+
+    if( !estimator || !estimator->hasData() ) return 1000.; //! @note arbitrary base
+
+    return estimator->getMean();
+}
+
+bool CConnectionList::hasHostHps( PowAlgorithm algorithm ) {
+    CriticalSection::Guard guard(m_hpsCs);
+
+    const auto *estimator = m_hostHps.findItem( algorithm );
+
+    return estimator && estimator->hasData();
+}
+
+double CConnectionList::getConnectionHps( int connection ,PowAlgorithm algorithm ) {
+    { CriticalSection::Guard guard(m_hpsCs);
+
+        const auto *estimator = m_connectionHps.findItem( connection );
+
+        if( estimator && estimator->hasData() ) return estimator->getMean();
+    }
+
+    return getHostHps( algorithm );
+}
+
+double CConnectionList::getConnectionHps( int connection ,PowAlgorithm algorithm ,double &lower ,double &upper ) {
+    CriticalSection::Guard guard(m_hpsCs);
+
+    const EwmaEstimator *estimator = m_connectionHps.findItem( connection );
+
+    if( !estimator || !estimator->hasData() ) estimator = m_hostHps.findItem( algorithm );
+
+    if( !estimator || !estimator->hasData() ) {
+        lower = upper = 1000.; return 1000.; //! @note as getHostHps
+    }
+
+    lower = estimator->getLower();
+    upper = estimator->getUpper();
+
+    return estimator->getMean();
+}
+
+void CConnectionList::checkTelemetry() {
+    for( auto &it : m_connections.map() ) {
+        if( !it.second || !it.second->isMining() ) continue;
+
+        CConnection &connection = it.second.get();
 
-    if( !avg || avg->n == 0 ) return 1000.; //! @note arbitrary base
+        MinerTelemetry telemetry;
 
-    return avg->sum / avg->n;
+        if( connection.miner()->GetInfo( telemetry ) != IOK ) continue;
+
+        //! @note miner may be scheduled for another connection, hashrate is credited to the one it works for
+        CConnection *working = connection.miner()->getConnection();
+
+        if( !working ) working = &connection;
+
+        //! @note short interval matches the update interval, samples do not overlap
+        registerHps( getMiningAlgorithm( working->info() ) ,telemetry.hps[MinerTelemetry::intervalShort] ,working->getIndex() );
+
+        ListOf<int> slow;
+
+        findSlowThreads( telemetry ,slow );
+
+        String report;
+
+        if( telemetry.hugePagesTotal > 0 && !telemetry.hasHugePages() ) {
+            Format( report ,"huge pages %d/%d" ,64 ,(int) telemetry.hugePagesAllocated ,(int) telemetry.hugePagesTotal );
+        }
+
+        for( int i : slow ) {
+            const auto &thread = telemetry.threads[i];
+
+            String entry;
+
+            Format( entry ,"%sthread %d (cpu %d) %.1f h/s" ,128 ,report.empty() ? "" : ", " ,i ,(int) thread.affinity ,thread.hps[MinerTelemetry::intervalMedium] );
+
+            report += entry;
+        }
+
+        String &last = m_telemetryReport[ it.first ];
+
+        if( report != last && !report.empty() ) {
+            LOG_WARNING << LogCategory::PoW << working->info().mineCoin.coin << " miner " << report.c_str()
+                << " (" << telemetry.hps[MinerTelemetry::intervalMedium] << " h/s total)";
+        }
+
+        last = report;
+    }
+}
+
+void CConnectionList::setHpsHalfLife( double halfLife ) {
+    CriticalSection::Guard guard(m_hpsCs);
+
+    m_hpsHalfLife = halfLife > 0 ? halfLife : ESTIMATOR_HALFLIFE_DEFAULT;
+
+    for( auto &it : m_hostHps.map() ) it.second.halfLife = m_hpsHalfLife;
+    for( auto &it : m_connectionHps.map() ) it.second.halfLife = m_hpsHalfLife;
 }
 
 ///--
@@ -1066,14 +1334,30 @@ IAPI_DEF CConnectionList::editConnection( int index ,Params &settings ) {
 
     p->adviseEdit();
 
+    { CriticalSection::Guard guard(m_hpsCs);
+        m_connectionHps.delItem( index ); //! @note may now mine something else
+    }
+
+    m_scheduler.Reset( *this ); //! @note replanned from next decision
+    getProfitEngine().Discard();
+
     return result;
 }
 
 IAPI_DEF CConnectionList::deleteConnection( int index ) {
     if( index < 0 || index >= getCount() ) return IBADARGS;
 
+    m_scheduler.Reset( *this ,index );
+    getProfitEngine().Discard();
+
     m_connections.delItem( index );
 
+    { CriticalSection::Guard guard(m_hpsCs);
+        m_connectionHps.Clear(); //! @note indices shift
+    }
+
+    m_switchTo = -1;
+
     //-- re-order
     int n = m_connections.getCount();
 
@@ -1098,8 +1382,56 @@ IAPI_DEF CConnectionList::deleteConnection( int index ) {
 IAPI_DEF CConnectionList::updateConnections() {
     time_t now = Now();
 
+    m_earnings.Sync(); //! @note commits earnings grouped since last update
+
+    getBookShelf().Update( m_earnings ,now );
+
+    auto &engine = getProfitEngine();
+
+///-- apply engine decision, if any
+    ProfitDecision decision;
+
+    bool hasDecision = engine.getDecision( decision );
+
+    if( m_scheduler.isEnabled() ) {
+        if( hasDecision ) m_scheduler.Plan( decision );
+
+        m_scheduler.Update( *this ,now );
+    }
+    else if( hasDecision && decision.doSwitch && m_switchTo < 0 ) {
+        CConnectionRef current ,best;
+
+        //! @note connections may have changed since submitted
+        bool valid =
+            getConnection( decision.current ,current ) == IOK && current && current->info().status.isStarted
+            && getConnection( decision.best ,best ) == IOK && best && best->info().status.isAuto
+        ;
+
+        if( valid ) {
+            Stop();
+
+            //! @note next connection started from a later loop, once current had time to stop
+            m_switchTo = decision.best;
+            m_switchStartAt = OsTimerNow() + CCONNECTIONLIST_SWITCH_DELAY;
+        }
+    }
+
+    if( m_switchTo >= 0 && OsTimerNow() >= m_switchStartAt ) {
+        CConnectionRef best;
+
+        if( getConnection( m_switchTo ,best ) == IOK && best && best->info().status.isAuto && ISUCCESS( best->Start() ) ) {
+            CriticalSection::Guard guard(m_hpsCs);
+
+            m_switchAt = m_switchedAt = Now();
+        }
+
+        m_switchTo = -1;
+    }
+
     if( /*m_updateTime == 0 ||*/ m_updateTime > now ) return IOK;
 
+    checkTelemetry();
+
 ///-- process pending trade if any
     //TODO retry pending earning
 
@@ -1115,40 +1447,332 @@ IAPI_DEF CConnectionList::updateConnections() {
 
     if( listAuto.size() < 2 ) return IOK;
 
-    //-- best earning
-    ValueOfReference value = { ValueOfReference::Fiat ,"usd" };
+    //-- submit for scoring
+    ListOf<ProfitCandidate> candidates;
 
-    int ibest = -1 ,icurrent = -1; double vbest ,vcurrent;
+    for( auto &it : listAuto ) {
+        const auto &info = it->info();
 
-    int i = 0; for( auto &it : listAuto ) {
-        double hostHps = getHostHps( it->info().pow.algorithm );
-        double earning = it->estimateEarnings( hostHps ,value ,ValuePeriod::PerDay );
+        ProfitCandidate candidate;
 
-        if( ibest < 0 || earning > vbest ) {
-            ibest = i; vbest = earning;
-        }
+        candidate.id = it->getIndex();
+        candidate.coin = info.mineCoin.coin;
+        candidate.hostHps = getConnectionHps( candidate.id ,getMiningAlgorithm(info) );
+        candidate.isStarted = info.status.isStarted;
+        candidate.chain = it->chain().ptr();
+        candidate.coreChain = it->coreChain().ptr();
 
-        if( it->info().status.isStarted ) { //! should only have one
-            icurrent = i; vcurrent = earning;
-        }
+        candidates.emplace_back( candidate );
+    }
 
-        ++i;
+    double switchCost; time_t switchedAt;
+
+    { CriticalSection::Guard guard(m_hpsCs);
+        switchCost = m_switchCost;
+        switchedAt = m_switchedAt;
     }
 
-    if( icurrent < 0 ) return IOK; //! none started
+    engine.Submit( candidates ,switchCost ,switchedAt );
 
-    if( vbest > vcurrent * 1.02f ) { //! 2%
-        if( icurrent >= 0 ) {
-            Stop();
+//-- done
+    return IOK;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! Profitability
+
+double getProfitEarning( const ChainInfo &chainInfo ,double blockReward ,double hostHps ) {
+    if( chainInfo.networkHPS <= 0 ) return 0.;
+
+    double blockPerDay = chainInfo.blockPerHour * 24 * (hostHps / chainInfo.networkHPS);
+
+    return blockPerDay * blockReward * chainInfo.price;
+}
+
+bool ProfitSwitchRule::Check( const ProfitScore &best ,const ProfitScore &current ,double switchCost ,time_t now ,time_t switchedAt ) {
+    if( !best.isPriced || !current.isPriced || best.id == current.id ) {
+        Reset(); return false;
+    }
+
+    double gain = best.earning - current.earning;
+
+    //! @note gain over horizon must pay for the earning lost while switching
+    bool isWorth =
+        best.earning > current.earning * (1 + PROFIT_SWITCH_MARGIN)
+        && gain * PROFIT_SWITCH_HORIZON > best.earning * switchCost
+    ;
+
+    if( !isWorth ) {
+        Reset(); return false;
+    }
+
+    if( challenger == best.id ) {
+        ++challengeCount;
+    } else {
+        challenger = best.id; challengeCount = 1;
+    }
+
+    if( challengeCount < PROFIT_SWITCH_CONFIRM || now < switchedAt + PROFIT_SWITCH_DWELL )
+        return false;
+
+    Reset();
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! CMiningScheduler
+
+void CMiningScheduler::Configure( time_t period ,double hedgePercent ) {
+    m_period = MAX( period ,(time_t) 0 );
+    m_hedge = CLAMP( hedgePercent ,0. ,100. ) / 100.;
+
+    m_slices.clear();
+}
+
+void CMiningScheduler::Plan( const ProfitDecision &decision ) {
+    m_slices.clear();
+
+    if( decision.best < 0 ) return;
+
+    const ProfitScore &best = decision.ranking.front();
+
+    //! @note all connections mine with the host hashrate, earning is proportional to value per hash
+    double sum = 0.;
+
+    for( auto &it : decision.ranking ) {
+        if( it.isPriced && it.earning > 0 && it.earning >= best.earning * (1 - m_hedge) ) sum += it.earning;
+    }
+
+    if( sum <= 0 ) return;
+
+    for( auto &it : decision.ranking ) {
+        if( !it.isPriced || it.earning <= 0 || it.earning < best.earning * (1 - m_hedge) ) continue;
+
+        time_t duration = (time_t) (m_period * it.earning / sum);
+
+        if( duration >= SCHEDULE_SLICE_MIN ) m_slices.emplace_back( ScheduleSlice{ it.id ,duration } );
+    }
+
+    if( m_slices.empty() ) { //! @note period too short to share, best only
+        m_slices.emplace_back( ScheduleSlice{ best.id ,m_period } );
+    }
+
+    //! @note carry on with active slice, next one follows it
+    m_slice = m_slices.size() - 1;
+
+    for( size_t i=0; i<m_slices.size(); ++i ) {
+        if( m_slices[i].id == m_active ) m_slice = i;
+    }
+
+    if( m_slices[m_slice].id != m_active ) m_sliceEnd = 0;
+}
+
+void CMiningScheduler::Update( CConnectionList &list ,time_t now ) {
+    CConnectionRef host;
+
+    for( auto &it : list.connections().map() ) {
+        if( it.second && it.second->info().status.isStarted && it.second->miner() ) host = it.second;
+    }
+
+    if( !host ) {
+        m_miner = NullPtr; m_active = -1;
+        return;
+    }
+
+    m_miner = host->miner();
+
+    CConnection *working = m_miner->getConnection();
+
+    m_active = working ? working->getIndex() : host->getIndex();
+
+    if( m_slices.empty() || now < m_sliceEnd ) return;
+
+    m_slice = (m_slice + 1) % m_slices.size();
+
+    const ScheduleSlice &slice = m_slices[m_slice];
+
+    m_sliceEnd = now + slice.duration;
+
+    if( slice.id == m_active ) return;
 
-            OsSleep(1000);
+    CConnectionRef connection;
+
+    if( list.getConnection( slice.id ,connection ) != IOK || !connection ) return;
+
+    if( ISUCCESS( m_miner->Reconfigure( connection.get() ) ) ) {
+        m_active = slice.id;
+
+        LOG_INFO << LogCategory::PoW << "Scheduled mining " << connection->info().mineCoin.coin << " for " << slice.duration << "s";
+    }
+}
+
+void CMiningScheduler::Reset( CConnectionList &list ,int removed ) {
+    m_slices.clear();
+    m_slice = 0;
+    m_sliceEnd = 0;
+
+    if( removed < 0 ) return;
+
+    for( auto &it : list.connections().map() ) {
+        CMinerBase *miner = it.second ? it.second->miner() : NullPtr;
+
+        if( !miner || it.first == removed ) continue; //! @note removed host stops with its miner
+
+        CConnection *working = miner->getConnection();
+
+        if( working && working->getIndex() == removed ) miner->Reconfigure( it.second.get() );
+    }
+
+    m_miner = NullPtr; m_active = -1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! CProfitEngine
+
+void CProfitEngine::Submit( ListOf<ProfitCandidate> &candidates ,double switchCost ,time_t switchedAt ) {
+    CriticalSection::Guard guard(m_cs);
+
+    m_candidates.swap( candidates );
+    m_switchCost = switchCost;
+    m_switchedAt = switchedAt;
+
+    m_pending = true;
+
+    if( !m_running ) {
+        m_quit = false;
+        m_running = Thread::Start() == ENOERROR;
+    }
+}
+
+void CProfitEngine::Discard() {
+    CriticalSection::Guard guard(m_cs);
+
+    m_candidates.clear();
+    m_pending = false;
+    m_published = false;
+
+    ++ m_generation;
+}
+
+bool CProfitEngine::getDecision( ProfitDecision &decision ) {
+    CriticalSection::Guard guard(m_cs);
+
+    if( !m_published ) return false;
+
+    decision = m_decision;
+    m_published = false;
+
+    return true;
+}
+
+void CProfitEngine::Shutdown() {
+    if( !m_running ) return;
+
+    m_quit = true;
+
+    WaitFor();
+
+    m_running = false;
+}
+
+///-- protected
+ProfitScore CProfitEngine::Score( const ProfitCandidate &candidate ,time_t now ) {
+    ProfitScore score = { candidate.id ,0. ,false };
+
+    const char *coin = candidate.coin.c_str();
+
+    ChainInfo chainInfo = {};
+
+    if( IFAILED( getChainSnapshot( candidate.coreChain ,candidate.chain ,coin ,chainInfo ) ) )
+        return score;
+
+    if( chainInfo.networkHPS <= 0 || chainInfo.price <= 0 )
+        return score;
+
+    score.earning = getProfitEarning( chainInfo ,getMiningReward( coin ,chainInfo ) ,candidate.hostHps );
+    score.isPriced = true;
+
+    //! @note expected over horizon rather than instant, not chasing difficulty spikes
+    ListOf<SeriesRecord> history;
+
+    ChainForecast forecast;
+
+    if( ISUCCESS( getChainHistory().Query( coin ,seriesMinute ,now - PROFIT_FORECAST_WINDOW ,now+1 ,history ) )
+        && ISUCCESS( forecastChain( coin ,history.data() ,history.size() ,getSeriesPeriod(seriesMinute) ,chainInfo ,PROFIT_SWITCH_HORIZON ,forecast ) )
+    ) {
+        score.earning = getForecastEarning( score.earning ,chainInfo ,forecast );
+    }
+
+    return score;
+}
+
+void CProfitEngine::Evaluate( ListOf<ProfitCandidate> &candidates ,double switchCost ,time_t switchedAt ,ProfitDecision &decision ) {
+    const ProfitScore *current = NullPtr;
+
+    decision.timestamp = time(NullPtr);
+
+    for( auto &it : candidates ) {
+        decision.ranking.emplace_back( Score( it ,decision.timestamp ) );
+
+        if( it.isStarted ) decision.current = it.id; //! should only have one
+    }
+
+    std::stable_sort( decision.ranking.begin() ,decision.ranking.end() ,[]( const ProfitScore &a ,const ProfitScore &b ) {
+        return a.isPriced != b.isPriced ? a.isPriced : a.earning > b.earning;
+    });
+
+    for( auto &it : decision.ranking ) {
+        if( it.id == decision.current ) current = &it;
+    }
+
+    const ProfitScore &best = decision.ranking.front();
+
+    if( best.isPriced ) decision.best = best.id;
+
+    //! @note none started, or current not comparable (no price yet)
+    if( !current ) {
+        m_rule.Reset(); return;
+    }
+
+    decision.doSwitch = m_rule.Check( best ,*current ,switchCost ,decision.timestamp ,switchedAt );
+}
+
+OsError CProfitEngine::Main() {
+    while( !m_quit ) {
+        ListOf<ProfitCandidate> candidates;
+
+        double switchCost = 0; time_t switchedAt = 0; int generation = 0;
+
+        { CriticalSection::Guard guard(m_cs);
+
+            if( m_pending ) {
+                candidates.swap( m_candidates );
+                switchCost = m_switchCost;
+                switchedAt = m_switchedAt;
+                generation = m_generation;
+
+                m_pending = false;
+            }
+        }
+
+        if( candidates.empty() ) {
+            OsSleep( PROFIT_ENGINE_TICK ); continue;
         }
 
-        listAuto[ibest]->Start();
+        ProfitDecision decision;
+
+        Evaluate( candidates ,switchCost ,switchedAt ,decision );
+
+        CriticalSection::Guard guard(m_cs);
+
+        if( generation != m_generation ) continue; //! @note connections changed while evaluating
+
+        m_decision = decision;
+        m_published = true;
     }
 
-//-- done
-    return IOK;
+    return ENOERROR;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -10,10 +10,12 @@
 //////////////////////////////////////////////////////////////////////////////
 #include <common/common.h>
 #include <common/book.h>
+#include <common/estimator.h>
 
 #include <coins/coins.h>
 #include <miners/miners.h>
 #include <chains/chains.h>
+#include <coins/cores.h>
 #include <markets/markets.h>
 #include <wallets/wallets.h>
 
@@ -117,6 +119,9 @@ struct ConnectionInfo {
 template <> ConnectionInfo &Zero( ConnectionInfo &p );
 template <> ConnectionInfo &Init( ConnectionInfo &p );
 
+//! @brief algorithm mined by connection, from mined coin if auto
+PowAlgorithm getMiningAlgorithm( const ConnectionInfo &info );
+
 //--
 template <> ConnectionInfo::Status &fromString( ConnectionInfo::Status &p ,const String &s ,size_t &size );
 template <> String &toString( const ConnectionInfo::Status &p ,String &s );
@@ -164,8 +169,9 @@ struct CDataConnectionInfo : CDataSource {
 struct Earning : BookEntry {
     DECLARE_CLASSID(EARNING_PUID)
     DECLARE_SCHEMA
+    DECLARE_SCHEMA_BINARY
 
-    static size_t sizeofEntry() { return 1024; };
+    static size_t sizeofEntry() { return 512; }; //! @note txid, two addresses, some comment, spills to a larger size beyond
 
     TimeSec timestamp;
 
@@ -183,9 +189,34 @@ struct Earning : BookEntry {
 CLASS_SCHEMA(Earning);
 DEFINE_WITHSCHEMA_API(Earning);
 
+CLASS_SCHEMA_BINARY(Earning);
+DEFINE_WITHBINARY_API(Earning);
+
 template <> Earning &Zero( Earning &p );
 
-typedef CBookFile_<Earning> CEarningBook;
+//! @brief earning book, indexed by transaction
+class CEarningBook : public CBookFile_<Earning> {
+public:
+    CEarningBook() : m_byTxid( "txid" ,txidKey ) {
+        addIndex( m_byTxid );
+    }
+
+    ~CEarningBook() {
+        Close(); //! @note saving indexes while they still exist
+    }
+
+    Earning *findTransaction( const String &txid ) {
+        entryid_t id = m_byTxid.find( txid );
+
+        return id != INVALID_ENTRY_VALUE ? getEntry( id ) : NullPtr;
+    }
+
+protected:
+    static String txidKey( const Earning &p ) { return p.transaction.txid; }
+
+    BookHashIndex_<Earning> m_byTxid;
+};
+
 typedef CBookDataSource_<Earning,Earning> CEarningDataSource;
 
 ///-- @brief Earning as flat data fields
@@ -234,6 +265,7 @@ public:
     ConnectionInfo &info() { return m_info; }
 
     CChainServiceRef &chain() { return m_chain; }
+    CChainServiceRef &coreChain() { return m_coreChain; }
     CMarketServiceRef &market() { return m_market; }
 
     CWalletServiceRef &coinWallet() { return m_coinWallet; }
@@ -247,6 +279,8 @@ public:
         m_minerListener = minerListener;
     }
 
+    IMinerListener *minerListener() { return m_minerListener; }
+
 public:
     bool hasTrade() const {
         return !m_info.tradeCoin.coin.empty();
@@ -277,9 +311,14 @@ public: ///-- IWallet
     void startWalletService();
     void stopWalletService();
 
+    //! @note mining was started when settings were last saved, starting again once wallet is connected
+    void resumeMining();
+
     IAPI_IMPL onTransaction( IWallet &wallet ,const WalletTransaction &transaction ) IOVERRIDE;
 
 public: //--
+    IRESULT getChainInfo( const char *coin ,ChainInfo &chainInfo );
+
     double getCoinRatio( const ChainInfo &chainInfo ,const char *primary ,const char *secondary );
     double getCoinValue( const ChainInfo &chainInfo ,const char *coin ,const char *currency );
     double estimateEarnings( double hostHps ,const ValueOfReference &value ,ValuePeriod period );
@@ -295,6 +334,7 @@ protected:
 
 //--
     CChainServiceRef m_chain;
+    CChainServiceRef m_coreChain; //! mining coin local core, if any
     CMarketServiceRef m_market;
     CWalletServiceRef m_coinWallet;
     CWalletServiceRef m_tradeWallet;
@@ -306,21 +346,205 @@ protected:
 
 typedef RefOf<CConnection> CConnectionRef;
 
+//////////////////////////////////////////////////////////////////////////////
+//! Profitability
+
+#define PROFIT_SWITCH_MARGIN    0.01 //! relative gain a challenger must show, hysteresis band
+#define PROFIT_SWITCH_CONFIRM   3 //! evaluations in a row a challenger must stay best
+#define PROFIT_SWITCH_DWELL     300 //! s, minimum time mining a connection after a switch
+#define PROFIT_SWITCH_HORIZON   3600 //! s, time a switch gain is expected to last
+#define PROFIT_SWITCH_COST      60 //! s, downtime of a switch until measured
+#define PROFIT_FORECAST_WINDOW  (6*3600) //! s, history used to forecast chain statistics
+#define PROFIT_ENGINE_TICK      50 //! ms, engine thread idle sleep
+
+//! @brief chain info of a coin, from local core if any, price from chain service
+//! @note snapshots from chain refresher, non blocking and callable from any thread
+IRESULT getChainSnapshot( CChainService *coreChain ,CChainService *chain ,const char *coin ,ChainInfo &chainInfo );
+
+//! @note plain data copied from a connection, engine never touches connections
+struct ProfitCandidate {
+    int id; //! connection index
+    String coin;
+    double hostHps;
+    bool isStarted;
+
+    CChainService *chain; //! @note services outlive the engine (shutdown before cleanup)
+    CChainService *coreChain;
+};
+
+struct ProfitScore {
+    int id;
+    double earning; //! usd per day, expected over switch horizon
+    bool isPriced; //! false until chain info with a price is available
+};
+
+//! @brief block reward of coin, oracle 'COIN/reward' if set else from chain info
+double getMiningReward( const char *coin ,ChainInfo &info );
+
+//! @brief instant earning in usd per day, from chain info
+double getProfitEarning( const ChainInfo &chainInfo ,double blockReward ,double hostHps );
+
+/**
+ * @brief switch rule, with hysteresis state
+ * @note gain over horizon must pay for switch downtime, challenger must beat current by a margin
+ *      for several evaluations in a row, and current must have been mined for a minimum time
+ */
+
+struct ProfitSwitchRule {
+    int challenger = -1;
+    int challengeCount = 0;
+
+    void Reset() {
+        challenger = -1; challengeCount = 0;
+    }
+
+    bool Check( const ProfitScore &best ,const ProfitScore &current ,double switchCost ,time_t now ,time_t switchedAt );
+};
+
+struct ProfitDecision {
+    ListOf<ProfitScore> ranking; //! best first
+
+    int current = -1; //! id of started connection, -1 if none
+    int best = -1; //! id of best priced connection, -1 if none
+
+    bool doSwitch = false; //! best is worth the switch cost, hysteresis passed
+
+    time_t timestamp = 0;
+};
+
+/**
+ * @brief score connections from chain snapshots, off main thread
+ * @note main loop submits candidates and applies published decisions, never waiting on the engine
+ * @note switching requires gain over the horizon to pay for measured switch downtime,
+ *      a margin over current and a challenger holding for several evaluations
+ */
+
+class CProfitEngine : public Singleton_<CProfitEngine> ,protected Thread {
+protected:
+    CriticalSection m_cs;
+
+    ListOf<ProfitCandidate> m_candidates; //! pending evaluation
+    bool m_pending;
+
+    double m_switchCost; //! s, measured switch downtime
+    time_t m_switchedAt; //! last switch
+
+    ProfitDecision m_decision; //! last published
+    bool m_published; //! decision not read yet
+    int m_generation; //! bumped when connections change, older evaluations are dropped
+
+    ProfitSwitchRule m_rule; //! @note engine thread only
+
+    volatile bool m_running;
+    volatile bool m_quit;
+
+public:
+    CProfitEngine() :
+        m_pending(false) ,m_switchCost(PROFIT_SWITCH_COST) ,m_switchedAt(0) ,m_published(false) ,m_generation(0)
+        ,m_running(false) ,m_quit(false)
+    {}
+
+    ~CProfitEngine() {
+        Shutdown();
+    }
+
+public:
+    //! @brief evaluate candidates, replacing any evaluation still pending
+    void Submit( ListOf<ProfitCandidate> &candidates ,double switchCost ,time_t switchedAt );
+
+    //! @return true with decision if one was published since last call
+    bool getDecision( ProfitDecision &decision );
+
+    //! @brief drop pending and published evaluations, connection ids changed
+    void Discard();
+
+    void Shutdown();
+
+protected:
+    static ProfitScore Score( const ProfitCandidate &candidate ,time_t now );
+
+    void Evaluate( ListOf<ProfitCandidate> &candidates ,double switchCost ,time_t switchedAt ,ProfitDecision &decision );
+
+    OsError Main() override;
+};
+
+inline CProfitEngine &getProfitEngine() {
+    return CProfitEngine::getInstance();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! Scheduler
+
+#define SCHEDULE_HEDGE_DEFAULT  10 //! %, connections this close to best share the rotation
+#define SCHEDULE_SLICE_MIN      5 //! s, shorter slices are dropped
+
+struct ScheduleSlice {
+    int id; //! connection index
+    time_t duration;
+};
+
+/**
+ * @brief rotate the started miner over close profit connections, in time slices
+ * @note slices are weighted by expected earning per hash, over a rotation period
+ * @note miner workers stay resident, only the job source is switched (no restart cost)
+ */
+
+class CMiningScheduler {
+protected:
+    time_t m_period; //! s, full rotation, 0 if disabled
+    double m_hedge; //! relative distance to best to be scheduled
+
+    ListOf<ScheduleSlice> m_slices;
+
+    size_t m_slice; //! current slice
+    time_t m_sliceEnd;
+
+    CMinerBase *m_miner; //! miner being scheduled
+    int m_active; //! connection the miner is working for, -1 if none, as of last update
+
+public:
+    CMiningScheduler() :
+        m_period(0) ,m_hedge(SCHEDULE_HEDGE_DEFAULT/100.) ,m_slice(0) ,m_sliceEnd(0) ,m_miner(NullPtr) ,m_active(-1)
+    {}
+
+    bool isEnabled() const { return m_period > 0; }
+
+    int active() const { return m_active; }
+
+    const ListOf<ScheduleSlice> &slices() const { return m_slices; }
+
+public:
+    void Configure( time_t period ,double hedgePercent );
+
+    //! @brief slices from engine ranking
+    void Plan( const ProfitDecision &decision );
+
+    //! @brief switch job source as slices end, from main loop
+    void Update( CConnectionList &list ,time_t now );
+
+    //! @brief drop slices, connection ids changed
+    //! @note miner working for removed connection is given back to its own
+    void Reset( CConnectionList &list ,int removed=-1 );
+};
+
 //////////////////////////////////////////////////////////////////////////////
 //! Connection List
 
 #define CCONNECTIONLIST_UPDATE_INTERVAL     (10) //! in seconds
+#define CCONNECTIONLIST_SWITCH_DELAY        (1000) //! in ms, current connection stopping before next starts
 
 /**
  * @brief list of configured connections
  */
 
-class CConnectionList : COBJECT_PARENT {
+class CConnectionList : COBJECT_PARENT ,public ICoreEvents {
 public: //-- definitions
     typedef Map_<int,CConnectionRef> connections_t;
 
 public: //-- instance
-    CConnectionList() : m_config(NullPtr) ,m_updateTime(0) ,m_hasEdit(false) {
+    CConnectionList() :
+        m_config(NullPtr) ,m_hpsHalfLife(ESTIMATOR_HALFLIFE_DEFAULT) ,m_updateTime(0) ,m_switchTo(-1) ,m_switchStartAt(0) ,m_switchAt(0) ,m_switchedAt(0) ,m_switchCost(PROFIT_SWITCH_COST) ,m_hasEdit(false)
+    {
         loadHps();
     }
 
@@ -365,6 +589,9 @@ public: //-- interface
     IAPI_DECL loadConfig( Config &config );
     IAPI_DECL saveConfig();
 
+    //! @brief release books from shelf and close them, list outlives shelf singleton
+    void Close();
+
     IAPI_DECL getConnection( int id ,CConnectionRef &connection );
     IAPI_DECL addConnection( Params &settings ,CConnectionRef &connection );
     IAPI_DECL editConnection( int index ,Params &settings );
@@ -379,27 +606,58 @@ public: //-- interface
     IAPI_DECL Stop();
     IAPI_DECL Halt();
 
+public: //-- ICoreEvents
+    void onCoreReady( CCoreService &core ) override;
+
 public: //-- stats
     void loadHps();
     void saveHps();
 
-    void registerHps( PowAlgorithm algorithm ,double hps );
+    //! @brief host hashrate sample, for algorithm and connection (if not -1)
+    void registerHps( PowAlgorithm algorithm ,double hps ,int connection=-1 );
+
+    //! @brief current host hashrate estimate for algorithm
     double getHostHps( PowAlgorithm algorithm );
 
+    //! @brief algorithm hashrate was sampled, getHostHps is not an arbitrary base
+    bool hasHostHps( PowAlgorithm algorithm );
+
+    //! @brief current estimate for connection, algorithm estimate if connection has no samples yet
+    double getConnectionHps( int connection ,PowAlgorithm algorithm );
+
+    //! @brief same, with confidence bounds of the estimate (equal to it without samples)
+    double getConnectionHps( int connection ,PowAlgorithm algorithm ,double &lower ,double &upper );
+
+    //! @brief report threads hashing below the others, once per change
+    void checkTelemetry();
+
+    void setHpsHalfLife( double halfLife );
+
 protected: //-- members
     Config *m_config;
 
     connections_t m_connections; //! list of configured connection
     CEarningBook m_earnings; //! account of earnings
 
-    struct Avg {
-        double sum = 0.; int n = 0;
-    };
+    CriticalSection m_hpsCs; //! @note estimators and switch measure, sampled from ui
+
+    double m_hpsHalfLife; //! s
 
-    Map_<PowAlgorithm,Avg> m_hostHps;
+    Map_<PowAlgorithm,EwmaEstimator> m_hostHps; //! @note persisted to oracle
+    Map_<int,EwmaEstimator> m_connectionHps; //! @note reset on connection edit
+    Map_<int,String> m_telemetryReport; //! last reported, per connection
 
     time_t m_updateTime;
 
+    CMiningScheduler m_scheduler; //! @note replaces switching when enabled
+
+    int m_switchTo; //! connection to start once current stopped, -1 if none
+    OsTimerTime m_switchStartAt; //! ms
+
+    time_t m_switchAt; //! pending switch, until new connection reports hashes
+    time_t m_switchedAt; //! last switch
+    double m_switchCost; //! s, measured switch downtime
+
     bool m_hasEdit; //! list was edited (number of connection...)
 };
 
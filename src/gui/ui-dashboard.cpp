@@ -214,6 +214,8 @@ struct UiConnection : public GuiGroup ,public IMinerListener {
         { //! stats
             stats.colors().fillColor = OS_RGB(24,24,80);
             stats.setBarImage( &getAssetImage( UIIMAGE_BAR_GREEN ) );
+            stats.setArchive( &m_hashArchive ,&m_shareArchive );
+            stats.setEventColor( OS_COLOR_ORANGE );
             stats.coords() = { statLeftPos ,15.f ,poolLeftPos ,75.f };
             addControl( stats );
 
@@ -349,10 +351,66 @@ struct UiConnection : public GuiGroup ,public IMinerListener {
     //-- stats
     uint64_t m_lastHashes = 0;
 
+    StatArchive m_hashArchive; //! long range hashes, persisted per mining target
+    StatArchive m_shareArchive; //! accepted shares and blocks
+    int m_hashArchiveMinute = 0; //! last saved
+
+    String m_statsKey; //! archives loaded for
+
+    //! @note connection index shifts on delete, key on what is mined and where to
+    String makeStatsKey() {
+        const ConnectionInfo &info = m_connection.info();
+
+        String key = info.mineCoin.coin + "-" + info.pool + "-" + info.mineCoin.address;
+
+        for( auto &c : key ) {
+            if( !isalnum( (unsigned char) c ) && c != '-' ) c = '_';
+        }
+
+        return key;
+    }
+
+    String getArchiveFilepath( const char *name ) {
+        String filepath = name; filepath += "-"; filepath += m_statsKey; filepath += ".stats";
+
+        return filepath;
+    }
+
+    void loadArchive( StatArchive &archive ,const char *name ,time_t now ) {
+        if( archive.Load( getArchiveFilepath(name).c_str() ) ) return;
+
+        archive.Reset();
+        archive.Start( now );
+    }
+
+    void saveArchives() {
+        m_hashArchive.Save( getArchiveFilepath("hashes").c_str() );
+        m_shareArchive.Save( getArchiveFilepath("shares").c_str() );
+    }
+
     void startStats() {
         time_t now; time ( &now );
 
-        stats.stats().Start( (int) (now/60) );
+        String key = makeStatsKey();
+
+        if( key != m_statsKey ) {
+            if( !m_statsKey.empty() ) saveArchives();
+
+            m_statsKey = key;
+
+            loadArchive( m_hashArchive ,"hashes" ,now );
+            loadArchive( m_shareArchive ,"shares" ,now );
+        }
+
+        m_hashArchiveMinute = (int) (now/60);
+    }
+
+    void recordShare() {
+        time_t now; time( &now );
+
+        if( m_statsKey.empty() ) startStats(); //! @note started without dashboard (auto, engine)
+
+        m_shareArchive.Count( 1. ,now );
     }
 
     void recordStats( uint64_t hashes ) {
@@ -364,10 +422,18 @@ struct UiConnection : public GuiGroup ,public IMinerListener {
         }
 
         uint64_t d = hashes - m_lastHashes;
-        stats.stats().Record( (double) d ,(int) (now/60) );
         m_lastHashes = hashes;
 
-        m_connection.connectionList().registerHps( PowAlgorithm::GhostRider ,stats.stats().getAvg() / 60. );
+        if( m_statsKey.empty() ) startStats();
+
+        m_hashArchive.Record( (double) d ,now );
+
+        //! @note saved once a minute at most
+        if( (int) (now/60) != m_hashArchiveMinute ) {
+            saveArchives();
+
+            m_hashArchiveMinute = (int) (now/60);
+        }
 
         updateStatHpsLabel();
     }
@@ -399,16 +465,21 @@ struct UiConnection : public GuiGroup ,public IMinerListener {
     }
 
     void updateStatHpsLabel() {
-        double hps = m_connection.connectionList().getHostHps( PowAlgorithm::GhostRider );
+        double lower ,upper;
+
+        double hps = m_connection.connectionList().getConnectionHps( m_connection.getIndex() ,getMiningAlgorithm( m_connection.info() ) ,lower ,upper );
+
+        //! @note with 95% margin of the estimate, once known
+        double margin = (upper - lower) / 2.;
 
         if( hps > 10000. ) {
             hps = round( hps / 10. ) / 100.;
-            Format( hpsLabel.text() ,"%.2f kp/s" ,64 ,(float) hps );
+            Format( hpsLabel.text() ,margin > 0 ? "%.2f +/-%.2f kp/s" : "%.2f kp/s" ,64 ,(float) hps ,(float) (margin / 1000.) );
         } else if( hps > 100. ) {
             hps = round( hps );
-            Format( hpsLabel.text() ,"%d p/s" ,64 ,(int) hps );
+            Format( hpsLabel.text() ,margin > 0 ? "%d +/-%d p/s" : "%d p/s" ,64 ,(int) hps ,(int) round(margin) );
         } else {
-            Format( hpsLabel.text() ,"%.2f p/s" ,64 ,(float) hps );
+            Format( hpsLabel.text() ,margin > 0 ? "%.2f +/-%.2f p/s" : "%.2f p/s" ,64 ,(float) hps ,(float) margin );
         }
 
         //-- luck
@@ -452,6 +523,7 @@ struct UiConnection : public GuiGroup ,public IMinerListener {
 
         AmountValue balance = { 0 ,"" };
 
+        //! @note core wallets answer from their balance cache, daemon is queried only once invalidated
         pwallet->getAddressBalance( mineCoinAddress() ,balance );
 
         std::stringstream ss;
@@ -463,7 +535,7 @@ struct UiConnection : public GuiGroup ,public IMinerListener {
     ValueReference m_earningReference;
 
     void updateEstimateEarningText() {
-        const double hostHPS = m_connection.connectionList().getHostHps( PowAlgorithm::GhostRider );
+        const double hostHPS = m_connection.connectionList().getConnectionHps( m_connection.getIndex() ,getMiningAlgorithm( m_connection.info() ) );
 
         updateStatHpsLabel();
 
@@ -776,6 +848,7 @@ struct UiConnection : public GuiGroup ,public IMinerListener {
         else if( isMiningOnCore() ) {
             if( m_accepted < info.accepted ) {
                 onBlockFound( info );
+                recordShare();
 
                 m_luck += (m_partial+1) / 256.;
                 m_partial = (int) info.partial;
@@ -792,6 +865,7 @@ struct UiConnection : public GuiGroup ,public IMinerListener {
 
         else {
             onShareAccepted( info );
+            recordShare();
         }
 
         recordStats( info.hashes );
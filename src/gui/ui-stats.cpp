@@ -10,11 +10,26 @@
 namespace solominer {
 
 //////////////////////////////////////////////////////////////////////////////
+void UiStats::onClick( const OsPoint &p ,OsMouseButton mouseButton ,OsKeyState keyState ) {
+    GuiControl::onClick( p ,mouseButton ,keyState );
+
+    if( !m_archive ) return;
+
+    m_tier = (m_tier >= StatArchive::tierDay) ? StatArchive::tierMinute : (StatArchive::Tier) (m_tier + 1);
+
+    root().Refresh();
+}
+
 void UiStats::onDraw( const OsRect &updateArea ) {
     GuiControl::onDraw(updateArea);
 
-    int n = m_stats.getStatCount();
-    int t = m_stats.getCurrentTime();
+    Stats &bars = stats();
+    Stats *events = m_events ? &m_events->tier(m_tier) : NULL;
+
+    int n = bars.getStatCount();
+    int t = bars.getCurrentTime();
+
+    if( n <= 0 ) return;
 
     Rect bar = area();
 
@@ -25,12 +40,12 @@ void UiStats::onDraw( const OsRect &updateArea ) {
 
     double mini ,maxi;
 
-    m_stats.findBounds( mini ,maxi );
+    bars.findBounds( mini ,maxi );
 
     mini = 0; maxi = (maxi > 1) ? maxi : 1;
 
     for( int i=0; i<n; ++i ) {
-        double v = m_stats.getStat(t - i).sum; // getAvg();
+        double v = bars.getStat(t - i).sum; // getAvg();
 
         bar.top = bar.bottom - h * v / maxi;
 
@@ -41,6 +56,12 @@ void UiStats::onDraw( const OsRect &updateArea ) {
             );
         }
 
+        if( events && events->hasStat(t - i) && events->getStat(t - i).sum > 0 ) {
+            OsGuiSetColors( root() ,m_eventColors );
+
+            root().DrawRectangle( Rect( bar.left ,bar.top - 2 ,bar.right ,bar.top ) );
+        }
+
         bar.right = bar.left; bar.left -= w;
     }
 }
@@ -19,29 +19,55 @@ namespace solominer {
 #define UISTATS_PUID        0x0d9ac96e634bc5600
 
 //////////////////////////////////////////////////////////////////////////////
+/**
+ * @brief bar chart of stats, or of an archive tier
+ * @note with an archive, click cycles through minute, hour and day tiers,
+ *      events (IE shares) are marked on top of the bars of the same period
+ */
+
 class UiStats : GUICONTROL_PARENT {
 public:
     UiStats( int count=32 ) : m_stats( count ,Stats::TimeUnit::Minute )
-        ,m_barImage(NULL)
+        ,m_barImage(NULL) ,m_archive(NULL) ,m_events(NULL) ,m_tier(StatArchive::tierMinute)
+        ,m_eventColors{ OS_COLOR_GREEN ,OS_COLOR_GREEN ,OS_COLOR_GREEN ,OS_COLOR_GREEN }
     {}
 
     DECLARE_GUICONTROL(GuiControl,UiStats,UISTATS_PUID);
 
     Stats &stats() {
-        return m_stats;
+        return m_archive ? m_archive->tier(m_tier) : m_stats;
     }
 
     void setBarImage( GuiImage *image ) {
         m_barImage = image;
     }
 
+    void setArchive( StatArchive *archive ,StatArchive *events=NULL ) {
+        m_archive = archive; m_events = events;
+    }
+
+    void setEventColor( OsColorRef color ) {
+        m_eventColors = { color ,color ,color ,color };
+    }
+
+    StatArchive::Tier tier() const {
+        return m_tier;
+    }
+
 public:
+    virtual void onClick( const OsPoint &p ,OsMouseButton mouseButton ,OsKeyState keyState );
     virtual void onDraw( const OsRect &updateArea );
 
 protected:
     Stats m_stats;
 
     GuiImage *m_barImage;
+
+    StatArchive *m_archive; //! @note bars from archive tier if set
+    StatArchive *m_events;
+    StatArchive::Tier m_tier;
+
+    ColorQuad m_eventColors;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -69,10 +69,13 @@ struct ChainInfo {
 
     //? + extra info
     // double secondsPerBlock; //! network target second per block
+
+    time_t timestamp; //! time info was fetched, IE its age
+    int fields; //! ChainInfoFlags, fields available in info
 };
 
 enum ChainInfoFlags {
-    noFlags=0 ,blockHeight=1 ,currentDiff=2 ,networkHPS=4 ,secondsPerBlock=8 ,blockReward=16
+    noFlags=0 ,blockHeight=1 ,currentDiff=2 ,networkHPS=4 ,secondsPerBlock=8 ,blockReward=16 ,currentPrice=32
 };
 
 //////////////////////////////////////////////////////////////////////////////
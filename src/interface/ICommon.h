@@ -77,6 +77,14 @@ INLINE_TOSTRING(AmountValue) {
     return s;
 }
 
+INLINE_FROMBINARY(AmountValue) {
+    return fromBinary( p.amount ,r ) && fromBinary( p.value ,r );
+}
+
+INLINE_TOBINARY(AmountValue) {
+    toBinary( p.amount ,w ); toBinary( p.value ,w );
+}
+
 //////////////////////////////////////////////////////////////////////////////
 } //namespace solominer
 
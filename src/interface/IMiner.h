@@ -55,6 +55,40 @@ struct MiningInfo {
     uint32_t elapsedMs = 0;  //! time since last result
 };
 
+///--
+struct MinerTelemetry {
+    enum Interval {
+        intervalShort=0 ,intervalMedium ,intervalLarge ,intervalCount //! 10s, 60s, 15m
+    };
+
+    struct Thread {
+        int64_t affinity = -1; //! logical cpu the thread is bound to, -1 if none
+        double hps[intervalCount] = {};
+    };
+
+    struct Variant { //! algorithm sub variant timing (e.g. GhostRider cn variants)
+        String name;
+        double hps = 0.; //! from miner benchmark, 0 if not run
+        uint32_t step = 1; //! hashes per pass
+        uint32_t threads = 1;
+    };
+
+    time_t timestamp = 0; //! when taken
+
+    String backend; //! e.g. cpu
+    String algorithm;
+
+    double hps[intervalCount] = {};
+
+    uint64_t hugePagesAllocated = 0;
+    uint64_t hugePagesTotal = 0;
+
+    ListOf<Thread> threads;
+    ListOf<Variant> variants;
+
+    bool hasHugePages() const { return hugePagesTotal > 0 && hugePagesAllocated >= hugePagesTotal; }
+};
+
 //////////////////////////////////////////////////////////////////////////////
 //! IMinerListener
 
@@ -79,9 +113,15 @@ public:
     IAPI_DECL GetInfo( MinerInfo &info ) = 0;
     IAPI_DECL GetInfo( MiningInfo &info ) = 0;
 
+    //! @brief per thread hashrate and backend state, INODATA until miner reports
+    IAPI_DECL GetInfo( MinerTelemetry &info ) = 0;
+
     IAPI_DECL Start() = 0;
     IAPI_DECL Stop( int32_t msTimeout=-1 ) = 0;
 
+    //! @brief mine for another connection (coin, host, address), workers are kept running
+    IAPI_DECL Reconfigure( CConnection &connection ) = 0;
+
     //? LATER Pause/Resume
 };
 
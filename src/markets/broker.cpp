@@ -78,6 +78,30 @@ DEFINE_GETMEMBER(BrokerOp) {
     }
 }
 
+DEFINE_SETMEMBER_BINARY(BrokerOp) {
+    switch( m ) {
+        case 0: fromBinary( p.sequence ,r ); return;
+        case 1: enumFromBinary( p.stage ,r ); return;
+        case 2: enumFromBinary( p.status ,r ); return;
+        case 3: fromBinary( p.timeExecuted ,r ); return;
+        case 4: fromBinary( p.timeVerified ,r ); return;
+        case 5: fromBinary( p.timeConcluded ,r ); return;
+        default: break;
+    }
+}
+
+DEFINE_GETMEMBER_BINARY(BrokerOp) {
+    switch( m ) {
+        case 0: toBinary( p.sequence ,w ); return;
+        case 1: enumToBinary( p.stage ,w ); return;
+        case 2: enumToBinary( p.status ,w ); return;
+        case 3: toBinary( p.timeExecuted ,w ); return;
+        case 4: toBinary( p.timeVerified ,w ); return;
+        case 5: toBinary( p.timeConcluded ,w ); return;
+        default: break;
+    }
+}
+
 //--
 template <> BrokerOp &Zero( BrokerOp &p ) {
     p.sequence = 0;
@@ -174,6 +198,46 @@ DEFINE_GETMEMBER(BrokerOrder) {
     }
 }
 
+DEFINE_SETMEMBER_BINARY(BrokerOrder) {
+    switch( m ) {
+        case 0: fromBinary( p.id ,r ); return;
+        case 1: enumFromBinary( p.type ,r ); return;
+        case 2: fromBinary( p.stopRate ,r ); return;
+        case 3: fromBinary( p.market ,r ); return;
+        case 4: fromBinary( p.deposit ,r ); return;
+        case 5: fromBinary( p.order ,r ); return;
+        case 6: fromBinary( p.withdraw ,r ); return;
+        case 7: fromBinary( p.stages[0] ,r ); return;
+        case 8: fromBinary( p.stages[1] ,r ); return;
+        case 9: fromBinary( p.stages[2] ,r ); return;
+        case 10: fromBinary( p.intputOrders ,r ); return;
+        case 11: enumFromBinary( p.stage ,r ); return;
+        case 12: fromBinary( p.cancellable ,r ); return;
+        case 13: fromBinary( p.timePlaced ,r ); return;
+        default: break;
+    }
+}
+
+DEFINE_GETMEMBER_BINARY(BrokerOrder) {
+    switch( m ) {
+        case 0: toBinary( p.id ,w ); return;
+        case 1: enumToBinary( p.type ,w ); return;
+        case 2: toBinary( p.stopRate ,w ); return;
+        case 3: toBinary( p.market ,w ); return;
+        case 4: toBinary( p.deposit ,w ); return;
+        case 5: toBinary( p.order ,w ); return;
+        case 6: toBinary( p.withdraw ,w ); return;
+        case 7: toBinary( p.stages[0] ,w ); return;
+        case 8: toBinary( p.stages[1] ,w ); return;
+        case 9: toBinary( p.stages[2] ,w ); return;
+        case 10: toBinary( p.intputOrders ,w ); return;
+        case 11: enumToBinary( p.stage ,w ); return;
+        case 12: toBinary( p.cancellable ,w ); return;
+        case 13: toBinary( p.timePlaced ,w ); return;
+        default: break;
+    }
+}
+
 template <> BrokerOrder &Zero( BrokerOrder &p ) {
     p.sequence = 0;
     p.type = BrokerOrder::marketOrder;
@@ -227,18 +291,21 @@ BrokerOp::Status getStatus( const BrokerOrder &order ) {
 //! CBroker
 
 IAPI_DEF CBroker::Start( Config &config ,const char *path ) {
-    if( IFAILED(m_orderBook.Open( "order" ,path ,true )) )
+    if( IFAILED(m_orderBook.Open( "order" ,path ,true )) || IFAILED(m_orderBook.Upgrade()) )
         return IERROR;
 
+    getBookShelf().registerBook( m_orderBook );
+
 //-- set config
     config.getSection("broker");
 
 //-- create open order list
-    m_orderBook.eachEntry( [this]( BrokerOrder::Id id ,BrokerOrder &order ) -> bool {
-        if( !isCompleted(order) )
-            addOpenOrder( order );
+    ListOf<BrokerOrder::Id> ids;
+
+    m_orderBook.listOrders( BrokerOrder::makingDeposit ,BrokerOrder::completed ,ids );
 
-        return true;
+    m_orderBook.eachListed( ids ,[this]( BrokerOrder::Id id ,BrokerOrder &order ) -> bool {
+        addOpenOrder( order ); return true;
     });
 
 //-- done
@@ -252,6 +319,8 @@ IAPI_DEF CBroker::Start( Config &config ,const char *path ) {
 IAPI_DEF CBroker::Stop() {
     m_started = false;
 
+    getBookShelf().releaseBook( m_orderBook );
+
     m_orderBook.Close();
 
     return IOK;
@@ -290,32 +359,27 @@ IAPI_DEF CBroker::listOpenOrders( ListOf<BrokerOrder::Id> &orders ) {
 }
 
 IAPI_DEF CBroker::findOpenOrders( ledger_t &orders ) {
-    //TODO id last open order in file to avoid going thru all history
+    ListOf<BrokerOrder::Id> ids;
 
-    m_orderBook.eachEntry( [&orders]( BrokerOrder::Id id ,BrokerOrder &order ) -> bool {
-        if( !isCompleted(order) ) orders[id] = order;
+    m_orderBook.listOrders( BrokerOrder::makingDeposit ,BrokerOrder::completed ,ids );
 
-        return true;
+    m_orderBook.eachListed( ids ,[&orders]( BrokerOrder::Id id ,BrokerOrder &order ) -> bool {
+        orders[id] = order; return true;
     });
 
     return IOK;
 }
 
 IAPI_DEF CBroker::findOrder( const guid_t &id ,BrokerOrder &order ,bool openOnly ) {
-    BrokerOrder::Id sequence = INVALID_ENTRY_VALUE;
-
-    m_orderBook.eachEntry( [&id,&sequence]( BrokerOrder::Id orderId ,BrokerOrder &p ) -> bool {
-        if( Equals( p.id ,id ) ) {
-            sequence = orderId; return false;
-        }
-
-        return true;
-    });
+    BrokerOrder::Id sequence = m_orderBook.findOrder( id );
 
     if( sequence == INVALID_ENTRY_VALUE )
         return INODATA;
 
-    return m_orderBook.getEntry( sequence ,order ) ? IOK : INODATA;
+    if( !m_orderBook.getEntry( sequence ,order ) )
+        return INODATA;
+
+    return openOnly && isCompleted(order) ? INODATA : IOK;
 }
 
 ///--
@@ -385,8 +449,12 @@ IAPI_DEF CBroker::processOrders() {
     if( !isBrokerEnabled() )
         return IREFUSED;
 
+    m_orderBook.Sync(); //! @note commits order updates grouped since last process
+
     time_t now = Now();
 
+    getBookShelf().Update( m_orderBook ,now );
+
     if( m_nextProcessTime > now )
         return IOK;
 
@@ -78,6 +78,8 @@ struct BrokerOp {
 
 DEFINE_MEMBER_API(BrokerOp);
 DEFINE_WITHSCHEMA_API(BrokerOp);
+DEFINE_MEMBER_BINARY_API(BrokerOp);
+DEFINE_WITHBINARY_API(BrokerOp);
 
 template <> BrokerOp &Zero( BrokerOp &p );
 
@@ -93,7 +95,7 @@ inline bool isCompleted( const BrokerOp &op ) {
 struct BrokerOrder : BookEntry {
     DECLARE_CLASSID(BROKERORDER_UUID)
 
-    static size_t sizeofEntry() { return 2048; };
+    static size_t sizeofEntry() { return 768; };
 
 //-- info
     guid_t id; //! globally unique order id
@@ -134,11 +136,56 @@ struct BrokerOrder : BookEntry {
 
 DEFINE_MEMBER_API(BrokerOrder);
 DEFINE_WITHSCHEMA_API(BrokerOrder);
+DEFINE_MEMBER_BINARY_API(BrokerOrder);
+DEFINE_WITHBINARY_API(BrokerOrder);
 
 template <> BrokerOrder &Zero( BrokerOrder &p );
 
 //--
-typedef CBookFile_<BrokerOrder> COrderBook;
+//! @brief order book, indexed by order id and by stage
+class COrderBook : public CBookFile_<BrokerOrder> {
+public:
+    COrderBook() : m_byId( "id" ,idKey ) ,m_byStage( "stage" ,stageKey ) {
+        addIndex( m_byId ); addIndex( m_byStage );
+    }
+
+    ~COrderBook() {
+        Close(); //! @note saving indexes while they still exist
+    }
+
+    entryid_t findOrder( const guid_t &id ) const {
+        return m_byId.find( toIndexKey(id) );
+    }
+
+    //! @brief orders with from <= stage < to, by stage then time placed
+    bool listOrders( BrokerOrder::Stage from ,BrokerOrder::Stage to ,ListOf<entryid_t> &ids ) const {
+        return m_byStage.list( from ,to ,ids );
+    }
+
+    //! @note open orders are still updated, they stay in current volume
+    entryid_t getArchiveLimit() override {
+        ListOf<entryid_t> ids;
+
+        listOrders( BrokerOrder::makingDeposit ,BrokerOrder::completed ,ids );
+
+        entryid_t limit = (entryid_t) getEntryCount();
+
+        for( auto id : ids ) limit = MIN( limit ,id );
+
+        return limit;
+    }
+
+protected:
+    static String idKey( const BrokerOrder &p ) { return toIndexKey( p.id ); }
+
+    static bool stageKey( const BrokerOrder &p ,int64_t &major ,int64_t &minor ) {
+        major = p.stage; minor = p.timePlaced; return true;
+    }
+
+    BookHashIndex_<BrokerOrder> m_byId;
+    BookOrderedIndex_<BrokerOrder> m_byStage;
+};
+
 typedef CBookDataSource_<BrokerOrder,BrokerOrder> COrderDataSource;
 
 BrokerOp::Status getStatus( const BrokerOrder &order );
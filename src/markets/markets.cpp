@@ -52,6 +52,34 @@ DEFINE_GETMEMBER(MarketDeposit) {
     }
 }
 
+DEFINE_SETMEMBER_BINARY(MarketDeposit) {
+    switch( m ) {
+        case 0: fromBinary( p.id ,r ); return;
+        case 1: fromBinary( p.txid ,r ); return;
+        case 2: fromBinary( p.amount ,r ); return;
+        case 3: fromBinary( p.fromAddress ,r ); return;
+        case 4: fromBinary( p.toAddress ,r ); return;
+        case 5: fromBinary( p.seenAt ,r ); return;
+        case 6: fromBinary( p.confirmations ,r ); return;
+        case 7: fromBinary( p.requiredConfirmations ,r ); return;
+        default: break;
+    }
+}
+
+DEFINE_GETMEMBER_BINARY(MarketDeposit) {
+    switch( m ) {
+        case 0: toBinary( p.id ,w ); return;
+        case 1: toBinary( p.txid ,w ); return;
+        case 2: toBinary( p.amount ,w ); return;
+        case 3: toBinary( p.fromAddress ,w ); return;
+        case 4: toBinary( p.toAddress ,w ); return;
+        case 5: toBinary( p.seenAt ,w ); return;
+        case 6: toBinary( p.confirmations ,w ); return;
+        case 7: toBinary( p.requiredConfirmations ,w ); return;
+        default: break;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //! MarketWithdraw
 
@@ -98,6 +126,36 @@ DEFINE_GETMEMBER(MarketWithdraw) {
     }
 }
 
+DEFINE_SETMEMBER_BINARY(MarketWithdraw) {
+    switch( m ) {
+        case 0: fromBinary( p.id ,r ); return;
+        case 1: fromBinary( p.txid ,r ); return;
+        case 2: fromBinary( p.amount ,r ); return;
+        case 3: fromBinary( p.fee ,r ); return;
+        case 4: fromBinary( p.fromAddress ,r ); return;
+        case 5: fromBinary( p.toAddress ,r ); return;
+        case 6: fromBinary( p.status ,r ); return;
+        case 7: fromBinary( p.postedAt ,r ); return;
+        case 8: fromBinary( p.sentAt ,r ); return;
+        default: break;
+    }
+}
+
+DEFINE_GETMEMBER_BINARY(MarketWithdraw) {
+    switch( m ) {
+        case 0: toBinary( p.id ,w ); return;
+        case 1: toBinary( p.txid ,w ); return;
+        case 2: toBinary( p.amount ,w ); return;
+        case 3: toBinary( p.fee ,w ); return;
+        case 4: toBinary( p.fromAddress ,w ); return;
+        case 5: toBinary( p.toAddress ,w ); return;
+        case 6: toBinary( p.status ,w ); return;
+        case 7: toBinary( p.postedAt ,w ); return;
+        case 8: toBinary( p.sentAt ,w ); return;
+        default: break;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //! MarketOrder
 
@@ -153,6 +211,42 @@ DEFINE_GETMEMBER(MarketOrder) {
     }
 }
 
+DEFINE_SETMEMBER_BINARY(MarketOrder) {
+    switch( m ) {
+        case 0: fromBinary( p.id ,r ); return;
+        case 1: fromBinary( p.userId ,r ); return;
+        case 2: fromBinary( p.amount ,r ); return;
+        case 3: fromBinary( p.toValue ,r ); return;
+        case 4: fromBinary( p.price ,r ); return;
+        case 5: fromBinary( p.validity ,r ); return;
+        case 6: fromBinary( p.quantityFilled ,r ); return;
+        case 7: fromBinary( p.status ,r ); return;
+        case 8: fromBinary( p.seenAt ,r ); return;
+        case 9: fromBinary( p.createdAt ,r ); return;
+        case 10: fromBinary( p.lastTradeAt ,r ); return;
+        case 11: fromBinary( p.completedAt ,r ); return;
+        default: break;
+    }
+}
+
+DEFINE_GETMEMBER_BINARY(MarketOrder) {
+    switch( m ) {
+        case 0: toBinary( p.id ,w ); return;
+        case 1: toBinary( p.userId ,w ); return;
+        case 2: toBinary( p.amount ,w ); return;
+        case 3: toBinary( p.toValue ,w ); return;
+        case 4: toBinary( p.price ,w ); return;
+        case 5: toBinary( p.validity ,w ); return;
+        case 6: toBinary( p.quantityFilled ,w ); return;
+        case 7: toBinary( p.status ,w ); return;
+        case 8: toBinary( p.seenAt ,w ); return;
+        case 9: toBinary( p.createdAt ,w ); return;
+        case 10: toBinary( p.lastTradeAt ,w ); return;
+        case 11: toBinary( p.completedAt ,w ); return;
+        default: break;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 void fromMarketSymbol( const String &s ,String &primary ,String &secondary ,const char sep ) {
     const char *c = s.c_str();
@@ -25,12 +25,18 @@ String &toMarketSymbol( String &s ,const String &primary ,const String &secondar
 //////////////////////////////////////////////////////////////////////////////
 DEFINE_MEMBER_API(MarketDeposit);
 DEFINE_WITHSCHEMA_API(MarketDeposit);
+DEFINE_MEMBER_BINARY_API(MarketDeposit);
+DEFINE_WITHBINARY_API(MarketDeposit);
 
 DEFINE_MEMBER_API(MarketWithdraw);
 DEFINE_WITHSCHEMA_API(MarketWithdraw);
+DEFINE_MEMBER_BINARY_API(MarketWithdraw);
+DEFINE_WITHBINARY_API(MarketWithdraw);
 
 DEFINE_MEMBER_API(MarketOrder);
 DEFINE_WITHSCHEMA_API(MarketOrder);
+DEFINE_MEMBER_BINARY_API(MarketOrder);
+DEFINE_WITHBINARY_API(MarketOrder);
 
 //////////////////////////////////////////////////////////////////////////////
 #define CMARKETSERVICEBASE_PUID 0x05351473824d4dd47
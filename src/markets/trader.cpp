@@ -7,6 +7,8 @@
 
 #include <solominer.h>
 
+#include <algorithm>
+
 //////////////////////////////////////////////////////////////////////////////
 namespace solominer {
 
@@ -173,6 +175,48 @@ DEFINE_GETMEMBER(TradeInfo) {
     }
 }
 
+DEFINE_SETMEMBER_BINARY(TradeInfo) {
+    switch( m ) {
+        case 0: fromBinary( p.id ,r ); return;
+        case 1: fromBinary( p.market ,r ); return;
+        case 2: fromBinary( p.amount ,r ); return;
+        case 3: fromBinary( p.toValue ,r ); return;
+        case 4: fromBinary( p.price ,r ); return;
+        case 5: fromBinary( p.depositFromAddress ,r ); return;
+        case 6: fromBinary( p.withdrawToAddress ,r ); return;
+        case 7: enumFromBinary( p.schedule ,r ); return;
+        case 8: fromBinary( p.timeToExecute ,r ); return;
+        case 9: fromBinary( p.orderId ,r ); return;
+        case 10: enumFromBinary( p.status ,r ); return;
+        case 11: fromBinary( p.timeRecorded ,r ); return;
+        case 12: fromBinary( p.timePlaced ,r ); return;
+        case 13: fromBinary( p.timeExecuted ,r ); return;
+        case 14: fromBinary( p.timeCompleted ,r ); return;
+        default: break;
+    }
+}
+
+DEFINE_GETMEMBER_BINARY(TradeInfo) {
+    switch( m ) {
+        case 0: toBinary( p.id ,w ); return;
+        case 1: toBinary( p.market ,w ); return;
+        case 2: toBinary( p.amount ,w ); return;
+        case 3: toBinary( p.toValue ,w ); return;
+        case 4: toBinary( p.price ,w ); return;
+        case 5: toBinary( p.depositFromAddress ,w ); return;
+        case 6: toBinary( p.withdrawToAddress ,w ); return;
+        case 7: enumToBinary( p.schedule ,w ); return;
+        case 8: toBinary( p.timeToExecute ,w ); return;
+        case 9: toBinary( p.orderId ,w ); return;
+        case 10: enumToBinary( p.status ,w ); return;
+        case 11: toBinary( p.timeRecorded ,w ); return;
+        case 12: toBinary( p.timePlaced ,w ); return;
+        case 13: toBinary( p.timeExecuted ,w ); return;
+        case 14: toBinary( p.timeCompleted ,w ); return;
+        default: break;
+    }
+}
+
 //--
 template <> TradeInfo &Zero( TradeInfo &p ) {
     p.sequence = 0;
@@ -246,9 +290,11 @@ bool matchValue( const AmountValue &requested ,const String &proposed ) {
 IAPI_DEF CTrader::Start( Config &config ,const char *path ) {
 
 //-- open trade book
-    if( IFAILED(m_tradeBook.Open( "trade" ,path ,true )) )
+    if( IFAILED(m_tradeBook.Open( "trade" ,path ,true )) || IFAILED(m_tradeBook.Upgrade()) )
         return IERROR;
 
+    getBookShelf().registerBook( m_tradeBook );
+
 //-- set config
     auto &traderConfig = config.getSection("trader");
 
@@ -264,11 +310,12 @@ IAPI_DEF CTrader::Start( Config &config ,const char *path ) {
     m_nextScheduleTime = 0;
 
 //-- create pending order list
-    m_tradeBook.eachEntry( [this]( TradeInfo::Id id ,TradeInfo &trade ) -> bool {
-        if( trade.status < TradeInfo::placed )
-            addTradeToOrders( trade );
+    ListOf<TradeInfo::Id> ids;
+
+    m_tradeBook.listTrades( TradeInfo::noStatus ,TradeInfo::placed ,ids );
 
-        return true;
+    m_tradeBook.eachListed( ids ,[this]( TradeInfo::Id id ,TradeInfo &trade ) -> bool {
+        addTradeToOrders( trade ); return true;
     });
 
 //-- subscribe to broker events
@@ -284,6 +331,8 @@ IAPI_DEF CTrader::Stop() {
 
     m_started = false;
 
+    getBookShelf().releaseBook( m_tradeBook );
+
     m_tradeBook.Close();
 
     return IOK;
@@ -298,11 +347,7 @@ IAPI_DEF CTrader::getTradeHistory( id_t begin ,id_t end ,ledger_t &trades ) {
 IAPI_DEF CTrader::listOpenTrades( ListOf<TradeInfo::Id> &trades ) {
     trades.clear();
 
-    m_tradeBook.eachEntry( [&trades]( TradeInfo::Id id ,TradeInfo &trade ) -> bool {
-        if( !isCompleted(trade) ) trades.emplace_back(id);
-
-        return true; //TODO id last open trade in file to avoid going thru all history
-    });
+    m_tradeBook.listTrades( TradeInfo::noStatus ,TradeInfo::completed ,trades );
 
     /* for( const auto &order : this->m_pendingOrders ) {
         for( const auto &tradeId : order.trades ) {
@@ -316,18 +361,27 @@ IAPI_DEF CTrader::listOpenTrades( ListOf<TradeInfo::Id> &trades ) {
 }
 
 IAPI_DEF CTrader::findOpenTrades( ledger_t &trades ) {
-    m_tradeBook.eachEntry( [&trades]( TradeInfo::Id id ,TradeInfo &trade ) -> bool {
-        if( !isCompleted(trade) ) trades[id] = trade;
+    ListOf<TradeInfo::Id> ids;
+
+    m_tradeBook.listTrades( TradeInfo::noStatus ,TradeInfo::completed ,ids );
 
-        return true; //TODO id last open trade in file to avoid going thru all history
+    m_tradeBook.eachListed( ids ,[&trades]( TradeInfo::Id id ,TradeInfo &trade ) -> bool {
+        trades[id] = trade; return true;
     });
 
     return IOK;
 }
 
 IAPI_DEF CTrader::findTrade( const guid_t &id ,TradeInfo &trade ,bool openOnly ) {
-    _TODO; return INOEXEC;
-    // return INODATA;
+    TradeInfo::Id sequence = m_tradeBook.findTrade( id );
+
+    if( sequence == INVALID_ENTRY_VALUE )
+        return INODATA;
+
+    if( !m_tradeBook.getEntry( sequence ,trade ) )
+        return INODATA;
+
+    return openOnly && isCompleted(trade) ? INODATA : IOK;
 }
 
 ///--
@@ -385,9 +439,13 @@ IAPI_DEF CTrader::processTrades() {
     if( !isTraderEnabled() )
         return IREFUSED;
 
+    m_tradeBook.Sync(); //! @note commits trade updates grouped since last process
+
 //--
     time_t now = Now();
 
+    getBookShelf().Update( m_tradeBook ,now );
+
     if( m_nextScheduleTime > now )
         return IOK;
 
@@ -431,9 +489,15 @@ IAPI_DEF CTrader::updateTrade( const TradeInfo &trade ) {
 
 ///-- IBrokerEvents
 IAPI_DEF CTrader::onOrderUpdate( CBroker &broker ,const BrokerOrder &order ) {
+    ListOf<TradeInfo::Id> ids;
+
+    if( !m_tradeBook.listOrderTrades( order.id ,ids ) )
+        return IOK;
+
+    //! @note latest trade of the order first, as when walking the book backward
+    std::reverse( ids.begin() ,ids.end() );
 
-    m_tradeBook.eachEntry( [this,order]( BookEntry::Id id ,TradeInfo &trade ) -> bool {
-        if( !Equals( trade.orderId ,order.id ) ) return true;
+    m_tradeBook.eachListed( ids ,[this,order]( BookEntry::Id id ,TradeInfo &trade ) -> bool {
 
         TradeInfo::Status status = trade.status;
 
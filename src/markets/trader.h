@@ -93,7 +93,7 @@ time_t getConfigSchedule( const TraderConfig &config ,const char *market );
 struct TradeInfo : BookEntry {
     DECLARE_CLASSID(TRADEINFO_UUID)
 
-    static size_t sizeofEntry() { return 1024; };
+    static size_t sizeofEntry() { return 512; }; //! @note two addresses, spills to a larger size beyond
 
 //-- info
     guid_t id; //! globally unique trade id
@@ -135,11 +135,62 @@ struct TradeInfo : BookEntry {
 
 DEFINE_MEMBER_API(TradeInfo);
 DEFINE_WITHSCHEMA_API(TradeInfo);
+DEFINE_MEMBER_BINARY_API(TradeInfo);
+DEFINE_WITHBINARY_API(TradeInfo);
 
 template <> TradeInfo &Zero( TradeInfo &p );
 
 //--
-typedef CBookFile_<TradeInfo> CTradeBook;
+//! @brief trade book, indexed by trade id, by order and by status
+class CTradeBook : public CBookFile_<TradeInfo> {
+public:
+    CTradeBook() : m_byId( "id" ,idKey ) ,m_byOrder( "order" ,orderKey ) ,m_byStatus( "status" ,statusKey ) {
+        addIndex( m_byId ); addIndex( m_byOrder ); addIndex( m_byStatus );
+    }
+
+    ~CTradeBook() {
+        Close(); //! @note saving indexes while they still exist
+    }
+
+    entryid_t findTrade( const guid_t &id ) const {
+        return m_byId.find( toIndexKey(id) );
+    }
+
+    bool listOrderTrades( const guid_t &orderId ,ListOf<entryid_t> &ids ) const {
+        return m_byOrder.list( toIndexKey(orderId) ,ids );
+    }
+
+    //! @brief trades with from <= status < to, by status then time recorded
+    bool listTrades( TradeInfo::Status from ,TradeInfo::Status to ,ListOf<entryid_t> &ids ) const {
+        return m_byStatus.list( from ,to ,ids );
+    }
+
+    //! @note open trades are still updated, they stay in current volume
+    entryid_t getArchiveLimit() override {
+        ListOf<entryid_t> ids;
+
+        listTrades( TradeInfo::noStatus ,TradeInfo::completed ,ids );
+
+        entryid_t limit = (entryid_t) getEntryCount();
+
+        for( auto id : ids ) limit = MIN( limit ,id );
+
+        return limit;
+    }
+
+protected:
+    static String idKey( const TradeInfo &p ) { return toIndexKey( p.id ); }
+    static String orderKey( const TradeInfo &p ) { return toIndexKey( p.orderId ); }
+
+    static bool statusKey( const TradeInfo &p ,int64_t &major ,int64_t &minor ) {
+        major = p.status; minor = p.timeRecorded; return true;
+    }
+
+    BookHashIndex_<TradeInfo> m_byId;
+    BookHashIndex_<TradeInfo> m_byOrder;
+    BookOrderedIndex_<TradeInfo> m_byStatus;
+};
+
 typedef CBookDataSource_<TradeInfo,TradeInfo> CTradeDataSource;
 
 inline bool isCompleted( const TradeInfo &trade ) {
@@ -125,24 +125,45 @@ void parseResponseList_( rapidjson::Value &v ,ListOf<T> &list ) {
     }
 }
 
-template <class T>
-bool parseResponseList_( const String &response ,ListOf<T> &list ) {
-    if( response.empty() )
-        return false;
+//////////////////////////////////////////////////////////////////////////////
+//! Json stream parse
+
+//! @brief rapidjson input stream over http response
+struct JsonStream {
+    typedef char Ch;
+
+    IHttp::IStream &stream;
+
+    JsonStream( IHttp::IStream &a_stream ) : stream(a_stream) {}
+
+    Ch Peek() { return stream.Peek(); }
+    Ch Take() { return stream.Take(); }
+    size_t Tell() const { return stream.Tell(); }
 
+    //! @note read only
+    Ch *PutBegin() { assert(false); return nullptr; }
+    void Put( Ch ) { assert(false); }
+    void Flush() { assert(false); }
+    size_t PutEnd( Ch * ) { assert(false); return 0; }
+};
+
+template <class T>
+bool parseResponseStruct_( JsonStream &stream ,T &s ) {
     try {
         rapidjson::Document jsondoc;
 
-        if( strncmp( response.c_str() ,"error" ,6 ) == 0 )
-            return false;
+        jsondoc.ParseStream<rapidjson::kParseStopWhenDoneFlag>( stream );
 
-        jsondoc.Parse( response.c_str() );
+        if( jsondoc.HasParseError() )
+            return false;
 
         rapidjson::Value &v = jsondoc;
+        {
+            if( !v.IsObject() || v.HasMember("error") )
+                return false;
 
-        if( !v.IsArray() ) return false;
-
-        parseResponseList_( v ,list );
+            parseResponseValue_( v ,s );
+        }
 
     } catch( ... ) {
         return false;
@@ -151,6 +172,78 @@ bool parseResponseList_( const String &response ,ListOf<T> &list ) {
     return true;
 }
 
+//! @note decoded item per item as received, only the current item document is held
+template <class T>
+bool parseResponseList_( JsonStream &stream ,ListOf<T> &list ) {
+    rapidjson::SkipWhitespace( stream );
+
+    if( stream.Take() != '[' )
+        return false; //! @note IE error object
+
+    rapidjson::SkipWhitespace( stream );
+
+    if( stream.Peek() == ']' )
+        return true;
+
+    try {
+        for(;;) {
+            rapidjson::Document item;
+
+            item.ParseStream<rapidjson::kParseStopWhenDoneFlag>( stream );
+
+            if( item.HasParseError() )
+                return false;
+
+            rapidjson::Value &v = item;
+
+            T s;
+
+            parseResponseValue_( v ,s );
+
+            list.emplace_back( s );
+
+            rapidjson::SkipWhitespace( stream );
+
+            switch( stream.Take() ) {
+                case ',': break;
+                case ']': return true;
+                default: return false;
+            }
+        }
+    } catch( ... ) {
+        return false;
+    }
+}
+
+///-- readers
+template <class T>
+struct StructReader_ : IHttp::IReader {
+    T &s;
+    bool parsed = false;
+
+    StructReader_( T &a_s ) : s(a_s) {}
+
+    bool Read( IHttp::IStream &stream ) override {
+        JsonStream json( stream );
+
+        return parsed = parseResponseStruct_( json ,s );
+    }
+};
+
+template <class T>
+struct ListReader_ : IHttp::IReader {
+    ListOf<T> &list;
+    bool parsed = false;
+
+    ListReader_( ListOf<T> &a_list ) : list(a_list) {}
+
+    bool Read( IHttp::IStream &stream ) override {
+        JsonStream json( stream );
+
+        return parsed = parseResponseList_( json ,list );
+    }
+};
+
 ///--
 const char *getJsonString( rapidjson::Value &v ,const char *memberId ,const char *defaultValue="" ) {
     try {
@@ -647,31 +740,31 @@ bool CApi2::assetGetList( ListOf<Asset> &assets ) {
 }
 
 bool CApi2::assetGetById( const char *id ,Asset &asset ) {
-    String response; long status;
+    StructReader_<Asset> reader( asset );
 
-    if( !HttpSend( "/asset/getbyid/" ,id ,nullptr ,response ,status ) )
+    if( !HttpRead( "/asset/getbyid/" ,id ,nullptr ,reader ) )
         return( false );
 
-    return parseResponseStruct_( response ,asset );
+    return reader.parsed;
 }
 
 bool CApi2::assetGetByTicker( const char *ticker ,Asset &asset ) {
-    String response; long status;
+    StructReader_<Asset> reader( asset );
 
-    if( !HttpSend( "/asset/getbyticker/" ,ticker ,nullptr ,response ,status ) )
+    if( !HttpRead( "/asset/getbyticker/" ,ticker ,nullptr ,reader ) )
         return( false );
 
-    return parseResponseStruct_( response ,asset );
+    return reader.parsed;
 }
 
 ///-- market
 bool CApi2::marketGetList( ListOf<MarketByList> &markets ) {
-    String response; long status;
+    ListReader_<MarketByList> reader( markets );
 
-    if( !HttpSend( "/market/getlist" ,nullptr ,nullptr ,response ,status ) )
+    if( !HttpRead( "/market/getlist" ,nullptr ,nullptr ,reader ) )
         return( false );
 
-    return parseResponseList_( response ,markets );
+    return reader.parsed;
 }
 
 bool CApi2::marketGetById( const char *id ,Market &market ) {
@@ -684,13 +777,13 @@ bool CApi2::marketGetBySymbol( const char *symbol ,Market2 &market ) {
     if( noMarket.find(symbol) != noMarket.end() )
         return false;
 
-    String response; long status;
+    StructReader_<Market2> reader( market );
 
-    if( !HttpSend( "/market/getbysymbol/" ,symbol ,nullptr ,response ,status ,false ,false ) ) {
+    if( !HttpRead( "/market/getbysymbol/" ,symbol ,nullptr ,reader ,false ,false ) ) {
         return( false );
     }
 
-    if( !parseResponseStruct_( response ,market ) ) {
+    if( !reader.parsed ) {
         return noMarket[symbol] = false;
     }
 
@@ -698,25 +791,25 @@ bool CApi2::marketGetBySymbol( const char *symbol ,Market2 &market ) {
 }
 
 bool CApi2::marketGetOrderBookBySymbol( const char *symbol ,OrderBook &book ) {
-    String response; long status;
+    StructReader_<OrderBook> reader( book );
 
-    if( !HttpSend( "/market/getorderbookbysymbol/" ,symbol ,nullptr ,response ,status ,false ,m_noCache ) )
+    if( !HttpRead( "/market/getorderbookbysymbol/" ,symbol ,nullptr ,reader ,false ,m_noCache ) )
         return( false );
 
     m_noCache = false;
 
-    return parseResponseStruct_( response ,book );
+    return reader.parsed;
 }
 
 bool CApi2::marketGetOrderBookByMarketId( const char *marketId ,OrderBook &book ) {
-    String response; long status;
+    StructReader_<OrderBook> reader( book );
 
-    if( !HttpSend( "/market/getorderbookbymarketid/" ,marketId ,nullptr ,response ,status ,false ,m_noCache ) )
+    if( !HttpRead( "/market/getorderbookbymarketid/" ,marketId ,nullptr ,reader ,false ,m_noCache ) )
         return( false );
 
     m_noCache = false;
 
-    return parseResponseStruct_( response ,book );
+    return reader.parsed;
 }
 
 ///-- pool
@@ -727,37 +820,41 @@ bool CApi2::marketGetOrderBookByMarketId( const char *marketId ,OrderBook &book
 ///-- account
 
 bool CApi2::balances( ListOf<Balance> &balances ) {
-    String response; long status;
+    ListReader_<Balance> reader( balances );
 
-    if( !HttpSend( "/balances" ,nullptr ,nullptr ,response ,status ,true ,true ) )
+    if( !HttpRead( "/balances" ,nullptr ,nullptr ,reader ,true ,true ) )
         return( false );
 
-    return parseResponseList_( response ,balances );
+    return reader.parsed;
 }
 
 bool CApi2::getDepositAddress( const char *ticker ,DepositAddress &address ) {
-    String response; long status;
+    StructReader_<DepositAddress> reader( address );
 
-    if( !HttpSend( "/getdepositaddress/" ,ticker ,nullptr ,response ,status ,true ) )
+    if( !HttpRead( "/getdepositaddress/" ,ticker ,nullptr ,reader ,true ) )
         return( false );
 
-    return parseResponseStruct_( response ,address );
+    return reader.parsed;
 }
 
 ///-- POST
 bool CApi2::CreateOrder( const OrderToCreate &createOrder ,OrderCreated &order ) {
-    String body ,response; long status;
+    String body;
+
+    StructReader_<OrderCreated> reader( order );
 
     generateBodyStruct_( createOrder ,body );
 
-    if( !HttpSend( "/createorder" ,nullptr ,body.c_str() ,response ,status ,true ) )
+    if( !HttpRead( "/createorder" ,nullptr ,body.c_str() ,reader ,true ) )
         return( false );
 
-    return parseResponseStruct_( response ,order );
+    return reader.parsed;
 }
 
 bool CApi2::CancelOrder( const char *orderId ,OrderCancelled &order ) {
-    String body ,response; long status;
+    String body;
+
+    StructReader_<OrderCancelled> reader( order );
 
     OrderToCancel cancelOrder;
 
@@ -765,141 +862,145 @@ bool CApi2::CancelOrder( const char *orderId ,OrderCancelled &order ) {
 
     generateBodyStruct_( cancelOrder ,body );
 
-    if( !HttpSend( "/cancelorder" ,nullptr ,body.c_str() ,response ,status ,true ) )
+    if( !HttpRead( "/cancelorder" ,nullptr ,body.c_str() ,reader ,true ) )
         return( false );
 
-    return parseResponseStruct_( response ,order );
+    return reader.parsed;
 }
 
 bool CApi2::CancelAllOrders( const OrdersToCancelAll &cancelOrders ,OrdersCancelledAll &orders ) {
-    String body ,response; long status;
+    String body;
+
+    StructReader_<OrdersCancelledAll> reader( orders );
 
     generateBodyStruct_( cancelOrders ,body );
 
-    if( !HttpSend( "/cancelallorders" ,nullptr ,body.c_str() ,response ,status ,true ) )
+    if( !HttpRead( "/cancelallorders" ,nullptr ,body.c_str() ,reader ,true ) )
         return( false );
 
-    return parseResponseStruct_( response ,orders );
+    return reader.parsed;
 }
 
 bool CApi2::CreateWithdrawal( const WithdrawalToCreate &createWithdrawal ,WithdrawalCreated &withdrawal ) {
-    String body ,response; long status;
+    String body;
+
+    StructReader_<WithdrawalCreated> reader( withdrawal );
 
     generateBodyStruct_( createWithdrawal ,body );
 
-    if( !HttpSend( "/createwithdrawal" ,nullptr ,body.c_str() ,response ,status ,true ) )
+    if( !HttpRead( "/createwithdrawal" ,nullptr ,body.c_str() ,reader ,true ) )
         return( false );
 
-    return parseResponseStruct_( response ,withdrawal );
+    return reader.parsed;
 }
 
 ///--
 bool CApi2::getDeposits( const char *ticker ,ListOf<Deposit> &deposits ,int limit ,int skip ) {
-    String response; long status;
+    ListReader_<Deposit> reader( deposits );
 
     std::stringstream ss;
 
     ss << "?ticker=" << ticker << "&limit=" << limit << "&skip=" << skip;
 
-    if( !HttpSend( "/getdeposits" ,ss.str().c_str() ,nullptr ,response ,status ,true ,true ) )
+    if( !HttpRead( "/getdeposits" ,ss.str().c_str() ,nullptr ,reader ,true ,true ) )
         return( false );
 
-    return parseResponseList_( response ,deposits );
+    return reader.parsed;
 }
 
 bool CApi2::getWithdrawals( const char *ticker ,ListOf<Withdrawal> &withdrawals ,int limit ,int skip ) {
-    String response; long status;
+    ListReader_<Withdrawal> reader( withdrawals );
 
     std::stringstream ss;
 
     ss << "?ticker=" << ticker << "&limit=" << limit << "&skip=" << skip;
 
-    if( !HttpSend( "/getwithdrawals" ,ss.str().c_str() ,nullptr ,response ,status ,true ,true ) )
+    if( !HttpRead( "/getwithdrawals" ,ss.str().c_str() ,nullptr ,reader ,true ,true ) )
         return( false );
 
-    return parseResponseList_( response ,withdrawals );
+    return reader.parsed;
 }
 
 bool CApi2::getOrder( const char *orderId ,Order &order ) {
-    String response; long status;
+    StructReader_<Order> reader( order );
 
     //! orderId = orderId | userProvidedId
-    if( !HttpSend( "/getorder/" ,orderId ,nullptr ,response ,status ,true ,true ) )
+    if( !HttpRead( "/getorder/" ,orderId ,nullptr ,reader ,true ,true ) )
         return( false );
 
-    return parseResponseStruct_( response ,order );
+    return reader.parsed;
 }
 
 bool CApi2::getOrders( const char *marketPair ,const char *orderStatus ,ListOf<Order> &orders ,int limit ,int skip ) {
-    String response; long status;
+    ListReader_<Order> reader( orders );
 
     std::stringstream ss;
 
     ss << "?symbol=" << marketPair << "&status=" << orderStatus << "&limit=" << limit << "&skip=" << skip;
 
-    if( !HttpSend( "/getorders" ,ss.str().c_str() ,nullptr ,response ,status ,true ,true ) )
+    if( !HttpRead( "/getorders" ,ss.str().c_str() ,nullptr ,reader ,true ,true ) )
         return( false );
 
-    return parseResponseList_( response ,orders );
+    return reader.parsed;
 }
 
 bool CApi2::getTrades( const char *symbol ,ListOf<Trade> &trades ,int limit ,int skip ) {
-    String response; long status;
+    ListReader_<Trade> reader( trades );
 
     std::stringstream ss;
 
     ss << "?symbol=" << symbol << "&limit=" << limit << "&skip=" << skip;
 
-    if( !HttpSend( "/gettrades" ,ss.str().c_str() ,nullptr ,response ,status ,true ,true ) )
+    if( !HttpRead( "/gettrades" ,ss.str().c_str() ,nullptr ,reader ,true ,true ) )
         return( false );
 
-    return parseResponseList_( response ,trades );
+    return reader.parsed;
 }
 
 bool CApi2::getTradesSince( const char *symbol ,ListOf<Trade> &trades ,const char *sinceTimestampMs ,int limit ,int skip ) {
-    String response; long status;
+    ListReader_<Trade> reader( trades );
 
     std::stringstream ss;
 
     ss << "?symbol=" << symbol << "&since=" << sinceTimestampMs << "&limit=" << limit << "&skip=" << skip;
 
-    if( !HttpSend( "/gettradessince" ,ss.str().c_str() ,nullptr ,response ,status ,true ,true ) )
+    if( !HttpRead( "/gettradessince" ,ss.str().c_str() ,nullptr ,reader ,true ,true ) )
         return( false );
 
-    return parseResponseList_( response ,trades );
+    return reader.parsed;
 }
 
 bool CApi2::getPoolTrades( const char *symbol ,ListOf<PoolTrade> &trades ,int limit ,int skip ) {
-    String response; long status;
+    ListReader_<PoolTrade> reader( trades );
 
     std::stringstream ss;
 
     ss << "?symbol=" << symbol << "&limit=" << limit << "&skip=" << skip;
 
-    if( !HttpSend( "/getpolltrades" ,ss.str().c_str() ,nullptr ,response ,status ,true ,true ) )
+    if( !HttpRead( "/getpolltrades" ,ss.str().c_str() ,nullptr ,reader ,true ,true ) )
         return( false );
 
-    return parseResponseList_( response ,trades );
+    return reader.parsed;
 }
 
 bool CApi2::getPoolTradesSince( const char *symbol ,ListOf<PoolTrade> &trades ,const char *sinceTimestampMs ,int limit ,int skip ) {
-    String response; long status;
+    ListReader_<PoolTrade> reader( trades );
 
     std::stringstream ss;
 
     ss << "?symbol=" << symbol << "&since=" << sinceTimestampMs << "&limit=" << limit << "&skip=" << skip;
 
-    if( !HttpSend( "/getpooltradessince" ,ss.str().c_str() ,nullptr ,response ,status ,true ,true ) )
+    if( !HttpRead( "/getpooltradessince" ,ss.str().c_str() ,nullptr ,reader ,true ,true ) )
         return( false );
 
-    return parseResponseList_( response ,trades );
+    return reader.parsed;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 //! protected
 
-bool CApi2::HttpSend( const char *path ,const char *param ,const char *body ,String &response ,long &status ,bool needAuth ,bool noCache ) {
+bool CApi2::HttpRead( const char *path ,const char *param ,const char *body ,IHttp::IReader &reader ,bool needAuth ,bool noCache ) {
     std::stringstream ss;
 
     ss << XEGGEX_HOSTNAME << XEGGEX_API2_PATH << path;
@@ -935,7 +1036,9 @@ bool CApi2::HttpSend( const char *path ,const char *param ,const char *body ,Str
         }
     }
 
-    return m_http.HttpSend( ss.str().c_str() ,headers ,userpass.c_str() ,body ,response ,status );
+    long status;
+
+    return m_http.HttpRead( ss.str().c_str() ,headers ,userpass.c_str() ,body ,reader ,status );
 }
 
 //////////////////////////////////////////////////////////////////////////////
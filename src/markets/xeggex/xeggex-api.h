@@ -454,7 +454,22 @@ class IHttp {
 public:
     typedef std::map<String,String> Headers;
 
-    virtual bool HttpSend( const char *url ,const Headers &headers ,const char *userpass ,const char *body ,String &response ,long &status ) = 0;
+    //! @brief pull stream over the response body, as it is received
+    class IStream {
+    public:
+        virtual char Peek() = 0; //! '\0' at end of response
+        virtual char Take() = 0;
+        virtual size_t Tell() const = 0;
+    };
+
+    //! @brief response consumer, decodes from stream
+    class IReader {
+    public:
+        virtual bool Read( IStream &stream ) = 0;
+    };
+
+    //! @note returns false on transfer failure only, decoding result is the reader's
+    virtual bool HttpRead( const char *url ,const Headers &headers ,const char *userpass ,const char *body ,IReader &reader ,long &status ) = 0;
 };
 
 bool authorizeApiBasic( const ApiCredential &credential ,IHttp::Headers &headers ,const char *url ,const char *body );
@@ -527,7 +542,7 @@ public: ///-- account
 //! Member functions
 
 protected:
-    bool HttpSend( const char *path ,const char *param ,const char *body ,String &response ,long &status ,bool needAuth=false ,bool noCache=false );
+    bool HttpRead( const char *path ,const char *param ,const char *body ,IHttp::IReader &reader ,bool needAuth=false ,bool noCache=false );
 };
 
 //////////////////////////////////////////////////////////////////////////////
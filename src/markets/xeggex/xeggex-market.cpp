@@ -552,7 +552,20 @@ IAPI_DEF CMarketXeggex::listOrders( const char *pair ,std::vector<MarketOrder> &
 }
 
 //////////////////////////////////////////////////////////////////////////////
-bool CMarketXeggex::HttpSend( const char *url ,const Headers &headers ,const char *userpass ,const char *body ,String &response ,long &status ) {
+//! @brief xeggex api stream over http stream
+class CXeggexStream : public xeggex::IHttp::IStream {
+protected:
+    CHttpStream &m_stream;
+
+public:
+    CXeggexStream( CHttpStream &stream ) : m_stream(stream) {}
+
+    char Peek() IOVERRIDE { return m_stream.Peek(); }
+    char Take() IOVERRIDE { return m_stream.Take(); }
+    size_t Tell() const IOVERRIDE { return m_stream.Tell(); }
+};
+
+bool CMarketXeggex::HttpRead( const char *url ,const Headers &headers ,const char *userpass ,const char *body ,IReader &reader ,long &status ) {
 
 //-- content
     HttpMessage message;
@@ -567,19 +580,25 @@ bool CMarketXeggex::HttpSend( const char *url ,const Headers &headers ,const cha
     request.headers() = headers;
     request.userpass() = userpass;
 
-//-- method
-    HttpResponse httpResponse;
+    //! @note trading first, then account queries, public market data last
+    request.priority() = body ? quotaTrading : (userpass && userpass[0]) ? quotaAccount : quotaRefresh;
 
-    iresult_t result = m_http.sendRequest( url ,body ? HttpMethod::methodPOST : HttpMethod::methodGET ,message ,request ,httpResponse );
+    m_http.makeRequest( url ,body ? HttpMethod::methodPOST : HttpMethod::methodGET ,message ,request );
 
-    response = httpResponse.content;
-    status = (long) httpResponse.status;
+//-- stream
+    CHttpStream stream;
+
+    iresult_t result = m_http.Stream( request ,stream );
+
+    status = (long) stream.status();
 
     IF_IFAILED( result ) {
         return false;
     }
 
-    m_http.adviseRequestValid( request );
+    CXeggexStream xstream( stream );
+
+    reader.Read( xstream );
 
     return true;
 };
@@ -98,7 +98,7 @@ public: ///-- xeggex::IHttp
 
     //TODO should be able to get asynch
 
-    API_IMPL(bool) HttpSend( const char *url ,const Headers &headers ,const char *userpass ,const char *body ,String &response ,long &status ) IOVERRIDE;
+    API_IMPL(bool) HttpRead( const char *url ,const Headers &headers ,const char *userpass ,const char *body ,IReader &reader ,long &status ) IOVERRIDE;
 };
 
 //////////////////////////////////////////////////////////////////////////////
@@ -6,6 +6,8 @@
 #include "miners.h"
 #include "connections.h"
 
+#include <solominer.h>
+
 //////////////////////////////////////////////////////////////////////////////
 //! Embedded xmrig
 
@@ -15,6 +17,9 @@
 #include <base/kernel/interfaces/IStrategyListener.h>
 #include <base/net/stratum/SubmitResult.h>
 
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 namespace solominer {
@@ -35,6 +40,8 @@ public:
     CMinerThreadedBase() {}
 
 public: ///-- IMiner interface
+    using CMinerBase::GetInfo;
+
     IAPI_IMPL GetInfo( MinerInfo &info ) IOVERRIDE {
         info = m_minerInfo; return IOK;
     }
@@ -146,6 +153,30 @@ public:
         }
         m_cs.Leave();
     }
+
+    virtual bool getTelemetry( xmrig::AppTelemetry &telemetry ) {
+        bool valid = false;
+
+        m_cs.Enter(); if( m_app && m_running )
+        {
+            valid = m_app->getTelemetry( telemetry );
+        }
+        m_cs.Leave();
+
+        return valid;
+    }
+
+    virtual bool setPools( const char *pools ) {
+        bool set = false;
+
+        m_cs.Enter(); if( m_app && m_running )
+        {
+            m_app->setPools( pools ); set = true;
+        }
+        m_cs.Leave();
+
+        return set;
+    }
 };
 
 class CMainXmrig : public Thread {
@@ -165,6 +196,19 @@ static std::string makeOption_( const char *option ,T value ) {
     return ss.str();
 }
 
+String makeMiningHost( const ConnectionInfo &info ) {
+    String host = info.connection.host;
+
+    if( info.connection.port > 0 ) {
+        String port;
+
+        toString( info.connection.port ,port );
+        host += ':'; host += port;
+    }
+
+    return host;
+}
+
 String makeMiningAddress( const String &coin ,const String &miningAddress) {
     const char *devAddress = getDevAddress( coin.c_str() );
 
@@ -177,6 +221,29 @@ String makeMiningAddress( const String &coin ,const String &miningAddress) {
     return s;
 }
 
+//! @brief xmrig algorithm name
+const char *makeMiningAlgorithm( const ConnectionInfo &info ) {
+    switch( getMiningAlgorithm(info) ) {
+        case PowAlgorithm::Argon2: return "argon2/chukwav2";
+        case PowAlgorithm::KawPow: return "kawpow";
+        case PowAlgorithm::RandomWoW: return "rx/wow";
+        case PowAlgorithm::RandomX: return "rx/0";
+        default:
+        case PowAlgorithm::GhostRider: return "ghostrider";
+    }
+}
+
+//! @note [global] miner = { daemon-job-timeout = 2000; }, ms
+int getDaemonJobTimeout() {
+    String s;
+
+    getGlobalSectionValue( getConfig() ,"miner" ,"daemon-job-timeout" ,s ,"2000" );
+
+    int timeout = fromString<int>( s );
+
+    return timeout > 0 ? timeout : 2000;
+}
+
 ///--
 class CMinerXmrig : public CMinerThreadedBase , public xmrig::IStrategyListener {
 public:
@@ -196,32 +263,78 @@ public:
         return wsx;
     }
 
-    void UpdateMiningInfo( xmrig::IStrategy *strategy ) {
+    //! @brief network counts, credited to the connection the miner works for
+    //! @note network state spans reconfigurations, each connection gets the counts made while it was active
+    MiningInfo UpdateMiningInfo( xmrig::IStrategy *strategy ) {
         xmrig::INetworkState *netState = strategy->network()->state();
 
+        CriticalSection::Guard guard(m_creditCs);
+
         if( netState == NullPtr ) {
-            assert(false); return; //! should not happen
+            assert(false); return m_miningInfo; //! should not happen
         }
 
-        m_miningInfo.accepted = (uint32_t) netState->acceptedShare();
-        m_miningInfo.partial = (uint32_t) netState->partialShare();
-        m_miningInfo.rejected = (uint32_t) netState->rejectedShare();
+        m_network.accepted = (uint32_t) netState->acceptedShare();
+        m_network.partial = (uint32_t) netState->partialShare();
+        m_network.rejected = (uint32_t) netState->rejectedShare();
         //TODO stale ?
 
-        m_miningInfo.hashes = (uint64_t) netState->hashes();
+        m_network.hashes = (uint64_t) netState->hashes();
+
+        const MiningInfo &credit = m_credits[ m_connection ];
+
+        m_miningInfo.accepted = credit.accepted + (m_network.accepted - m_base.accepted);
+        m_miningInfo.partial = credit.partial + (m_network.partial - m_base.partial);
+        m_miningInfo.rejected = credit.rejected + (m_network.rejected - m_base.rejected);
+
+        m_miningInfo.hashes = credit.hashes + (m_network.hashes - m_base.hashes);
         m_miningInfo.difficulty = (double) netState->diff();
+
+        return m_miningInfo;
+    }
+
+    IMinerListener *getListener() {
+        CriticalSection::Guard guard(m_creditCs);
+
+        return m_listener;
+    }
+
+    //! @brief counts so far kept for current connection, next connection counts from here
+    void switchCredit( CConnection &connection ) {
+        CriticalSection::Guard guard(m_creditCs);
+
+        m_credits[ m_connection ] = m_miningInfo;
+        m_base = m_network;
+
+        m_connection = &connection;
+        m_listener = connection.minerListener();
+
+        const MiningInfo &credit = m_credits[ m_connection ];
+
+        m_miningInfo.accepted = credit.accepted;
+        m_miningInfo.partial = credit.partial;
+        m_miningInfo.rejected = credit.rejected;
+        m_miningInfo.hashes = credit.hashes;
     }
 
     CAppXmrig m_app;
 
+    CriticalSection m_creditCs;
+
+    MiningInfo m_network; //! last network counts
+    MiningInfo m_base; //! network counts when current connection became active
+    MapOf<CConnection*,MiningInfo> m_credits; //! counts of connections as they were left
+
 public: ///-- xmrig::IClientListener interface
 
     ///-- events
     virtual void onActive( xmrig::IStrategy *strategy ,xmrig::IClient *client ) {
         WorkStateX wsx = SetWorkState( WorkState::stateConnected );
 
-        if( m_listener && wsx.isTransition )
-            m_listener->onStatus( *this ,wsx.state ,wsx.oldState );
+        IMinerListener *listener = getListener();
+
+        if( listener && wsx.isTransition )
+            listener->onStatus( *this ,wsx.state ,wsx.oldState );
     }
 
     virtual void onVerifyAlgorithm( xmrig::IStrategy *strategy ,const xmrig::IClient *client ,const xmrig::Algorithm &algorithm ,bool *ok ) {
@@ -231,43 +344,51 @@ public: ///-- xmrig::IClientListener interface
     virtual void onJob( xmrig::IStrategy *strategy ,xmrig::IClient *client ,const xmrig::Job &job ,const rapidjson::Value &params ) {
         WorkStateX wsx = SetWorkState( WorkState::stateMining );
 
-        if( !m_listener ) return;
+        IMinerListener *listener = getListener();
+
+        if( !listener ) return;
 
         if( wsx.isTransition )
-            m_listener->onStatus( *this ,wsx.state ,wsx.oldState );
+            listener->onStatus( *this ,wsx.state ,wsx.oldState );
 
-        UpdateMiningInfo( strategy );
+        MiningInfo info = UpdateMiningInfo( strategy );
 
-        m_listener->onJob( *this ,this->m_miningInfo );
+        listener->onJob( *this ,info );
     }
 
     virtual void onResultAccepted( xmrig::IStrategy *strategy ,xmrig::IClient *client ,const xmrig::SubmitResult &result ,const char *error ) {
         WorkStateX wsx = SetWorkState( WorkState::stateMining );
 
-        if( !m_listener ) return;
+        IMinerListener *listener = getListener();
+
+        if( !listener ) return;
 
         if( wsx.isTransition )
-            m_listener->onStatus( *this ,wsx.state ,wsx.oldState );
+            listener->onStatus( *this ,wsx.state ,wsx.oldState );
 
-        UpdateMiningInfo( strategy );
+        MiningInfo info = UpdateMiningInfo( strategy );
 
-        m_miningInfo.elapsedMs = (uint32_t) result.elapsed;
+        info.elapsedMs = (uint32_t) result.elapsed;
 
-        m_listener->onResult( *this ,this->m_miningInfo );
+        listener->onResult( *this ,info );
     }
 
     virtual void onLogin( xmrig::IStrategy *strategy ,xmrig::IClient *client ,rapidjson::Document &doc ,rapidjson::Value &params ) {
         WorkStateX wsx = SetWorkState( WorkState::stateConnected );
 
-        if( m_listener && wsx.isTransition )
-            m_listener->onStatus( *this ,wsx.state ,wsx.oldState );
+        IMinerListener *listener = getListener();
+
+        if( listener && wsx.isTransition )
+            listener->onStatus( *this ,wsx.state ,wsx.oldState );
     }
 
     virtual void onPause( xmrig::IStrategy *strategy ) {
         WorkStateX wsx = SetWorkState( WorkState::statePaused );
 
-        if( m_listener && wsx.isTransition )
-            m_listener->onStatus( *this ,wsx.state ,wsx.oldState );
+        IMinerListener *listener = getListener();
+
+        if( listener && wsx.isTransition )
+            listener->onStatus( *this ,wsx.state ,wsx.oldState );
     }
 
 public: //! IMiner interface
@@ -284,13 +405,95 @@ public: //! IMiner interface
         //!-- @note state update here, not in app thread, making sure it's called
         WorkStateX wsx = SetWorkState( WorkState::stateIdle );
 
-        if( m_listener && wsx.isTransition )
-            m_listener->onStatus( *this ,wsx.state ,wsx.oldState );
+        IMinerListener *listener = getListener();
+
+        if( listener && wsx.isTransition )
+            listener->onStatus( *this ,wsx.state ,wsx.oldState );
 
         //--
         return IOK;
     }
 
+    using CMinerThreadedBase::GetInfo;
+
+    IAPI_IMPL GetInfo( MinerTelemetry &info ) IOVERRIDE {
+        xmrig::AppTelemetry telemetry;
+
+        if( !m_app.getTelemetry( telemetry ) )
+            return INODATA;
+
+        info.timestamp = Now();
+        info.backend = telemetry.backend.c_str();
+        info.algorithm = telemetry.algo.c_str();
+
+        for( int i=0; i<MinerTelemetry::intervalCount; ++i ) {
+            info.hps[i] = telemetry.hashrate[i];
+        }
+
+        info.hugePagesAllocated = telemetry.hugePagesAllocated;
+        info.hugePagesTotal = telemetry.hugePagesTotal;
+
+        info.threads.clear();
+
+        for( auto &it : telemetry.threads ) {
+            MinerTelemetry::Thread thread;
+
+            thread.affinity = it.affinity;
+
+            for( int i=0; i<MinerTelemetry::intervalCount; ++i ) {
+                thread.hps[i] = it.hashrate[i];
+            }
+
+            info.threads.emplace_back( thread );
+        }
+
+        info.variants.clear();
+
+        for( auto &it : telemetry.variants ) {
+            MinerTelemetry::Variant variant;
+
+            variant.name = it.name.c_str();
+            variant.hps = it.hashrate;
+            variant.step = it.step;
+            variant.threads = it.threads;
+
+            info.variants.emplace_back( variant );
+        }
+
+        return IOK;
+    }
+
+    //! @note same pool settings as command line from Main
+    IAPI_IMPL Reconfigure( CConnection &connection ) IOVERRIDE {
+        const ConnectionInfo &info = connection.info();
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer( buffer );
+
+        writer.StartArray();
+        writer.StartObject();
+
+        writer.Key( "url" ); writer.String( makeMiningHost(info).c_str() );
+        writer.Key( "user" ); writer.String( info.credential.user.c_str() );
+        writer.Key( "pass" ); writer.String( info.credential.password.c_str() );
+        writer.Key( "coin" ); writer.String( info.mineCoin.coin.c_str() );
+        writer.Key( "algo" ); writer.String( makeMiningAlgorithm(info) );
+        writer.Key( "address" ); writer.String( makeMiningAddress( info.mineCoin.coin ,info.mineCoin.address ).c_str() );
+        writer.Key( "daemon" ); writer.Bool( info.options.isDaemon || info.options.isCore );
+        writer.Key( "daemon-job-timeout" ); writer.Uint( (unsigned) getDaemonJobTimeout() );
+        writer.Key( "tls" ); writer.Bool( info.options.isTls );
+
+        writer.EndObject();
+        writer.EndArray();
+
+        if( !m_app.setPools( buffer.GetString() ) )
+            return IBADENV; //! not running
+
+        switchCredit( connection ); //! @note events and counts now go to connection
+
+        return IOK;
+    }
+
 public: //! CMinerThreadedBase
 
     int AppMain() {
@@ -329,31 +532,26 @@ public: //! CMinerThreadedBase
 
         std::string nThreads = makeOption_( "threads" ,info.status.nThreads );
         std::string coin = makeOption_( "coin" ,info.mineCoin.coin );
+        std::string algo = makeOption_( "algo" ,makeMiningAlgorithm(info) );
+        std::string timeout = makeOption_( "daemon-job-timeout" ,getDaemonJobTimeout() );
         std::string address = makeMiningAddress( info.mineCoin.coin ,info.mineCoin.address );
-        String host = info.connection.host;
-
-        if( info.connection.port > 0 ) {
-            String port;
-
-            toString( info.connection.port ,port );
-            host += ':'; host += port;
-        }
+        String host = makeMiningHost( info );
 
         const char *argv[] = {
             "--asm=ryzen" //TODO topology
             ,nThreads.c_str()
             ,coin.c_str()
-            ,"-a" ,"ghostrider" //TODO algo
+            ,algo.c_str()
             ,"-o" ,host.c_str()
             ,"-u" ,info.credential.user.c_str()
             ,"-p" ,info.credential.password.c_str()
             ,"-d" ,address.c_str() // info.mineCoin.address.c_str()
-            ,"--daemon-job-timeout=2000" //TODO from config
+            ,timeout.c_str()
             ,"" // --core / --daemon
             ,"" // --tls
         };
 
-        int argc = 14;
+        int argc = 13;
 
         if( info.options.isDaemon || info.options.isCore ) { //TODO split daemon/core
             argv[argc++] = "--daemon";
@@ -378,6 +576,32 @@ public: //! CMinerThreadedBase
 
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
+int findSlowThreads( const MinerTelemetry &telemetry ,ListOf<int> &threads ,double ratio ) {
+    const int interval = MinerTelemetry::intervalMedium;
+
+    ListOf<double> hps;
+
+    for( auto &it : telemetry.threads ) if( it.hps[interval] > 0 ) {
+        hps.emplace_back( it.hps[interval] );
+    }
+
+    if( hps.size() < 2 ) return 0;
+
+    std::nth_element( hps.begin() ,hps.begin() + hps.size()/2 ,hps.end() );
+
+    double median = hps[ hps.size()/2 ];
+
+    for( int i=0; i<(int) telemetry.threads.size(); ++i ) {
+        double h = telemetry.threads[i].hps[interval];
+
+        //! @note a thread with no data yet is not judged
+        if( h > 0 && h < median * ratio ) threads.emplace_back( i );
+    }
+
+    return (int) threads.size();
+}
+
+///--
 CMinerBase *makeMiner( CConnection &connection ,IMinerListener *minerListener ,bool configure ) {
     //TODO LATER choose miner for the device/algo/coin
 
@@ -50,6 +50,14 @@ public: ///-- IMiner interface
         return IOK;
     }
 
+    IAPI_IMPL Reconfigure( CConnection &connection ) IOVERRIDE {
+        return INOEXEC;
+    }
+
+    IAPI_IMPL GetInfo( MinerTelemetry &info ) IOVERRIDE {
+        return INOEXEC;
+    }
+
     //! @note required to be implemented by derived class
     /*
     IAPI_IMPL GetInfo( MinerInfo &info ) IOVERRIDE;
@@ -59,6 +67,13 @@ public: ///-- IMiner interface
     */
 };
 
+///--
+#define MINER_SLOWTHREAD_RATIO  .8 //! of median thread hashrate
+
+//! @brief threads hashing below ratio of the median thread (throttled core, misplaced thread...)
+//! @return number of slow threads, their index in telemetry threads
+int findSlowThreads( const MinerTelemetry &telemetry ,ListOf<int> &threads ,double ratio=MINER_SLOWTHREAD_RATIO );
+
 ///--
 CMinerBase *makeMiner( CConnection &connection ,IMinerListener *minerListener ,bool configure=true );
 
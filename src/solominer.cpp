@@ -6,12 +6,18 @@
 #include <common/console.h>
 #include <common/logging.h>
 #include <common/option.h>
+#include <common/http-fixture.h>
+#include <common/http-json.h>
+#include <common/notify.h>
 
 #include <algo/crypth.h>
 #include <markets/markets.h>
 #include <markets/trader.h>
 #include <markets/broker.h>
 #include <wallets/wallets.h>
+#include <chains/chains.h>
+#include <chains/history.h>
+#include "backtest.h"
 #include <pools/pools.h>
 #include <coins/cores.h>
 #include <gui/gui.h>
@@ -102,6 +108,11 @@ bool processArguments( int argc ,char *argv[] ) {
                     ,(option( "-t" ,"--threads" ) & value( "threads" ,g_optThreads )) % "select number of threads, 0=auto"
                     ,(option( "-l" ,"--logfile" ) & value( "logfile" ,g_optLogFile )) % "log file name, default = 'solominer.log'"
                     ,(option( "-c" ,"--config" ) & value( "configFile" ,g_optConfigFile )) % "configuration file name, default = 'solominer.conf'"
+                    ,(option( "--http-record" ) & value( "fixtureFile" ,g_optHttpRecord )) % "record http exchanges to fixture file"
+                    ,(option( "--http-replay" ) & value( "fixtureFile" ,g_optHttpReplay )) % "replay http exchanges from fixture file instead of network"
+                    ,(option( "--http-fixture" ) & value( "fixture" ,g_optHttpFixture )) % "replay behavior, IE 'latency=200; jitter=100; errors=5; timeouts=1; limit=10; interval=60;'"
+                    ,(option( "--bench-json" ) & value( "payloadFile" ,g_optBenchJson ) & opt_value( "iterations" ,g_optBenchIterations )) % "decode a json array of objects as document and as stream, report time and memory then exit"
+                    ,option( "--self-test" ).set( g_optSelfTest ) % "run self checks of books and estimators then exit"
             // ,( option("--log") & value("log", g_optLogSeverity )) % "log severity (verbose,debug...)"
     );
 
@@ -275,6 +286,7 @@ bool initConnections( Config &config ) {
 
 void cleanupConnections() {
     g_connections.saveConfig();
+    g_connections.Close();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -494,6 +506,10 @@ void mainAppLoop() {
 
         //TODO -> if option set, have a terminal command interface ?
 
+        getNotifyListener().Dispatch();
+        getCoreProbe().Dispatch();
+        getWalletSyncer().Dispatch();
+
         getConnectionList().updateConnections();
 
         if( now - t0 > 1 ) {
@@ -511,10 +527,12 @@ void mainAppLoop() {
 
 // #include "test-graph.hpp"
 #include "test-trade.hpp"
+#include "test-checks.hpp"
 
 #define ERROR_OK            0
 #define ERROR_ARGS          -1
 #define ERROR_CONFIG        -2
+#define ERROR_CHECKS        -3
 
 /**
  * @brief
@@ -530,6 +548,84 @@ int main( int argc ,char *argv[] ) {
 
     OsTimerGetResolution();
 
+///-- notifier, IE run from a core daemon hook
+    if( argc >= 3 && strcmp( argv[1] ,"--notify" ) == 0 ) {
+        String message;
+
+        for( int i=3; i<argc; ++i ) {
+            if( i > 3 ) message += ' ';
+            message += argv[i];
+        }
+
+        return ISUCCESS( CNotifyListener::Send( argv[2] ,message.c_str() ) ) ? ERROR_OK : ERROR_ARGS;
+    }
+
+///-- backtest, replay recorded chain history : --backtest <days> <hps> <watts> <COIN> <COIN> ...
+    //! @note coins mine at the measured hashrate of their algorithm, <hps> for algorithms not measured yet
+    if( argc >= 7 && strcmp( argv[1] ,"--backtest" ) == 0 ) {
+        BacktestConfig config;
+
+        double days = 0; fromString( days ,String(argv[2]) );
+
+        fromString( config.hostHps ,String(argv[3]) );
+        fromString( config.watts ,String(argv[4]) );
+
+        for( int i=5; i<argc; ++i ) {
+            String ticker = argv[i]; toupper( ticker );
+
+            config.coins.emplace_back( ticker );
+
+            CCoinRef coin;
+
+            if( CCoinStore::getInstance().findCoinByTicker( ticker.c_str() ,coin ) && coin && g_connections.hasHostHps( coin->getAlgorithm() ) )
+                config.algorithmHps[ coin->getAlgorithm() ] = g_connections.getHostHps( coin->getAlgorithm() );
+        }
+
+        config.to = time(NullPtr);
+        config.from = config.to - (time_t) (days * 86400);
+
+        ListOf<BacktestResult> results;
+
+        if( IFAILED( runBacktest( config ,results ) ) ) {
+            std::cout << "Not enough recorded history for backtest\n";
+            return ERROR_ARGS;
+        }
+
+        for( auto &it : results ) {
+            std::cout << getBacktestStrategyName( it.strategy )
+                << " : " << it.earning << " usd ," << it.energy << " kWh ," << it.earningPerKwh << " usd/kWh ,"
+                << it.switches << " switches\n";
+        }
+
+        return ERROR_OK;
+    }
+
+///-- prepare arguments
+    if( !processArguments( argc ,argv ) ) {
+        return ERROR_ARGS;
+    }
+
+///-- json decode benchmark, document vs stream
+    if( !getOptBenchJson().empty() ) {
+        JsonBenchResult result;
+
+        if( IFAILED( benchJsonDecodeFile( getOptBenchJson().c_str() ,getOptBenchIterations() ,result ) ) ) {
+            std::cout << "Payload must be a json array of objects\n";
+            return ERROR_ARGS;
+        }
+
+        std::cout << result.size << " bytes ," << result.items << " items\n"
+            << "document : " << result.domMs << " ms ," << result.domHeld << " bytes held\n"
+            << "stream : " << result.streamMs << " ms ," << result.streamHeld << " bytes held\n";
+
+        return ERROR_OK;
+    }
+
+///-- checks, IE after changing books or estimators
+    if( getOptSelfTest() ) {
+        return test::runChecks() ? ERROR_OK : ERROR_CHECKS;
+    }
+
     //////////////////////////////////////////////////////////////////////////////
     //! TEST
 
@@ -548,11 +644,6 @@ int main( int argc ,char *argv[] ) {
     //////////////////////////////////////////////////////////////////////////////
     //! prepare
 
-///-- prepare arguments
-    if( !processArguments( argc ,argv ) ) {
-        return ERROR_ARGS;
-    }
-
 ///-- prepare logging
     static plog::ColorConsoleAppender<plog::MinerConsoleFormatter> consoleAppender;
 
@@ -560,6 +651,29 @@ int main( int argc ,char *argv[] ) {
     plog::init(plog::Severity::verbose, &consoleAppender); //! initialize console logger
 
     PLOGI << LogCategory::net << "Starting network interface";
+
+///-- http fixture
+    if( !getOptHttpReplay().empty() ) {
+        HttpFixtureConfig fixtureConfig;
+
+        fromManifestWithString( fixtureConfig ,getOptHttpFixture().c_str() );
+
+        if( ISUCCESS( getHttpFixture().Replay( getOptHttpReplay().c_str() ,fixtureConfig ) ) )
+            PLOGI << LogCategory::net << "Replaying http from '" << getOptHttpReplay() << "'";
+        else
+            PLOG_ERROR << LogCategory::net << "Http fixture file '" << getOptHttpReplay() << "' not found";
+    }
+    else if( !getOptHttpRecord().empty() ) {
+        if( ISUCCESS( getHttpFixture().Record( getOptHttpRecord().c_str() ) ) )
+            PLOGI << LogCategory::net << "Recording http to '" << getOptHttpRecord() << "'";
+    }
+
+///-- core daemons notifications
+    if( ISUCCESS( getNotifyListener().Open( NOTIFY_SOCKET_DEFAULT ) ) )
+        PLOGI << LogCategory::net << "Listening to core notifications on '" << getNotifyListener().path() << "'";
+    else
+        PLOG_ERROR << LogCategory::net << "Could not open core notification socket, wallets will be polled";
+
     PLOGI << LogCategory::PoW << "Starting miner threads";
 
     //////////////////////////////////////////////////////////////////////////////
@@ -646,8 +760,16 @@ int main( int argc ,char *argv[] ) {
 
     PLOGD << "done, cleaning up";
 
+    getProfitEngine().Shutdown();
+    getChainRefresher().Shutdown(); //! @note before chain services are stopped
+    getChainHistory().Close();
+    getWalletSyncer().Shutdown(); //! @note may be syncing a wallet, before wallets are released
+
     cleanupConnections();
 
+    getCoreProbe().Shutdown();
+    getNotifyListener().Close();
+
     return ERROR_OK;
 }
 
@@ -0,0 +1,373 @@
+#pragma once
+
+// Copyright (c) 2023-2024 The solominer developers
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+//////////////////////////////////////////////////////////////////////////////
+#ifndef SOLOMINER_TEST_CHECKS_HPP
+#define SOLOMINER_TEST_CHECKS_HPP
+
+//////////////////////////////////////////////////////////////////////////////
+#include <common/book.h>
+#include <common/estimator.h>
+
+#include <cmath>
+
+#include <fstream>
+#include <iostream>
+
+//////////////////////////////////////////////////////////////////////////////
+namespace solominer {
+
+//////////////////////////////////////////////////////////////////////////////
+//! CheckEntry
+
+#define CHECKENTRY_PUID     0x07c3e1a2b4d5f6081
+
+//! @brief book entry for checks, text spills beyond entry size when long enough
+struct CheckEntry : BookEntry {
+    DECLARE_CLASSID(CHECKENTRY_PUID)
+
+    static size_t sizeofEntry() { return 64; }
+
+    int value;
+    String text;
+};
+
+inline bool fromString( CheckEntry &p ,const String &s ) {
+    size_t at = s.find( ',' );
+
+    p.value = atoi( s.c_str() );
+    p.text = at != String::npos ? s.substr( at+1 ) : "";
+
+    return true;
+}
+
+inline String &toString( const CheckEntry &p ,String &s ) {
+    toString( p.value ,s ); s += ','; s += p.text;
+
+    return s;
+}
+
+template <>
+inline CheckEntry &Zero( CheckEntry &p ) {
+    p.value = 0; p.text.clear(); return p;
+}
+
+template <>
+inline bool fromBinary( CheckEntry &p ,BinaryReader &r ) {
+    uint64_t value ,size;
+
+    if( r.ReadVarint( value ) && r.ReadVarint( size ) ) {} else return false;
+
+    p.value = (int) value; p.text.resize( (size_t) size );
+
+    return size == 0 || r.Read( &p.text[0] ,(size_t) size );
+}
+
+template <>
+inline void toBinary( const CheckEntry &p ,BinaryWriter &w ) {
+    w.WriteVarint( (uint64_t) p.value ); w.WriteVarint( p.text.size() ); w.Write( p.text.data() ,p.text.size() );
+}
+
+//////////////////////////////////////////////////////////////////////////////
+namespace test {
+
+//! @brief report a failed check, IE "checkBookWal failed : book.getEntryCount() == 40"
+#define TEST_CHECK(__x) \
+    if( __x ) {} else { std::cout << __FUNCTION__ << " failed : " << #__x << "\n"; return false; }
+
+//! @brief book of check entries, closed on scope exit
+class CCheckBook : public CBookFile_<CheckEntry> {
+public:
+    CCheckBook( BookMode mode=bookBinary ) : CBookFile_<CheckEntry>( CheckEntry::sizeofEntry() ,mode ,4 ) {}
+
+    ~CCheckBook() {
+        Close();
+    }
+};
+
+inline bool readFile( const char *filename ,String &data ) {
+    std::ifstream in( filename ,std::ios::binary ); if( !in ) return false;
+
+    data.assign( std::istreambuf_iterator<char>(in) ,std::istreambuf_iterator<char>() );
+
+    return true;
+}
+
+inline bool writeFile( const char *filename ,const String &data ) {
+    std::ofstream out( filename ,std::ios::binary | std::ios::trunc );
+
+    return (bool) out.write( data.data() ,data.size() );
+}
+
+//! @brief files of an open book, as a crash would leave them
+struct BookCrash {
+    String book ,wal;
+
+    bool Take( const char *title ) {
+        String filepath = title; filepath += ".book";
+
+        return readFile( filepath.c_str() ,book ) && readFile( (filepath + ".wal").c_str() ,wal );
+    }
+
+    bool Restore( const char *title ) const {
+        String filepath = title; filepath += ".book";
+
+        return writeFile( filepath.c_str() ,book ) && writeFile( (filepath + ".wal").c_str() ,wal );
+    }
+};
+
+inline void deleteBook( const char *title ) {
+    String filepath = title; filepath += ".book";
+
+    OsFileDelete( filepath.c_str() );
+    OsFileDelete( (filepath + ".wal").c_str() );
+    OsFileDelete( (filepath + ".new").c_str() );
+    OsFileDelete( (filepath + ".bak").c_str() );
+}
+
+inline bool checkEntries( CCheckBook &book ,int from ,int until ) {
+    CheckEntry entry;
+
+    for( int i=from; i<until; ++i ) {
+        if( book.getEntry( (BookEntry::Id) i ,entry ) && entry.value == i ) {} else return false;
+    }
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! book wal
+
+//! @brief durable groups are replayed after a crash, a group not yet in the wal is lost whole
+//! @note a crash restores book files as they were taken while the book was open
+inline bool checkBookWal() {
+    BookCrash replayed ,lost;
+
+    deleteBook( "check-wal" );
+
+    {
+        CCheckBook book; TEST_CHECK( ISUCCESS( book.Open( "check-wal" ) ) );
+
+        book.setCommitWindow( 3600*1000 ); //! @note groups only end on forced syncs
+
+        CheckEntry entry;
+
+        for( int i=0; i<10; ++i ) { entry.value = i; book.addEntry( entry ); }
+
+        TEST_CHECK( book.Sync( true ) );
+
+        for( int i=10; i<40; ++i ) { entry.value = i; book.addEntry( entry ); }
+
+        TEST_CHECK( book.getEntryCount() == 40 && checkEntries( book ,0 ,40 ) );
+
+        //! book taken before the group of 30 reached its pages, wal once the group is durable
+        TEST_CHECK( readFile( "check-wal.book" ,replayed.book ) );
+        TEST_CHECK( book.Sync( true ) );
+        TEST_CHECK( readFile( "check-wal.book.wal" ,replayed.wal ) );
+
+        //! group of 10 never reached the wal
+        for( int i=40; i<50; ++i ) { entry.value = i; book.addEntry( entry ); }
+
+        TEST_CHECK( lost.Take( "check-wal" ) );
+    }
+
+    {
+        TEST_CHECK( replayed.Restore( "check-wal" ) );
+
+        CCheckBook book; TEST_CHECK( ISUCCESS( book.Open( "check-wal" ,"" ,false ) ) );
+
+        TEST_CHECK( book.getEntryCount() == 40 && checkEntries( book ,0 ,40 ) );
+    }
+
+    {
+        TEST_CHECK( lost.Restore( "check-wal" ) );
+
+        CCheckBook book; TEST_CHECK( ISUCCESS( book.Open( "check-wal" ,"" ,false ) ) );
+
+        TEST_CHECK( book.getEntryCount() == 40 && checkEntries( book ,0 ,40 ) );
+
+        CheckEntry entry; entry.value = 40; //! @note book goes on after the lost group
+
+        TEST_CHECK( book.addEntry( entry ) == 40 && book.Sync( true ) );
+    }
+
+    {
+        CCheckBook book; TEST_CHECK( ISUCCESS( book.Open( "check-wal" ,"" ,false ) ) );
+
+        TEST_CHECK( book.getEntryCount() == 41 && checkEntries( book ,0 ,41 ) );
+    }
+
+    deleteBook( "check-wal" );
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! book convert
+
+inline String checkText( int i ) {
+    return String( (size_t) (i % 7) ,'x' );
+}
+
+inline bool checkTexts( CCheckBook &book ,int from ,int until ) {
+    CheckEntry entry;
+
+    for( int i=from; i<until; ++i ) {
+        if( book.getEntry( (BookEntry::Id) i ,entry ) && entry.value == i && entry.text == checkText(i) ) {} else return false;
+    }
+
+    return true;
+}
+
+//! @brief text book upgraded to binary, entries too large for their size spill the book to a larger size
+inline bool checkBookConvert() {
+    deleteBook( "check-convert" );
+
+    CheckEntry entry;
+
+    {
+        CCheckBook book( bookText ); TEST_CHECK( ISUCCESS( book.Open( "check-convert" ) ) );
+
+        for( int i=0; i<50; ++i ) { entry.value = i; entry.text = checkText(i); book.addEntry( entry ); }
+
+        //! text spill
+        entry.value = 50; entry.text = String( 200 ,'t' );
+
+        TEST_CHECK( book.addEntry( entry ) == 50 && book.sizeofEntry() > CheckEntry::sizeofEntry() );
+        TEST_CHECK( checkTexts( book ,0 ,50 ) );
+    }
+
+    {
+        CCheckBook book( bookBinary ); TEST_CHECK( ISUCCESS( book.Open( "check-convert" ,"" ,false ) ) );
+
+        TEST_CHECK( book.bookmode() == bookText );
+        TEST_CHECK( ISUCCESS( book.Upgrade() ) && book.bookmode() == bookBinary && book.getEntryCount() == 51 );
+        TEST_CHECK( checkTexts( book ,0 ,50 ) );
+        TEST_CHECK( book.getEntry( 50 ,entry ) && entry.text.size() == 200 );
+
+        //! binary spill, on add and on update
+        size_t size = book.sizeofEntry();
+
+        entry.value = 51; entry.text = String( 2*size ,'b' );
+
+        TEST_CHECK( book.addEntry( entry ) == 51 && book.sizeofEntry() > size );
+
+        size = book.sizeofEntry();
+
+        entry.value = 3; entry.text = String( 2*size ,'u' );
+
+        TEST_CHECK( book.updateEntry( 3 ,entry ) && book.sizeofEntry() > size );
+        TEST_CHECK( checkTexts( book ,0 ,3 ) && checkTexts( book ,4 ,50 ) );
+    }
+
+    {
+        CCheckBook book( bookBinary ); TEST_CHECK( ISUCCESS( book.Open( "check-convert" ,"" ,false ) ) );
+
+        TEST_CHECK( book.bookmode() == bookBinary && book.getEntryCount() == 52 );
+        TEST_CHECK( checkTexts( book ,0 ,3 ) && checkTexts( book ,4 ,50 ) );
+        TEST_CHECK( book.getEntry( 3 ,entry ) && entry.text == String( entry.text.size() ,'u' ) && !entry.text.empty() );
+        TEST_CHECK( book.getEntry( 51 ,entry ) && entry.text == String( entry.text.size() ,'b' ) && !entry.text.empty() );
+    }
+
+    deleteBook( "check-convert" );
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! estimator
+
+inline bool isNear( double a ,double b ,double tolerance=1e-6 ) {
+    return fabs( a - b ) <= tolerance * MAX( fabs(b) ,1. );
+}
+
+//! @brief decayed mean and variance, confidence bounds, outliers and persistence of the hashrate estimator
+inline bool checkEstimator() {
+    time_t t = 1000;
+
+///-- no decay, plain mean and population variance
+    {
+        EwmaEstimator e; e.halfLife = 1e12;
+
+        for( int i=1; i<=4; ++i ) TEST_CHECK( e.Add( (double) i ,t++ ) );
+
+        TEST_CHECK( isNear( e.getMean() ,2.5 ) && isNear( e.getDeviation() ,sqrt(1.25) ) );
+        TEST_CHECK( isNear( e.getSampleCount() ,4. ) );
+
+        double margin = ESTIMATOR_CONFIDENCE_Z * sqrt(1.25) / 2.;
+
+        TEST_CHECK( isNear( e.getLower() ,2.5 - margin ) && isNear( e.getUpper() ,2.5 + margin ) );
+    }
+
+///-- a sample one half life old weighs half
+    {
+        EwmaEstimator e; e.halfLife = 10;
+
+        e.Add( 100. ,t ); e.Add( 200. ,t+10 );
+
+        TEST_CHECK( isNear( e.getMean() ,100. + 100. * 2/3 ) );
+        TEST_CHECK( isNear( e.getSampleCount() ,1.5 * 1.5 / 1.25 ) );
+    }
+
+///-- outliers rejected once warmed up, a persistent change restarts the estimate
+    {
+        EwmaEstimator e; e.halfLife = 600;
+
+        for( int i=0; i<10; ++i ) TEST_CHECK( e.Add( i % 2 ? 1010. : 990. ,t++ ) );
+
+        double mean = e.getMean();
+
+        for( int i=0; i<ESTIMATOR_MAXREJECT; ++i ) TEST_CHECK( !e.Add( 5000. ,t++ ) && e.getMean() == mean );
+
+        TEST_CHECK( e.Add( 5000. ,t++ ) && isNear( e.getMean() ,5000. ) );
+
+    //-- cold estimate takes any sample
+        t += (time_t) (e.halfLife * 5);
+
+        TEST_CHECK( e.Add( 1000. ,t++ ) );
+    }
+
+///-- persisted estimate, restored warmed up
+    {
+        EwmaEstimator e ,restored; e.halfLife = 600;
+
+        for( int i=0; i<10; ++i ) e.Add( i % 2 ? 1010. : 990. ,t++ );
+
+        String s; toString( e ,s );
+
+        TEST_CHECK( fromString( restored ,s.c_str() ) );
+        TEST_CHECK( isNear( restored.getMean() ,e.getMean() ,1e-4 ) && isNear( restored.getSampleCount() ,e.getSampleCount() ,1e-4 ) );
+        TEST_CHECK( !restored.Add( 5000. ,t ) );
+        TEST_CHECK( !fromString( restored ,"1000:-1:1:1:0" ) && !fromString( restored ,"garbage" ) );
+    }
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//! checks
+
+//! @brief run all checks, reporting failed ones
+inline bool runChecks() {
+    bool ok = true;
+
+    ok = checkBookWal() && ok;
+    ok = checkBookConvert() && ok;
+    ok = checkEstimator() && ok;
+
+    std::cout << (ok ? "checks passed\n" : "checks failed\n");
+
+    return ok;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace test
+
+//////////////////////////////////////////////////////////////////////////////
+} //namespace solominer
+
+//////////////////////////////////////////////////////////////////////////////
+#endif //SOLOMINER_TEST_CHECKS_HPP
@@ -54,6 +54,34 @@ String &getMember( const WalletTransaction &p ,int m ,String &s ) {
     }
 }
 
+DEFINE_SETMEMBER_BINARY(WalletTransaction) {
+    switch( m ) {
+        case 0: fromBinary( p.txid ,r ); return;
+        case 1: fromBinary( p.amount ,r ); return;
+        case 2: fromBinary( p.fromAddress ,r ); return;
+        case 3: fromBinary( p.toAddress ,r ); return;
+        case 4: fromBinary( p.comment ,r ); return;
+        case 5: fromBinary( p.communication ,r ); return;
+        case 6: fromBinary( p.receivedAt ,r ); return;
+        case 7: fromBinary( p.confirmations ,r ); return;
+        default: break;
+    }
+}
+
+DEFINE_GETMEMBER_BINARY(WalletTransaction) {
+    switch( m ) {
+        case 0: toBinary( p.txid ,w ); return;
+        case 1: toBinary( p.amount ,w ); return;
+        case 2: toBinary( p.fromAddress ,w ); return;
+        case 3: toBinary( p.toAddress ,w ); return;
+        case 4: toBinary( p.comment ,w ); return;
+        case 5: toBinary( p.communication ,w ); return;
+        case 6: toBinary( p.receivedAt ,w ); return;
+        case 7: toBinary( p.confirmations ,w ); return;
+        default: break;
+    }
+}
+
 template <> WalletTransaction &Zero( WalletTransaction &p ) {
     p.txid = "";
 
@@ -290,6 +318,98 @@ void makeAddressList( GuiComboBox &combo ,const char *ticker ) {
     }
 }
 
+//////////////////////////////////////////////////////////////////////////////
+//! CWalletSyncer
+
+void CWalletSyncer::Request( CWalletService &wallet ) {
+    CriticalSection::Guard guard(m_cs);
+
+    for( auto &it : m_pending ) {
+        if( it == wallet ) return;
+    }
+
+    m_pending.emplace_back( wallet );
+
+    if( !m_running ) {
+        m_quit = false;
+        m_running = Thread::Start() == ENOERROR;
+    }
+}
+
+void CWalletSyncer::Cancel( CWalletService &wallet ) {
+    CriticalSection::Guard guard(m_cs);
+
+    for( auto it=m_pending.begin(); it!=m_pending.end(); ++it ) {
+        if( *it == wallet ) { m_pending.erase(it); break; }
+    }
+
+    for( auto it=m_synced.begin(); it!=m_synced.end(); ++it ) {
+        if( *it == wallet ) { m_synced.erase(it); break; }
+    }
+}
+
+int CWalletSyncer::Dispatch() {
+    ListOf<CWalletServiceRef> synced;
+
+    { CriticalSection::Guard guard(m_cs);
+
+        synced.swap( m_synced );
+    }
+
+    for( auto &wallet : synced ) {
+        wallet->adviseSynced();
+    }
+
+    return (int) synced.size();
+}
+
+void CWalletSyncer::Shutdown() {
+    if( !m_running ) return;
+
+    m_quit = true;
+
+    WaitFor();
+
+    m_running = false;
+
+    CriticalSection::Guard guard(m_cs);
+
+    m_pending.clear();
+    m_synced.clear();
+}
+
+OsError CWalletSyncer::Main() {
+    while( !m_quit ) {
+        CWalletServiceRef wallet;
+
+        { CriticalSection::Guard guard(m_cs);
+
+            if( !m_pending.empty() ) {
+                wallet = m_pending.front();
+                m_pending.erase( m_pending.begin() );
+            }
+        }
+
+        if( !wallet ) {
+            OsSleep( WALLET_SYNC_TICK ); continue;
+        }
+
+        if( ISUCCESS( wallet->Sync() ) ) {
+            CriticalSection::Guard guard(m_cs);
+
+            bool listed = false;
+
+            for( auto &it : m_synced ) {
+                if( it == wallet ) { listed = true; break; }
+            }
+
+            if( !listed ) m_synced.emplace_back( wallet );
+        }
+    }
+
+    return ENOERROR;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 } //namespace solominer
 
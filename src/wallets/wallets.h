@@ -14,6 +14,8 @@
 
 #include <interface/IWallet.h>
 
+#include <atomic>
+
 //////////////////////////////////////////////////////////////////////////////
 namespace solominer {
 
@@ -33,6 +35,9 @@ class CWalletStore;
 DEFINE_MEMBER_API(WalletTransaction);
 DEFINE_WITHSCHEMA_API(WalletTransaction);
 
+DEFINE_MEMBER_BINARY_API(WalletTransaction);
+DEFINE_WITHBINARY_API(WalletTransaction);
+
 template <> WalletTransaction &Zero( WalletTransaction &p );
 
 //////////////////////////////////////////////////////////////////////////////
@@ -55,6 +60,43 @@ public:
     }
 };
 
+//////////////////////////////////////////////////////////////////////////////
+//! Wallet cache
+
+/**
+ * @brief wallet balance as of last refresh, read lock-free (IE from UI)
+ * @note invalidated by wallet events (new transaction, new block) or on max age
+ */
+
+struct WalletBalanceCache {
+    std::atomic<double> amount = {0.};
+    std::atomic<time_t> time = {0}; //! of last refresh, 0 if never refreshed
+    std::atomic<bool> stale = {false}; //! invalidated since last refresh
+
+    //! @return true if value is fresh, value is last known in any case
+    bool get( double &value ,time_t maxAge ) const {
+        time_t t = time.load( std::memory_order_acquire );
+
+        value = amount.load( std::memory_order_relaxed );
+
+        return t != 0 && !stale.load( std::memory_order_relaxed ) && t + maxAge > ::time(NullPtr);
+    }
+
+    bool known() const {
+        return time.load( std::memory_order_acquire ) != 0;
+    }
+
+    void set( double value ) {
+        amount.store( value ,std::memory_order_relaxed );
+        stale.store( false ,std::memory_order_relaxed );
+        time.store( ::time(NullPtr) ,std::memory_order_release );
+    }
+
+    void invalidate() {
+        stale.store( true ,std::memory_order_release );
+    }
+};
+
 //////////////////////////////////////////////////////////////////////////////
 //! IWallet Service
 
@@ -114,12 +156,71 @@ public: ///-- addresses
 
     IAPI_IMPL verifyMessage( const char *address ,const String &message ,const String &signature ) IOVERRIDE { return INOEXEC; }
 
+public: ///-- CWalletService
+    //! @brief query wallet source for its current state (balance, incoming transactions)
+    //! @note called from wallet sync thread, state is kept until published
+    IAPI_DECL Sync() { return INOEXEC; }
+
+    //! @brief publish state from last sync, IE post incoming transactions
+    //! @note called from main thread
+    API_DECL(void) adviseSynced() {}
+
 protected:
     bool m_unlocked;
 };
 
 typedef RefOf<CWalletService> CWalletServiceRef;
 
+//////////////////////////////////////////////////////////////////////////////
+//! Wallet sync
+
+#define WALLET_SYNC_TICK    100 //! ms, sync thread poll when idle
+
+/**
+ * @brief background thread syncing wallets on request
+ * @note wallet events are dispatched on main thread, source is queried from here instead
+ * @note synced state is published back on main thread, from Dispatch
+ */
+
+class CWalletSyncer : public Singleton_<CWalletSyncer> ,protected Thread {
+protected:
+    CriticalSection m_cs;
+
+    ListOf<CWalletServiceRef> m_pending; //! wallets to sync, in request order, once each
+    ListOf<CWalletServiceRef> m_synced; //! wallets synced, to publish
+
+    volatile bool m_running;
+    volatile bool m_quit;
+
+public:
+    CWalletSyncer() : m_running(false) ,m_quit(false)
+    {}
+
+    ~CWalletSyncer() {
+        Shutdown();
+    }
+
+public:
+    //! @brief sync wallet as soon as possible, no effect if already pending
+    void Request( CWalletService &wallet );
+
+    //! @brief drop pending sync, IE wallet stopping
+    void Cancel( CWalletService &wallet );
+
+    //! @brief publish wallets synced, from main thread
+    //! @return number of wallets published
+    int Dispatch();
+
+    void Shutdown();
+
+protected:
+    OsError Main() override;
+};
+
+inline CWalletSyncer &getWalletSyncer() {
+    return CWalletSyncer::getInstance();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //! IWallet Setup
 